@@ -0,0 +1,163 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pbbam/BamHeader.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/Cigar.h>
+#include <pbbam/FastaSequence.h>
+
+#include <pacbio/align/SimdAlignment.h>
+
+namespace PacBio {
+namespace Align {
+
+/// Parameters of the read-to-reference aligner. Scores follow the
+/// blasr score matrix previously used by julietflow.
+struct ReadAlignerConfig
+{
+    int KmerSize = 15;
+    int WindowSize = 5;
+    int MaxOccurrences = 500;
+    int MinSeeds = 3;
+    int BandWidth = 100;
+    uint8_t MatchScore = 1;
+    uint8_t MismatchPenalty = 4;
+    uint8_t GapOpenPenalty = 5;
+    uint8_t GapExtendPenalty = 1;
+};
+
+/// (k,w)-minimizer index over the forward strand of all references.
+class MinimizerIndex
+{
+public:
+    struct Hit
+    {
+        int32_t ReferenceId;
+        int32_t Position;
+    };
+
+public:
+    /// Sequences are expected in upper case.
+    MinimizerIndex(const std::vector<std::string>& sequences, int kmerSize, int windowSize,
+                   int maxOccurrences);
+
+public:
+    /// Returns all reference positions of hash, nullptr if unknown or masked.
+    const std::vector<Hit>* Find(uint64_t hash) const;
+
+    int KmerSize() const { return kmerSize_; }
+    int WindowSize() const { return windowSize_; }
+
+private:
+    const int kmerSize_;
+    const int windowSize_;
+    std::unordered_map<uint64_t, std::vector<Hit>> hits_;
+};
+
+/// Result of mapping a single read. The cigar is in reference orientation.
+struct ReadAlignment
+{
+    int32_t ReferenceId = -1;
+    int32_t ReferenceStart = 0;
+    bool Reverse = false;
+    uint8_t MappingQuality = 0;
+    BAM::Cigar Cigar;
+};
+
+/// Maps reads with minimizer seeding and aligns them with the SIMD
+/// aligner restricted to a band around the best seed diagonal.
+/// Gaps are left-aligned, as blasr's --placeGapConsistently does.
+class ReadAligner
+{
+public:
+    ReadAligner(const std::vector<BAM::FastaSequence>& references,
+                const ReadAlignerConfig& config = ReadAlignerConfig());
+
+public:
+    /// Maps a single read, aligner is the per-thread SIMD aligner.
+    /// Returns false if the read could not be placed.
+    bool Map(const std::string& read, Aligner* aligner, ReadAlignment* result) const;
+
+    /// Maps all unaligned records on the shared thread pool. Returns the
+    /// mapped records sorted by reference id and position; unmapped reads
+    /// are dropped.
+    std::vector<BAM::BamRecord> Map(const std::vector<BAM::BamRecord>& records) const;
+
+    const std::vector<BAM::FastaSequence>& References() const { return references_; }
+
+private:
+    struct Candidate
+    {
+        int32_t ReferenceId = -1;
+        bool Reverse = false;
+        int32_t DiagonalBegin = 0;
+        int32_t DiagonalEnd = 0;
+        int Seeds = 0;
+    };
+
+    /// Finds the two densest, non-overlapping seed diagonal bands over both strands.
+    void FindCandidates(const std::string& forward, const std::string& reverse, Candidate* best,
+                        Candidate* second) const;
+
+private:
+    const ReadAlignerConfig config_;
+    std::vector<BAM::FastaSequence> references_;
+    std::vector<std::string> sequences_;
+    MinimizerIndex index_;
+};
+
+/// Shifts every gap of gapped as far left as possible without changing the
+/// alignment score, restricted to columns (begin, end). other is the
+/// opposing row of the pairwise alignment.
+void LeftAlignGaps(std::string* gapped, const std::string& other, size_t begin, size_t end);
+
+/// Reads all sequences of a FASTA file or ReferenceSet.
+std::vector<BAM::FastaSequence> ReadReferences(const std::string& referenceFile);
+
+/// Merges the headers of all BAM files of inputFile and replaces its
+/// sequence dictionary by references, sorted by coordinate.
+BAM::BamHeader AlignedHeader(const std::string& inputFile,
+                             const std::vector<BAM::FastaSequence>& references);
+}
+}  // ::PacBio::Align
@@ -37,7 +37,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
+
+#include <boost/utility/string_ref.hpp>
+
+struct _profile;
 
 namespace PacBio {
 namespace Align {
@@ -49,7 +55,49 @@ struct PariwiseAlignmentFasta
     std::string Transcript;
 };
 
+/// Striped Smith-Waterman aligner that keeps its scoring matrix, the
+/// translated query and the query profile across calls. Gapped output is
+/// identical to SimdNeedleWunschAlignment, the full target is reported.
+///
+/// An Aligner is not thread-safe; use one instance per thread.
+class Aligner
+{
+public:
+    Aligner(uint8_t matchScore = 2, uint8_t mismatchPenalty = 2, uint8_t gapOpenPenalty = 3,
+            uint8_t gapExtendPenalty = 1);
+    ~Aligner();
+
+    Aligner(const Aligner&) = delete;
+    Aligner& operator=(const Aligner&) = delete;
+
+public:
+    /// Sets the query, the query profile is only rebuilt if the query changed.
+    void Query(boost::string_ref query);
+
+    /// Aligns target against the current query. Buffers of result are reused.
+    void Align(boost::string_ref target, PariwiseAlignmentFasta* result);
+    /// Sets the query and aligns target against it.
+    void Align(boost::string_ref target, boost::string_ref query, PariwiseAlignmentFasta* result);
+
+private:
+    void Translate(boost::string_ref seq, std::vector<int8_t>* translated) const;
+
+private:
+    const uint8_t gapOpenPenalty_;
+    const uint8_t gapExtendPenalty_;
+    std::vector<int8_t> scoreMatrix_;
+    std::string query_;
+    std::vector<int8_t> translatedQuery_;
+    std::vector<int8_t> translatedTarget_;
+    struct _profile* profile_ = nullptr;
+};
+
 PariwiseAlignmentFasta SimdNeedleWunschAlignment(const std::string& target,
                                                  const std::string& query);
+
+/// Aligns one target against many queries on the shared thread pool.
+/// results is resized to the number of queries, results[i] belongs to queries[i].
+void SimdNeedleWunschAlignment(boost::string_ref target, const std::vector<std::string>& queries,
+                               std::vector<PariwiseAlignmentFasta>* results);
 }  // namespace Align
 }  // namespace PacBio
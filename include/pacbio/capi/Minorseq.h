@@ -0,0 +1,131 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+/* Stable C API of the minorseq engine, exported by libminorseq.so.
+ *
+ * All handles are opaque and owned by the caller. They may be reused across
+ * calls: opening reads or calling variants again replaces the previous
+ * contents of the handle. A handle must not be used by two threads at once;
+ * distinct handles may be used concurrently.
+ *
+ * Every function returning ms_status reports failures as MS_ERROR, with a
+ * description in ms_last_error() of the calling thread. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define MS_API __attribute__((visibility("default")))
+#else
+#define MS_API
+#endif
+
+typedef enum ms_status { MS_OK = 0, MS_ERROR = 1 } ms_status;
+
+typedef enum ms_mode { MS_MODE_AMINO = 0, MS_MODE_PHASING = 2 } ms_mode;
+
+/* Analysis configuration, equal to juliet without any options */
+typedef struct ms_config ms_config;
+/* Aligned reads of one sample */
+typedef struct ms_reads ms_reads;
+/* Variants called on a ms_reads with a ms_config */
+typedef struct ms_result ms_result;
+
+/* One variant codon. Strings are owned by the result and valid until it is
+ * reused or freed. */
+typedef struct ms_variant
+{
+    const char* gene;
+    /* 1-based codon number within the gene */
+    int codon_pos;
+    const char* ref_codon;
+    const char* alt_codon;
+    char ref_amino_acid;
+    char alt_amino_acid;
+    int coverage;
+    double frequency;
+    double p_value;
+    /* Empty if the variant is not a known DRM */
+    const char* known_drm;
+} ms_variant;
+
+MS_API const char* ms_version(void);
+/* Description of the last error of the calling thread */
+MS_API const char* ms_last_error(void);
+/* Resizes the process-wide thread pool. Must not be called while variants
+ * are being called. */
+MS_API ms_status ms_set_num_threads(size_t num_threads);
+
+MS_API ms_status ms_config_create(ms_config** config);
+MS_API void ms_config_free(ms_config* config);
+/* Predefined name, JSON file, or JSON string, as juliet --config. The
+ * config is parsed once and reused by every call. */
+MS_API ms_status ms_config_set_target(ms_config* config, const char* target);
+/* 1-based region as juliet --region, 0 leaves an end open */
+MS_API ms_status ms_config_set_region(ms_config* config, int begin, int end);
+MS_API ms_status ms_config_set_mode(ms_config* config, ms_mode mode);
+MS_API ms_status ms_config_set_drm_only(ms_config* config, int drm_only);
+/* Reported variant frequency range, in percent */
+MS_API ms_status ms_config_set_percentages(ms_config* config, double min_perc, double max_perc);
+/* Overrides the chemistry error model, 0 for both restores it */
+MS_API ms_status ms_config_set_error_rates(ms_config* config, double substitution_rate,
+                                           double deletion_rate);
+
+MS_API ms_status ms_reads_create(ms_reads** reads);
+MS_API void ms_reads_free(ms_reads* reads);
+/* Loads the reads of an aligned BAM within the region of config */
+MS_API ms_status ms_reads_open(ms_reads* reads, const char* bam_path, const ms_config* config);
+MS_API size_t ms_reads_count(const ms_reads* reads);
+
+MS_API ms_status ms_result_create(ms_result** result);
+MS_API void ms_result_free(ms_result* result);
+/* Calls variants of reads, phased in MS_MODE_PHASING */
+MS_API ms_status ms_call(const ms_config* config, const ms_reads* reads, ms_result* result);
+MS_API size_t ms_result_num_variants(const ms_result* result);
+MS_API ms_status ms_result_variant(const ms_result* result, size_t index, ms_variant* variant);
+MS_API size_t ms_result_num_haplotypes(const ms_result* result);
+/* Writes the juliet JSON report */
+MS_API ms_status ms_result_write_json(const ms_result* result, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -39,6 +39,7 @@
 
 #include <exception>
 #include <fstream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -55,19 +56,52 @@ class Cleric
 public:
     Cleric(const std::string& alignmentPath, const std::string& outputFile,
            const std::string& fromReference, const std::string& fromReferenceName,
-           const std::string& toReference, const std::string& toReferenceName)
+           const std::string& toReference, const std::string& toReferenceName,
+           const std::string& cacheDir = "")
         : alignmentPath_(alignmentPath)
         , fromReferenceName_(fromReferenceName)
         , toReferenceName_(toReferenceName)
     {
-        Align(fromReference, toReference, &fromReferenceSequence_, &toReferenceSequence_);
+        if (cacheDir.empty()) {
+            Align(fromReference, toReference, &fromReferenceSequence_, &toReferenceSequence_);
+            Liftover();
+        } else {
+            AlignCached(fromReference, toReference, cacheDir);
+        }
         Convert(outputFile);
     }
 
+    /// Computes the liftover from fromReference to toReference without
+    /// touching any file; records are converted one at a time via Convert.
+    Cleric(const std::string& fromReference, const std::string& fromReferenceName,
+           const std::string& toReference, const std::string& toReferenceName,
+           const std::string& cacheDir = "")
+        : fromReferenceName_(fromReferenceName), toReferenceName_(toReferenceName)
+    {
+        if (cacheDir.empty()) {
+            Align(fromReference, toReference, &fromReferenceSequence_, &toReferenceSequence_);
+            Liftover();
+        } else {
+            AlignCached(fromReference, toReference, cacheDir);
+        }
+    }
+
+public:
+    /// Rewrites cigar, position, and NM tag of a record aligned to the
+    /// source reference in place, such that it is aligned to the target.
+    void Convert(BAM::BamRecord* read) const;
+    /// Returns a copy of header with the source reference replaced by the target.
+    BAM::BamHeader ConvertHeader(const BAM::BamHeader& header) const;
+
 private:
     void Convert(std::string outputFile);
     void Align(const std::string& fromReference, const std::string& toReference,
                std::string* fromReferenceAligned, std::string* toReferenceAligned);
+    /// Computes gapless references and position maps from the aligned references.
+    void Liftover();
+    /// Same as Align and Liftover, but reuses a previous result from cacheDir.
+    void AlignCached(const std::string& fromReference, const std::string& toReference,
+                     const std::string& cacheDir);
 
 private:
     // clang-format off
@@ -51,6 +51,8 @@ struct ClericSettings
 {
     std::vector<std::string> InputFiles;
     std::string OutputPrefix;
+    std::string CacheDir;
+    size_t NumThreads;
 
     /// Parses the provided CLI::Results and retrieves a defined set of options.
     ClericSettings(const PacBio::CLI::Results& options);
@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace PacBio {
+namespace Cleric {
+
+/// Gapped pairwise alignment of two references and the liftover arrays
+/// derived from it.
+struct ReferenceAlignment
+{
+    std::string FromReferenceAligned;
+    std::string ToReferenceAligned;
+    std::map<int, int> SamPosToFastaPos;
+    std::map<int, int> FastaPosToSamPos;
+};
+
+/// On-disk cache of ReferenceAlignments, keyed by the MD5s of both
+/// ungapped references. Entries are written to a temporary file and
+/// atomically renamed into place, so that parallel jobs sharing one
+/// cache directory never observe partially written entries. Entries end
+/// with the MD5 of their content, truncated or corrupted entries miss.
+class ReferenceAlignmentCache
+{
+public:
+    ReferenceAlignmentCache(const std::string& cacheDir);
+
+public:
+    /// Returns true and fills alignment, if a valid entry exists.
+    bool Load(const std::string& fromMD5, const std::string& toMD5,
+              ReferenceAlignment* alignment) const;
+    /// Stores alignment, overwriting any previous entry for this pair.
+    void Store(const std::string& fromMD5, const std::string& toMD5,
+               const ReferenceAlignment& alignment) const;
+
+private:
+    std::string EntryPath(const std::string& fromMD5, const std::string& toMD5) const;
+
+private:
+    const std::string cacheDir_;
+};
+}
+}  // ::PacBio::Cleric
@@ -47,6 +47,7 @@
 #include <pbbam/BamRecord.h>
 
 #include <pacbio/data/ArrayBase.h>
+#include <pacbio/util/Profiler.h>
 
 namespace PacBio {
 namespace Data {
@@ -132,6 +133,8 @@ public:  // data
 protected:
     size_t referenceStart_;
     size_t referenceEnd_;
+    /// Accounted to the "reads" subsystem of the profile
+    Util::TrackedBytes memory_;
 };
 
 class BAMArrayRead : public ArrayRead
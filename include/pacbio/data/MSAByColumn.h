@@ -44,6 +44,7 @@
 #include <pacbio/data/ArrayRead.h>
 #include <pacbio/data/MSAByRow.h>
 #include <pacbio/data/MSAColumn.h>
+#include <pacbio/util/Profiler.h>
 
 namespace PacBio {
 namespace Data {
@@ -85,6 +86,11 @@ public:
 private:
     void BeginEnd(const Data::ArrayRead& read);
     void FillCounts(const ArrayRead& read, const QvThresholds& qvThresholds);
+    static Util::MemoryCounter& Memory();
+
+private:
+    /// Accounted to the "msa_columns" subsystem of the profile
+    Util::TrackedBytes memory_{Memory()};
 };
 }  // namespace Data
 }  // namespace PacBio
@@ -37,15 +37,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <pacbio/data/ArrayRead.h>
 #include <pacbio/data/MSARow.h>
 #include <pacbio/data/QvThresholds.h>
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Stats.h>
+#include <pacbio/util/ThreadPool.h>
 
 namespace PacBio {
 namespace Data {
@@ -56,43 +63,156 @@ struct MSAByRow
 
     MSAByRow(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads)
     {
-        for (const auto& r : reads)
-            BeginEnd(*r);
-
-        for (const auto& r : reads) {
-            auto row = AddRead(*r);
-            row.Read = r;
-            const auto x = std::make_shared<MSARow>(std::move(row));
-            NameToRow[r->Name] = x;
-            Rows.emplace_back(x);
+        const auto firstReads =
+            Build(reads.size(), [&reads](size_t i) -> const Data::ArrayRead& { return *reads[i]; });
+        for (size_t u = 0; u < Rows.size(); ++u)
+            Rows[u]->Read = reads[firstReads[u]];
+    }
+
+    MSAByRow(const std::vector<Data::ArrayRead>& reads)
+    {
+        Build(reads.size(), [&reads](size_t i) -> const Data::ArrayRead& { return reads[i]; });
+    }
+
+    void BeginEnd(const Data::ArrayRead& read)
+    {
+        BeginPos = std::min(BeginPos, read.ReferenceStart());
+        EndPos = std::max(EndPos, read.ReferenceEnd());
+    }
+
+    /// Number of input reads, the sum of all row weights
+    size_t NumReads() const { return RowOfRead.size(); }
+
+private:
+    /// Keeps one row for every set of identical reads, built from the first
+    /// of them in input order, and weights it by the number of reads it
+    /// stands for. Reads are compared after QV masking before any row is
+    /// built, reads that only differ in masked bases collapse. Returns the
+    /// first read of every row.
+    template <typename ReadAt>
+    std::vector<size_t> Build(const size_t numReads, const ReadAt& readAt)
+    {
+        Util::ScopedStage stage("msa_rows");
+        ReadNames.reserve(numReads);
+        for (size_t i = 0; i < numReads; ++i) {
+            BeginEnd(readAt(i));
+            ReadNames.push_back(readAt(i).Name);
+        }
+
+        std::vector<uint64_t> hashes(numReads);
+        Util::ParallelFor(0, numReads,
+                          [this, &hashes, &readAt](size_t i) { hashes[i] = Hash(readAt(i)); });
+
+        std::unordered_map<uint64_t, std::vector<size_t>> hashToRows;
+        hashToRows.reserve(numReads);
+        std::vector<size_t> firstReads;
+        RowOfRead.resize(numReads);
+        for (size_t i = 0; i < numReads; ++i) {
+            auto& candidates = hashToRows[hashes[i]];
+            bool found = false;
+            for (const size_t u : candidates) {
+                if (SameRow(readAt(firstReads[u]), readAt(i))) {
+                    RowOfRead[i] = u;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                candidates.push_back(firstReads.size());
+                RowOfRead[i] = firstReads.size();
+                firstReads.push_back(i);
+            }
+        }
+
+        Rows.resize(firstReads.size());
+        Util::ParallelFor(0, Rows.size(), [this, &firstReads, &readAt](size_t u) {
+            Rows[u] = std::make_shared<MSARow>(AddRead(readAt(firstReads[u])));
+        });
+        for (size_t i = 0; i < numReads; ++i) {
+            const auto& row = Rows[RowOfRead[i]];
+            if (firstReads[RowOfRead[i]] != i) ++row->Weight;
+            NameToRow[ReadNames[i]] = row;
         }
+        Util::Stats::Add(Util::Stat::READS_COLLAPSED, numReads - Rows.size());
 
         BeginPos += 1;
         EndPos += 1;
+        if (Util::Profiler::Enabled()) memory_.Set(Bytes());
+        return firstReads;
     }
 
-    MSAByRow(const std::vector<Data::ArrayRead>& reads)
+    /// What base adds to its row: the operation and, but for deletions, the
+    /// nucleotide. Matches and mismatches are alike, masked bases read 'N'.
+    uint16_t Token(const Data::ArrayBase& b, uint64_t* failingQv) const
     {
-        for (const auto& r : reads)
-            BeginEnd(r);
+        switch (b.Cigar) {
+            case 'X':
+            case '=':
+                if (b.MeetQVThresholds(qvThresholds))
+                    return ('M' << 8) | static_cast<unsigned char>(b.Nucleotide);
+                ++*failingQv;
+                return ('M' << 8) | 'N';
+            case 'D':
+                return 'D' << 8;
+            case 'I':
+                return ('I' << 8) | static_cast<unsigned char>(b.Nucleotide);
+            case 'P':
+            case 'S':
+                return 'P' << 8;
+            default:
+                throw std::runtime_error("Unexpected cigar " + std::to_string(b.Cigar));
+        }
+    }
 
-        for (const auto& r : reads) {
-            const auto x = std::make_shared<MSARow>(AddRead(r));
-            NameToRow[r.Name] = x;
-            Rows.emplace_back(x);
+    /// FNV-1a over the start and the tokens of a read
+    uint64_t Hash(const Data::ArrayRead& read) const
+    {
+        uint64_t h = 14695981039346656037ULL;
+        const auto Mix = [&h](const unsigned char c) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        };
+        const int start = read.ReferenceStart();
+        for (size_t i = 0; i < sizeof(start); ++i)
+            Mix(static_cast<unsigned char>(start >> (8 * i)));
+        uint64_t failingQv = 0;
+        for (const auto& b : read.Bases) {
+            const uint16_t token = Token(b, &failingQv);
+            Mix(token >> 8);
+            Mix(token & 0xFF);
         }
+        Util::Stats::Add(Util::Stat::BASES_FAILING_QV, failingQv);
+        return h;
+    }
 
-        BeginPos += 1;
-        EndPos += 1;
+    /// Reads with equal tokens give equal rows
+    bool SameRow(const Data::ArrayRead& a, const Data::ArrayRead& b) const
+    {
+        if (a.ReferenceStart() != b.ReferenceStart() || a.Bases.size() != b.Bases.size())
+            return false;
+        uint64_t failingQv = 0;
+        for (size_t i = 0; i < a.Bases.size(); ++i)
+            if (Token(a.Bases[i], &failingQv) != Token(b.Bases[i], &failingQv)) return false;
+        return true;
     }
 
-    void BeginEnd(const Data::ArrayRead& read)
+    /// Rows, their insertions, and the name index, approximately
+    size_t Bytes() const
     {
-        BeginPos = std::min(BeginPos, read.ReferenceStart());
-        EndPos = std::max(EndPos, read.ReferenceEnd());
+        size_t bytes = 0;
+        for (const auto& row : Rows) {
+            bytes += sizeof(MSARow) + row->Bases.capacity();
+            for (const auto& pos_ins : row->Insertions)
+                bytes += sizeof(pos_ins) + pos_ins.second.capacity() + 32;
+        }
+        for (const auto& name_row : NameToRow)
+            bytes += sizeof(name_row) + name_row.first.capacity() + 32;
+        bytes += RowOfRead.capacity() * sizeof(size_t);
+        for (const auto& name : ReadNames)
+            bytes += sizeof(name) + name.capacity();
+        return bytes;
     }
 
-private:
     MSARow AddRead(const Data::ArrayRead& read)
     {
         MSARow row(EndPos - BeginPos);
@@ -112,10 +232,7 @@ private:
                 case 'X':
                 case '=':
                     CheckInsertion();
-                    if (b.MeetQVThresholds(qvThresholds))
-                        row.Bases[pos++] = b.Nucleotide;
-                    else
-                        row.Bases[pos++] = 'N';
+                    row.Bases[pos++] = b.MeetQVThresholds(qvThresholds) ? b.Nucleotide : 'N';
                     break;
                 case 'D':
                     CheckInsertion();
@@ -141,8 +258,24 @@ public:
     const Data::QvThresholds qvThresholds;
     int BeginPos = std::numeric_limits<int>::max();
     int EndPos = 0;
+    /// Distinct rows, identical reads share one row with a Weight
     std::vector<std::shared_ptr<MSARow>> Rows;
+    /// Row index of every input read
+    std::vector<size_t> RowOfRead;
+    /// Name of every input read, in input order
+    std::vector<std::string> ReadNames;
     std::map<std::string, std::shared_ptr<MSARow>> NameToRow;
+
+private:
+    static Util::MemoryCounter& Memory()
+    {
+        static auto& counter = Util::MemoryCounter::Get("msa_rows");
+        return counter;
+    }
+
+private:
+    /// Accounted to the "msa_rows" subsystem of the profile
+    Util::TrackedBytes memory_{Memory()};
 };
 }
 }  // ::PacBio::Juliet
\ No newline at end of file
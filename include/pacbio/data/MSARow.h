@@ -51,6 +51,13 @@ struct MSARow
     std::vector<char> Bases;
     std::map<int, std::string> Insertions;
     std::shared_ptr<Data::ArrayRead> Read;
+    /// Number of reads collapsed into this row
+    int Weight = 1;
+
+    bool operator==(const MSARow& other) const
+    {
+        return Bases == other.Bases && Insertions == other.Insertions;
+    }
 };
 }
 }  // ::PacBio::Data
@@ -52,14 +52,13 @@ struct FuseSettings
     std::string InputFile;
     std::string OutputFile;
     int MinCoverage = 0;
+    size_t NumThreads = 1;
     int RegionStart = 0;
     int RegionEnd = std::numeric_limits<int>::max();
 
     /// Parses the provided CLI::Results and retrieves a defined set of options.
     FuseSettings(const PacBio::CLI::Results& options);
 
-    size_t ThreadCount(int n);
-
     /// Given the description of the tool and its version, create all
     /// necessary CLI::Options for the ccs executable.
     static PacBio::CLI::Interface CreateCLI();
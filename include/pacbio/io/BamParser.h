@@ -37,11 +37,14 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <pbbam/BamRecord.h>
 #include <pbbam/EntireFileQuery.h>
 #include <pbbam/PbiFilterQuery.h>
 
@@ -56,5 +59,26 @@ std::unique_ptr<BAM::internal::IQuery> BamQuery(const std::string& filePath);
 std::vector<std::shared_ptr<Data::ArrayRead>> BamToArrayReads(
     const std::string& filePath, int regionStart = 0,
     int regionEnd = std::numeric_limits<int>::max());
+
+/// \brief Same as BamToArrayReads, reads are grouped by their read group id
+std::map<std::string, std::vector<std::shared_ptr<Data::ArrayRead>>> BamToArrayReadsByReadGroup(
+    const std::string& filePath, int regionStart = 0,
+    int regionEnd = std::numeric_limits<int>::max());
+
+/// \brief Same as BamToArrayReads, but only batchSize reads are held at a
+/// time. Each batch is decoded on the shared thread pool and handed to f
+/// before the next one is parsed.
+void StreamArrayReads(
+    const std::string& filePath, int regionStart, int regionEnd, size_t batchSize,
+    const std::function<void(const std::vector<std::shared_ptr<Data::ArrayRead>>&)>& f);
+
+/// \brief Unrolls all records on the shared thread pool, without any
+/// filtering or clipping. Indices follow the input order.
+std::vector<Data::ArrayRead> RecordsToArrayReads(const std::vector<BAM::BamRecord>& records);
+
+/// \brief Same as BamToArrayReads, for records that are already in memory
+std::vector<std::shared_ptr<Data::ArrayRead>> BamToArrayReads(
+    const std::vector<BAM::BamRecord>& records, int regionStart = 0,
+    int regionEnd = std::numeric_limits<int>::max());
 }
 }  // ::PacBio::IO
\ No newline at end of file
@@ -0,0 +1,125 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <pacbio/util/Profiler.h>
+
+namespace PacBio {
+namespace IO {
+
+/// Streaming JSON emitter. Values are appended as they are produced, only
+/// the nesting state is kept. The output is buffered and formatted like
+/// JSON::Json::dump(indent). Keys are written in call order; emit them
+/// sorted to reproduce the DOM output.
+class JsonWriter
+{
+public:
+    /// A negative indent writes compact JSON on a single line.
+    explicit JsonWriter(std::ostream& out, int indent = 2);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+public:
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+    JsonWriter& Key(const std::string& key);
+
+    JsonWriter& Value(const std::string& value);
+    JsonWriter& Value(const char* value);
+    JsonWriter& Value(bool value);
+    /// Formatted as JSON::Json::dump does, non-finite values are null.
+    JsonWriter& Value(double value);
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, JsonWriter&>::type Value(T value)
+    {
+        BeginValue();
+        buffer_ += std::to_string(value);
+        return EndValue();
+    }
+    template <typename T>
+    JsonWriter& Value(const std::vector<T>& values)
+    {
+        BeginArray();
+        for (const auto& v : values)
+            Value(v);
+        return EndArray();
+    }
+
+    template <typename T>
+    JsonWriter& Member(const std::string& key, const T& value)
+    {
+        Key(key);
+        return Value(value);
+    }
+
+    /// Writes the buffer to the stream.
+    void Flush();
+
+private:
+    struct Scope
+    {
+        bool IsObject;
+        bool Empty;
+    };
+
+    void BeginValue();
+    JsonWriter& EndValue();
+    JsonWriter& End(bool isObject);
+    void NewLine();
+    void AppendString(const std::string& s);
+
+private:
+    std::ostream& out_;
+    const int indent_;
+    std::string buffer_;
+    std::vector<Scope> scopes_;
+    bool afterKey_ = false;
+    /// Accounted to the "json" subsystem of the profile
+    Util::TrackedBytes memory_;
+};
+}
+}  // ::PacBio::IO
@@ -0,0 +1,98 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace IO {
+
+/// Streams VCF 4.2 records of a single contig. Names ending in ".gz" are
+/// written BGZF-compressed and receive a tabix index on Close().
+///
+/// Records may arrive slightly out of order; they are held back until
+/// Flush(position) promises that no record before position follows.
+class VcfWriter
+{
+public:
+    struct Record
+    {
+        std::string Chrom;
+        /// 1-based
+        int Pos;
+        std::string Ref;
+        std::string Alt;
+        std::string Info;
+    };
+
+public:
+    /// Writes the file format line, the given meta-information lines
+    /// without their leading "##", and the column header.
+    VcfWriter(const std::string& filename, const std::vector<std::string>& metaLines);
+    /// Closes the file if Close() has not been called, without an index.
+    ~VcfWriter();
+
+    VcfWriter(const VcfWriter&) = delete;
+    VcfWriter& operator=(const VcfWriter&) = delete;
+
+public:
+    void Add(Record record);
+    /// Writes all held back records before position.
+    void Flush(int position);
+    /// Writes the remaining records, closes the file, and builds the tabix
+    /// index of compressed output.
+    void Close();
+
+private:
+    void WriteRecord(const Record& record);
+    void WriteBuffer();
+
+private:
+    class Output;
+
+    const std::string filename_;
+    const bool compressed_;
+    std::unique_ptr<Output> out_;
+    std::string buffer_;
+    std::multimap<int, Record> pending_;
+};
+}
+}  // ::PacBio::IO
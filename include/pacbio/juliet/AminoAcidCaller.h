@@ -45,8 +45,10 @@
 #include <iostream>
 #include <limits>
 #include <list>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <set>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -55,11 +57,13 @@
 #include <pacbio/data/MSAByRow.h>
 #include <pacbio/juliet/ErrorEstimates.h>
 #include <pacbio/juliet/Haplotype.h>
+#include <pacbio/juliet/HtmlReport.h>
 #include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/SampleArrays.h>
 #include <pacbio/juliet/TargetConfig.h>
 #include <pacbio/juliet/TransitionTable.h>
 #include <pacbio/juliet/VariantGene.h>
-#include <pbcopper/json/JSON.h>
+#include <pacbio/util/Profiler.h>
 
 namespace PacBio {
 namespace Juliet {
@@ -73,16 +77,52 @@ public:
                     const ErrorEstimates& error, const JulietSettings& settings);
 
 public:
-    /// Generate JSON output of variant amino acids
-    JSON::Json JSON();
+    /// Key figures of the report, without building it
+    struct ReportSummary
+    {
+        int NumVariantPositions = 0;
+        size_t NumHaplotypes = 0;
+        std::set<std::string> KnownDRMs;
+    };
+
+public:
+    /// Streams the JSON output of variant amino acids and haplotypes. A
+    /// negative indent writes a single line.
+    void WriteJson(std::ostream& out, int indent = 2) const;
+    /// Renders the HTML summary from the typed results, in a single write.
+    /// A positive page size renders the tables on demand in the browser.
+    void WriteHtml(std::ostream& out, const std::string& filename, const std::string& parameters,
+                   int pageSize = 0) const;
+    /// Streams one VCF record per variant codon, trimmed to the differing
+    /// nucleotides, in reference order. Names ending in ".gz" are written
+    /// BGZF-compressed and tabix-indexed. contig is used as CHROM.
+    void WriteVcf(const std::string& filename, const std::string& contig) const;
+    /// Same as WriteVcf, for the given variant genes
+    static void WriteVcf(const std::vector<VariantGene>& variantGenes,
+                         const TargetConfig& targetConfig, const std::string& filename,
+                         const std::string& contig);
+    ReportSummary Summary() const;
+    /// Copies counts and variants once into contiguous buffers.
+    SampleArrays Arrays() const;
 
 public:
     void PhaseVariants();
 
 private:
     static constexpr float alpha = 0.01;
+    /// Histogram of the codons of all reads that fully cover a codon.
+    struct CodonCounts
+    {
+        std::map<std::string, int> Codons;
+        int Coverage = 0;
+    };
+
     void CallVariants();
-    int CountNumberOfTests(const std::vector<TargetGene>& genes) const;
+    /// Counts codons at position bi, relative to the MSA begin.
+    CodonCounts CountCodons(int bi) const;
+    /// Counts codons at each codon beginning of each gene, in parallel.
+    std::vector<std::vector<CodonCounts>> CountCodons(const std::vector<TargetGene>& genes) const;
+    int CountNumberOfTests(const std::vector<std::vector<CodonCounts>>& geneCodons) const;
     std::string FindDRMs(const std::string& geneName, const std::vector<TargetGene>& genes,
                          const DMutation curDRM) const;
     double Probability(const std::string& a, const std::string& b);
@@ -92,6 +132,7 @@ private:
                                              const int& coverage, const std::string& geneName,
                                              double* truePositives, double* falsePositives,
                                              double* falseNegative, double* trueNegative);
+    static Util::MemoryCounter& HaplotypeMemory();
 
 private:
     Data::MSAByRow msaByRow_;
@@ -102,8 +143,13 @@ public:
 
 private:
     std::vector<VariantGene> variantGenes_;
+    /// Genes and their codon histograms, as called
+    std::vector<TargetGene> genes_;
+    std::vector<std::vector<CodonCounts>> geneCodons_;
     std::vector<Haplotype> reconstructedHaplotypes_;
     std::vector<Haplotype> filteredHaplotypes_;
+    /// Accounted to the "haplotypes" subsystem of the profile
+    Util::TrackedBytes haplotypeMemory_{HaplotypeMemory()};
     int noConfOffset = 0;
     const ErrorEstimates error_;
     const TargetConfig targetConfig_;
@@ -40,30 +40,96 @@
 #include <algorithm>
 #include <iostream>
 #include <locale>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace PacBio {
 namespace Juliet {
-/// Contains CCS error estimates
+class ErrorModel;
+
+/// Contains CCS error estimates. Rates are fixed at construction, the codon
+/// matrix is derived from them.
 class ErrorEstimates
 {
 public:
     ErrorEstimates() = default;
+    /// Rates of chemistry in the ErrorModelRegistry, unknown chemistries
+    /// fall back to its default in permissive mode
     ErrorEstimates(const std::string& chemistry);
     ErrorEstimates(const double substitutionRate, const double deletionRate);
+    /// As above, with an insertion rate and a match rate that is not derived
+    ErrorEstimates(const double matchRate, const double substitutionRate, const double deletionRate,
+                   const double insertionRate);
+    /// Global rates of a model estimated by juliet --mode-error
+    explicit ErrorEstimates(const ErrorModel& model);
+
+    /// Probability to read codon b if codon a was sequenced, the product of
+    /// the per-base match, substitution, and deletion rates. Codons over
+    /// ACGT- are looked up in a matrix derived from the rates at construction.
+    double CodonProbability(const std::string& a, const std::string& b) const
+    {
+        if (codons_ && a.size() == 3 && b.size() == 3) {
+            const int i = CodonIndex(a);
+            const int j = CodonIndex(b);
+            if (i >= 0 && j >= 0) return (*codons_)[i * numCodons + j];
+        }
+        return ComputeProbability(a, b);
+    }
 
-    double match = -1;
-    double substitution = -1;
-    double deletion = -1;
-    double insertion = -1;
+    double Match() const { return match_; }
+    /// Per alternative base
+    double Substitution() const { return substitution_; }
+    double Deletion() const { return deletion_; }
+    double Insertion() const { return insertion_; }
 
     friend std::ostream& operator<<(std::ostream& stream, const ErrorEstimates& r)
     {
-        stream << "match:" << r.match << "\tsubstitution:" << r.substitution
-               << "\tdeletion:" << r.deletion << "\tinsertion:" << r.insertion;
+        stream << "match:" << r.match_ << "\tsubstitution:" << r.substitution_
+               << "\tdeletion:" << r.deletion_ << "\tinsertion:" << r.insertion_;
         return stream;
     }
+
+private:
+    static constexpr int numCodons = 125;
+
+    static int BaseIndex(const char c)
+    {
+        switch (c) {
+            case 'A':
+                return 0;
+            case 'C':
+                return 1;
+            case 'G':
+                return 2;
+            case 'T':
+                return 3;
+            case '-':
+                return 4;
+            default:
+                return -1;
+        }
+    }
+    static int CodonIndex(const std::string& codon)
+    {
+        const int a = BaseIndex(codon[0]);
+        const int b = BaseIndex(codon[1]);
+        const int c = BaseIndex(codon[2]);
+        if (a < 0 || b < 0 || c < 0) return -1;
+        return (a * 5 + b) * 5 + c;
+    }
+
+    double ComputeProbability(const std::string& a, const std::string& b) const;
+    void DeriveCodonMatrix();
+
+private:
+    double match_ = -1;
+    double substitution_ = -1;
+    double deletion_ = -1;
+    double insertion_ = -1;
+    /// Shared by all copies, estimates of a chemistry are copied per sample
+    std::shared_ptr<const std::vector<double>> codons_;
 };
 }
 }  // ::PacBio::Juliet
\ No newline at end of file
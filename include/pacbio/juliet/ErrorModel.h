@@ -0,0 +1,121 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Data {
+class ArrayRead;
+}
+namespace Juliet {
+/// Mean error rates over the alignment columns of one sequence context
+struct ErrorRates
+{
+    int64_t Columns = 0;
+    double Substitution = 0;
+    double Deletion = 0;
+    double Insertion = 0;
+};
+
+/// Error rates of a single reference position
+struct PositionErrorRates
+{
+    /// 1-based
+    int RefPos;
+    /// Most frequent base, '-' or 'N' if not a sequence position
+    char Consensus;
+    int64_t Coverage;
+    double Substitution;
+    double Deletion;
+    double Insertion;
+};
+
+/// Alignment error profile of a sample, globally, per reference position,
+/// and per sequence context of the consensus. A substitution is any base
+/// that is neither the consensus nor a gap, an insertion is counted before
+/// the base it precedes. Only columns with more than MinCoverage reads
+/// contribute to the global and the context rates. The global substitution
+/// rate is 1 - f('-') - f(max) per column, as juliet has always printed it;
+/// it differs from the position rate only in columns of a gap consensus.
+class ErrorModel
+{
+public:
+    /// Written and expected by Load
+    static constexpr int Version = 1;
+    /// Homopolymers of this length or longer share one context
+    static constexpr int MaxHomopolymer = 10;
+    static constexpr int MinCoverage = 100;
+
+public:
+    ErrorModel() = default;
+
+    /// Streams the reads of filePath in batches, counted on the shared
+    /// thread pool, without materializing the whole sample.
+    static ErrorModel Estimate(const std::string& filePath, int regionStart = 0,
+                               int regionEnd = std::numeric_limits<int>::max());
+    /// Same as Estimate, from reads in memory
+    static ErrorModel Estimate(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads);
+    /// Reads a model written by WriteJson
+    static ErrorModel Load(const std::string& filename);
+
+    void WriteJson(std::ostream& out) const;
+    /// Same as WriteJson, to a file
+    void WriteJson(const std::string& filename) const;
+
+public:
+    /// Sequencing chemistries of the reads, comma-separated if mixed
+    std::string Chemistry;
+    std::string Input;
+    int64_t NumReads = 0;
+    ErrorRates Global;
+    /// Keyed by the length of the homopolymer a position belongs to
+    std::map<int, ErrorRates> Homopolymers;
+    /// Keyed by the consensus base and its two neighbours, e.g. "ACG"
+    std::map<std::string, ErrorRates> Trinucleotides;
+    /// All covered positions, ascending
+    std::vector<PositionErrorRates> Positions;
+};
+}
+}  // ::PacBio::Juliet
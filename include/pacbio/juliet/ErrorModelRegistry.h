@@ -0,0 +1,85 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/juliet/ErrorEstimates.h>
+
+namespace PacBio {
+namespace Juliet {
+/// Error rates of all known chemistries, from a versioned JSON registry.
+/// The built-in registry holds the supported Sequel chemistries, entries of
+/// the file named by $MINORSEQ_ERROR_MODELS are added on top and replace
+/// built-ins of the same chemistry. An entry either lists its rates or
+/// names a model written by juliet --mode-error, of which the global rates
+/// are used. Codon matrices are derived once per chemistry.
+class ErrorModelRegistry
+{
+public:
+    static constexpr int Version = 1;
+    static constexpr const char* EnvironmentVariable = "MINORSEQ_ERROR_MODELS";
+
+public:
+    /// Only the built-in chemistries
+    ErrorModelRegistry();
+
+    /// Process-wide registry, loaded on first use
+    static const ErrorModelRegistry& Default();
+
+    /// Adds all entries of a registry file
+    void Load(const std::string& filename);
+
+    /// Estimates of chemistry, nullptr if unknown
+    const ErrorEstimates* Find(const std::string& chemistry) const;
+    /// Estimates for unknown chemistries
+    const ErrorEstimates& Fallback() const;
+
+private:
+    /// Models are resolved relative to directory
+    void Add(const JSON::Json& root, const std::string& directory);
+
+private:
+    std::map<std::string, ErrorEstimates> entries_;
+    std::string fallback_;
+};
+}
+}  // ::PacBio::Juliet
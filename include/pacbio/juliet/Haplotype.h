@@ -1,9 +1,13 @@
 #pragma once
 
+#include <numeric>
+#include <string>
+#include <vector>
+
 #include <pacbio/juliet/HaplotypeType.h>
 #include <pacbio/util/Termcolor.h>
 
-#include <pbcopper/json/JSON.h>
+#include <pacbio/io/JsonWriter.h>
 
 namespace PacBio {
 namespace Juliet {
@@ -51,17 +55,17 @@ struct Haplotype
         return stream;
     }
 
-    JSON::Json ToJson() const
+    /// Streams the haplotype as a JSON object
+    void WriteJson(IO::JsonWriter& out) const
     {
-        using namespace JSON;
-        Json root;
-        root["name"] = Name;
-        root["reads_hard"] = Names.size();
-        root["reads_soft"] = Size();
-        root["frequency"] = GlobalFrequency;
-        root["read_names"] = Names;
-        root["codons"] = Codons;
-        return root;
+        out.BeginObject();
+        out.Member("codons", Codons);
+        out.Member("frequency", GlobalFrequency);
+        out.Member("name", Name);
+        out.Member("read_names", Names);
+        out.Member("reads_hard", Names.size());
+        out.Member("reads_soft", Size());
+        out.EndObject();
     }
 };
 }
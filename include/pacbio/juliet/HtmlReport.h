@@ -0,0 +1,104 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <pacbio/juliet/Haplotype.h>
+#include <pacbio/juliet/TargetConfig.h>
+#include <pacbio/juliet/VariantGene.h>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Renders the HTML summary straight from the typed variant calls. Every
+/// gene and haplotype is visited once and the whole document is assembled in
+/// one preallocated buffer, which is written out in a single call.
+class HtmlReport
+{
+public:
+    /// Number of reads per haplotype category
+    struct ReadCounts
+    {
+        int HealthyReported = 0;
+        int HealthyLowCoverage = 0;
+        int AllDamaged = 0;
+        int MarginalWithGaps = 0;
+        int MarginalWithHeteroduplexes = 0;
+        int MarginalPartial = 0;
+    };
+
+public:
+    HtmlReport(const std::vector<VariantGene>& genes, const std::vector<Haplotype>& haplotypes,
+               const ReadCounts& counts, const TargetConfig& config);
+
+public:
+    /// Generate HTML output of variant amino acids. A positive page size
+    /// embeds the variant tables as a compact data blob, which the page
+    /// renders per gene and page on demand.
+    void Write(std::ostream& out, std::string filename, std::string parameters,
+               int pageSize = 0) const;
+    /// Same document as Write, as a string
+    std::string Render(std::string filename, std::string parameters, int pageSize = 0) const;
+
+private:
+    class Buffer;
+
+    void DRMView(Buffer& out) const;
+    void Discovery(Buffer& out, int numHaplotypes) const;
+    void PagedDiscovery(Buffer& out, int numHaplotypes, int pageSize) const;
+    void DiscoveryHeader(Buffer& out, const VariantGene& gene, int numHaplotypes) const;
+    void Legend(Buffer& out, int numHaplotypes) const;
+    /// Number of columns in the haplotype_hit vectors, -1 without variants
+    int CountNumHaplotypes() const;
+    /// Rough size of the document, used to allocate the buffer once
+    size_t EstimateSize(int pageSize) const;
+
+    static void Encode(std::string& data);
+
+private:
+    /// Genes with at least one variant position, in report order
+    std::vector<const VariantGene*> genes_;
+    const std::vector<Haplotype>& haplotypes_;
+    const ReadCounts counts_;
+    const TargetConfig& config_;
+};
+}
+}  //::PacBio::Juliet
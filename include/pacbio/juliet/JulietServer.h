@@ -0,0 +1,115 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/TargetConfig.h>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Long-running juliet service on a Unix domain socket. Each connection
+/// carries one newline-terminated JSON request and receives one JSON
+/// response line. Parsed target configs are cached across requests, and
+/// concurrent jobs share the process-wide thread pool.
+///
+/// Request:  {"input": "/abs/path.bam", "region": "2253-3869",
+///            "config": "<HIV>", "phasing": true, "drmOnly": false,
+///            "minPerc": 0, "maxPerc": 100, "html": "", "json": ""}
+///           {"command": "ping"} or {"command": "shutdown"}
+/// Response: {"status": "ok", "result": {...}} or
+///           {"status": "error", "message": "..."}
+class JulietServer
+{
+public:
+    /// Binds socketPath, replacing a stale socket file. Only the user
+    /// running the daemon may connect.
+    JulietServer(const std::string& socketPath, size_t maxJobs);
+    ~JulietServer();
+
+public:
+    /// Accepts connections until a shutdown request arrives, then waits
+    /// for all running jobs.
+    void Serve();
+
+    /// Sends request to the server listening on socketPath and returns
+    /// its response.
+    static JSON::Json Submit(const std::string& socketPath, const JSON::Json& request);
+
+private:
+    void Connection(int fd);
+    /// Returns the serialized response line.
+    std::string Handle(const JSON::Json& request);
+    /// Returns the serialized juliet report.
+    std::string Analyze(const JSON::Json& request);
+
+    /// Parses each distinct -c argument once, the cache holds the 64 most
+    /// recently used configs.
+    std::shared_ptr<const TargetConfig> Config(const std::string& input);
+
+private:
+    const std::string socketPath_;
+    const size_t maxJobs_;
+    int listenFd_;
+    std::atomic<bool> shutdown_;
+
+    std::mutex jobsMutex_;
+    std::condition_variable jobsDone_;
+    size_t activeJobs_ = 0;
+
+    struct CachedConfig
+    {
+        std::shared_ptr<const TargetConfig> Config;
+        uint64_t LastUse = 0;
+    };
+    std::mutex configMutex_;
+    std::map<std::string, CachedConfig> configs_;
+    uint64_t configUses_ = 0;
+};
+}
+}  // ::PacBio::Juliet
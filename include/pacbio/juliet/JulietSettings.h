@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,23 +58,43 @@ struct JulietSettings
     TargetConfig TargetConfigUser;
     int RegionStart = 0;
     int RegionEnd = std::numeric_limits<int>::max();
-    bool DRMOnly;
-    bool SaveMSA;
-    bool MergeOutliers;
-    bool Verbose;
-    bool Debug;
+    bool DRMOnly = false;
+    bool SaveMSA = false;
+    bool MergeOutliers = false;
+    bool Verbose = false;
+    bool Debug = false;
 
-    AnalysisMode Mode;
-    double SubstitutionRate;
-    double DeletionRate;
-    double MinimalPerc;
-    double MaximalPerc;
+    AnalysisMode Mode = AnalysisMode::AMINO;
+    double SubstitutionRate = 0;
+    double DeletionRate = 0;
+    /// Written by --mode-error, its rates replace the chemistry defaults
+    std::string ErrorModelFile;
+    double MinimalPerc = 0;
+    double MaximalPerc = 100;
+    size_t NumThreads = 1;
+    /// Variant positions per HTML page, 0 renders all tables statically
+    int HtmlPageSize = 0;
+    /// Write <prefix>.vcf.gz next to the reports
+    bool Vcf = false;
+
+    std::string SampleSheet;
+    std::string SummaryFile = "juliet_summary.json";
+    bool SplitByReadGroup = false;
+    /// Bytes, 0 means unlimited
+    size_t MaxMemory = 0;
+    /// Stage timings are written here, empty disables profiling
+    std::string ProfileFile;
+    /// Work counters are written here, "-" prints them, empty disables them
+    std::string StatsFile;
+    /// Chrome trace events are written here, empty disables tracing
+    std::string TraceFile;
+
+    /// Default configuration, equal to juliet without any options.
+    JulietSettings() = default;
 
     /// Parses the provided CLI::Results and retrieves a defined set of options.
     JulietSettings(const PacBio::CLI::Results& options);
 
-    size_t ThreadCount(int n);
-
     /// Given the description of the tool and its version, create all
     /// necessary CLI::Options for the ccs executable.
     static PacBio::CLI::Interface CreateCLI();
@@ -38,7 +38,14 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/juliet/AminoAcidCaller.h>
 #include <pacbio/juliet/JulietSettings.h>
 
 namespace PacBio {
@@ -51,10 +58,45 @@ public:
     /// Execute the complete Juliet workflow
     void Run(const JulietSettings& settings);
 
+    /// Call amino acid variants on reads that are already in memory and
+    /// write the non-empty outputs. The JSON report is streamed to
+    /// outputJson and, compact on one line, to jsonStream if given.
+    /// inputName is used for the report and to name the VCF contig.
+    AminoAcidCaller::ReportSummary CallVariants(
+        const std::vector<std::shared_ptr<Data::ArrayRead>>& sharedReads,
+        const JulietSettings& settings, const std::string& inputName, const std::string& outputHtml,
+        const std::string& outputJson, const std::string& outputMsa = "",
+        std::ostream* jsonStream = nullptr, const std::string& outputVcf = "");
+
+private:
+    struct Sample
+    {
+        std::string Name;
+        std::string Input;
+        std::string OutputPrefix;
+    };
+
 private:
     std::ostream& LogCI(const std::string& prefix);
     void AminoPhasing(const JulietSettings& settings);
     void Error(const JulietSettings& settings);
+
+    /// Parses "<bam>" or "<name> <bam>" lines, # starts a comment.
+    static std::vector<Sample> ReadSampleSheet(const std::string& sampleSheet);
+    /// Analyzes all samples concurrently within the memory budget and
+    /// writes one summary for the plate.
+    void Batch(const std::vector<Sample>& samples, const JulietSettings& settings);
+    /// Writes the reports of one sample, or of each of its read groups, and
+    /// returns their summaries. Errors are reported in the summaries.
+    std::vector<JSON::Json> AnalyzeSample(const Sample& sample, const JulietSettings& settings);
+    JSON::Json AnalyzeReads(const std::vector<std::shared_ptr<Data::ArrayRead>>& sharedReads,
+                            const std::string& name, const std::string& input,
+                            const std::string& outputPrefix, const JulietSettings& settings);
+    /// Reference name of the target config, or of the single reference of
+    /// the input
+    static std::string VcfContig(const JulietSettings& settings, const std::string& input);
+    static JSON::Json ErrorSummary(const std::string& name, const std::string& input,
+                                   const std::string& message);
 };
 }
 }  // ::PacBio::Juliet
\ No newline at end of file
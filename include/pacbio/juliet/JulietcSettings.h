@@ -37,32 +37,26 @@
 
 #pragma once
 
-#include <pbcopper/json/JSON.h>
-#include <fstream>
+#include <string>
 
-#include <pacbio/data/ArrayRead.h>
-#include <pacbio/juliet/TargetConfig.h>
+#include <pbcopper/cli/CLI.h>
+#include <pbcopper/json/JSON.h>
 
 namespace PacBio {
 namespace Juliet {
 
-class JsonToHtml
+/// Contains user provided CLI configuration for the juliet daemon client
+struct JulietcSettings
 {
-public:
-    /// Generate HTML output of variant amino acids
-    static void HTML(std::ostream& out, const JSON::Json& j, const TargetConfig& config,
-                     bool onlyKnownDRMs, std::string filename, std::string parameters);
-
-private:
-    static void DRMView(std::ostream& out, const JSON::Json& j, const TargetConfig& config,
-                        bool onlyKnownDRMs);
-    /// Generate HTML output of variant amino acids
-    static void Discovery(std::ostream& out, const JSON::Json& j, const TargetConfig& config,
-                          bool onlyKnownDRMs, int numHaplotypes);
+    std::string SocketPath;
+    JSON::Json Request;
 
-    static std::string Strip(const std::string& input);
+    /// Parses the provided CLI::Results and translates them into a request.
+    JulietcSettings(const PacBio::CLI::Results& options);
 
-    static void Encode(std::string& data);
+    /// Given the description of the tool and its version, create all
+    /// necessary CLI::Options for the julietc executable.
+    static PacBio::CLI::Interface CreateCLI();
 };
 }
-}  //::PacBio::Juliet
\ No newline at end of file
+}  // ::PacBio::Juliet
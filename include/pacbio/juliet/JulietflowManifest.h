@@ -0,0 +1,96 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Records, for every julietflow stage, a fingerprint of its inputs and
+/// parameters and the MD5 of each file it wrote. A rerun against the same
+/// work directory skips stages whose fingerprint is unchanged and whose
+/// outputs are still intact. The manifest is rewritten atomically after
+/// each stage, a crash never leaves it pointing at partial outputs.
+class JulietflowManifest
+{
+public:
+    /// An empty path disables checkpointing, no stage is ever valid.
+    JulietflowManifest(const std::string& manifestPath);
+
+public:
+    bool Enabled() const { return !manifestPath_.empty(); }
+
+    /// Returns true if stage last ran with fingerprint and all of its
+    /// outputs exist with the recorded content.
+    bool IsValid(const std::string& stage, const std::string& fingerprint) const;
+
+    /// Returns the recorded MD5 of output of stage.
+    std::string OutputHash(const std::string& stage, const std::string& output) const;
+
+    /// Hashes outputs, records them for stage, and persists the manifest.
+    void Commit(const std::string& stage, const std::string& fingerprint,
+                const std::vector<std::string>& outputs);
+
+public:
+    /// MD5 of the file content, identical to BAM::MD5Hash of the content.
+    static std::string FileHash(const std::string& file);
+
+    /// MD5 over all parts and the minorseq version; upgrading invalidates
+    /// every stage.
+    static std::string Fingerprint(const std::vector<std::string>& parts);
+
+private:
+    struct Stage
+    {
+        std::string Fingerprint;
+        std::map<std::string, std::string> Outputs;
+    };
+
+private:
+    void Load();
+    void Store() const;
+
+private:
+    const std::string manifestPath_;
+    std::map<std::string, Stage> stages_;
+};
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,72 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <pbbam/BamRecord.h>
+#include <pbbam/FastaSequence.h>
+
+#include <pacbio/juliet/JulietflowSettings.h>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Executes the minor variant pipeline in a single process. Reads are
+/// aligned to the reference, iteratively re-aligned to their consensus,
+/// lifted over to the target reference, and passed to the amino acid
+/// caller without intermediate files.
+class JulietflowWorkflow
+{
+public:
+    /// Execute the complete julietflow pipeline
+    void Run(const JulietflowSettings& settings);
+
+private:
+    /// Aligns reads to references and writes the alignment to outputFile,
+    /// if not empty.
+    std::vector<BAM::BamRecord> MapReads(const std::vector<BAM::BamRecord>& reads,
+                                         const std::vector<BAM::FastaSequence>& references,
+                                         const JulietflowSettings& settings,
+                                         const std::string& outputFile) const;
+    void WriteAlignments(const std::string& outputFile, const BAM::BamHeader& header,
+                         const std::vector<BAM::BamRecord>& records, size_t numThreads) const;
+};
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,93 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Results of one sample as flat, row-major buffers. They are laid out to be
+/// exposed without copies, e.g. as NumPy arrays via the Python bindings.
+struct SampleArrays
+{
+    /// Number of nucleotide columns, A, C, G, T, -, N
+    static constexpr int NumNucleotides = 6;
+    /// Number of ACGT codons, indexed by CodonIndex
+    static constexpr int NumCodons = 64;
+
+    /// 0-based reference position of the first MSA row
+    int32_t MsaBeginPos = 0;
+    /// (positions x NumNucleotides) nucleotide counts
+    std::vector<int32_t> MsaCounts;
+
+    /// Index into GeneNames, 1-based reference position, and coverage of
+    /// each codon
+    std::vector<int32_t> CodonGene;
+    std::vector<int32_t> CodonPos;
+    std::vector<int32_t> CodonCoverage;
+    /// (codons x NumCodons) histogram of the reads fully covering a codon
+    std::vector<int32_t> CodonCounts;
+
+    /// One entry per variant codon, in report order. Positions are 1-based
+    /// codon numbers within their gene, codons are given by CodonIndex.
+    std::vector<int32_t> VariantGene;
+    std::vector<int32_t> VariantCodonPos;
+    std::vector<int32_t> VariantRefCodon;
+    std::vector<int32_t> VariantAltCodon;
+    std::vector<int32_t> VariantCoverage;
+    std::vector<double> VariantFrequency;
+    std::vector<double> VariantPValue;
+    std::vector<std::string> VariantDRM;
+
+    std::vector<std::string> GeneNames;
+
+    int NumMsaPositions() const { return static_cast<int>(MsaCounts.size() / NumNucleotides); }
+    int NumCodonPositions() const { return static_cast<int>(CodonPos.size()); }
+    int NumVariants() const { return static_cast<int>(VariantGene.size()); }
+
+    /// 16 * a + 4 * b + c, with A = 0, C = 1, G = 2, T = 3. Returns -1
+    /// for codons with other characters.
+    static int CodonIndex(const std::string& codon);
+    /// Inverse of CodonIndex
+    static std::string Codon(int index);
+};
+}
+}  // ::PacBio::Juliet
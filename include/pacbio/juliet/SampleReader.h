@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/juliet/AminoAcidCaller.h>
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/SampleArrays.h>
+
+namespace PacBio {
+namespace Juliet {
+
+/// Analyzes one aligned BAM after another and hands out its results as
+/// SampleArrays, without writing any report. Only a single sample is held
+/// in memory at any time.
+class SampleReader
+{
+public:
+    /// Uses the region, target config, error rates, mode, and thresholds
+    /// of settings; its input and output names are ignored.
+    SampleReader(const std::vector<std::string>& inputs, const JulietSettings& settings);
+
+public:
+    /// Results of the next input, nullptr after the last one.
+    /// Throws for inputs without reads or with mixed chemistries.
+    std::shared_ptr<SampleArrays> Next();
+    /// Name of the input returned by the last call to Next()
+    const std::string& Name() const { return name_; }
+
+    /// Calls variants of reads as juliet does, phased in PHASING mode.
+    /// Throws for empty reads or mixed chemistries.
+    static std::unique_ptr<AminoAcidCaller> Call(
+        const std::vector<std::shared_ptr<Data::ArrayRead>>& reads, const JulietSettings& settings);
+
+private:
+    const std::vector<std::string> inputs_;
+    const JulietSettings settings_;
+    size_t next_ = 0;
+    std::string name_;
+};
+}
+}  // ::PacBio::Juliet
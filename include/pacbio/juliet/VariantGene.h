@@ -37,12 +37,13 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include <pbcopper/json/JSON.h>
+#include <pacbio/io/JsonWriter.h>
 
 namespace PacBio {
 namespace Juliet {
@@ -53,11 +54,37 @@ struct VariantGene
 
     struct VariantPosition
     {
+        /// Nucleotide counts of one MSA column around the variant codon
+        struct MsaColumn
+        {
+            int relPos;
+            int absPos;
+            /// A, C, G, T, -, N
+            std::array<int, 6> counts;
+            char wt;
+
+            /// Streams the column as a JSON object
+            void WriteJson(IO::JsonWriter& out) const
+            {
+                out.BeginObject();
+                out.Member("-", counts[4]);
+                out.Member("A", counts[0]);
+                out.Member("C", counts[1]);
+                out.Member("G", counts[2]);
+                out.Member("N", counts[5]);
+                out.Member("T", counts[3]);
+                out.Member("abs_pos", absPos);
+                out.Member("rel_pos", relPos);
+                out.Member("wt", std::string(1, wt));
+                out.EndObject();
+            }
+        };
+
         std::string refCodon;
         std::string altRefCodon;
         char refAminoAcid;
         char altRefAminoAcid;
-        std::vector<JSON::Json> msa;
+        std::vector<MsaColumn> msa;
         int coverage;
 
         struct VariantCodon
@@ -89,45 +116,57 @@ struct VariantGene
 
     std::map<int, std::shared_ptr<VariantPosition>> relPositionToVariant;
 
-    JSON::Json ToJson() const
+    bool HasVariantPositions() const
     {
-        using namespace JSON;
-        Json root;
-        root["name"] = geneName;
-        std::vector<Json> positions;
-        for (const auto& pos_variant : relPositionToVariant) {
-            Json jVarPos;
-            jVarPos["ref_position"] = pos_variant.first;
-            jVarPos["ref_codon"] = pos_variant.second->refCodon;
-            jVarPos["coverage"] = pos_variant.second->coverage;
-            jVarPos["ref_amino_acid"] = std::string(1, pos_variant.second->refAminoAcid);
-
-            if (pos_variant.second->aminoAcidToCodons.empty()) continue;
-            std::vector<Json> jVarAAs;
-            for (const auto& aa_varCodon : pos_variant.second->aminoAcidToCodons) {
-                Json jVarAA;
-                jVarAA["amino_acid"] = std::string(1, aa_varCodon.first);
-                std::vector<Json> jCodons;
+        for (const auto& pos_variant : relPositionToVariant)
+            if (pos_variant.second->IsVariant()) return true;
+        return false;
+    }
 
-                if (aa_varCodon.second.empty()) continue;
-                for (const auto& codon : aa_varCodon.second) {
-                    Json jCodon;
-                    jCodon["codon"] = codon.codon;
-                    jCodon["frequency"] = codon.frequency;
-                    jCodon["pValue"] = codon.pValue;
-                    jCodon["known_drm"] = codon.knownDRM;
-                    jCodon["haplotype_hit"] = codon.haplotypeHit;
-                    jCodons.push_back(jCodon);
+    /// Streams the gene as JSON, keys sorted to match the previous
+    /// Json::dump output. Genes without variant positions have no such key.
+    void WriteJson(IO::JsonWriter& out) const
+    {
+        out.BeginObject();
+        out.Member("name", geneName);
+        if (HasVariantPositions()) {
+            out.Key("variant_positions").BeginArray();
+            for (const auto& pos_variant : relPositionToVariant) {
+                const auto& variant = *pos_variant.second;
+                if (!variant.IsVariant()) continue;
+                out.BeginObject();
+                out.Member("coverage", variant.coverage);
+                out.Key("msa").BeginArray();
+                for (const auto& column : variant.msa)
+                    column.WriteJson(out);
+                out.EndArray();
+                out.Member("ref_amino_acid", std::string(1, variant.refAminoAcid));
+                out.Member("ref_codon", variant.refCodon);
+                out.Member("ref_position", pos_variant.first);
+                out.Key("variant_amino_acids").BeginArray();
+                for (const auto& aa_varCodon : variant.aminoAcidToCodons) {
+                    if (aa_varCodon.second.empty()) continue;
+                    out.BeginObject();
+                    out.Member("amino_acid", std::string(1, aa_varCodon.first));
+                    out.Key("variant_codons").BeginArray();
+                    for (const auto& codon : aa_varCodon.second) {
+                        out.BeginObject();
+                        out.Member("codon", codon.codon);
+                        out.Member("frequency", codon.frequency);
+                        out.Member("haplotype_hit", codon.haplotypeHit);
+                        out.Member("known_drm", codon.knownDRM);
+                        out.Member("pValue", codon.pValue);
+                        out.EndObject();
+                    }
+                    out.EndArray();
+                    out.EndObject();
                 }
-                jVarAA["variant_codons"] = jCodons;
-                jVarAAs.push_back(jVarAA);
+                out.EndArray();
+                out.EndObject();
             }
-            jVarPos["variant_amino_acids"] = jVarAAs;
-            jVarPos["msa"] = pos_variant.second->msa;
-            positions.push_back(jVarPos);
+            out.EndArray();
         }
-        if (!positions.empty()) root["variant_positions"] = positions;
-        return root;
+        out.EndObject();
     }
 };
 }
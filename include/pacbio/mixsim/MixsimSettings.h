@@ -0,0 +1,82 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pbcopper/cli/CLI.h>
+
+#include <pacbio/juliet/TargetConfig.h>
+
+namespace PacBio {
+namespace Mixsim {
+
+/// Contains user provided CLI configuration for mixsim
+struct MixsimSettings
+{
+    std::string ReferenceFile;
+    std::string OutputFile;
+    Juliet::TargetConfig TargetConfigUser;
+    size_t Coverage = 3000;
+    /// Percentage of each minor haplotype, the major takes the remainder
+    std::vector<double> MinorPercentages{1};
+    /// Linked codon substitutions per minor haplotype
+    int VariantsPerHaplotype = 3;
+    /// Zero substitution and deletion rates select the S/P2-C2 estimates
+    double SubstitutionRate = 0;
+    double DeletionRate = 0;
+    double InsertionRate = 0;
+    /// Percentage of reads that cover only part of the reference
+    double PartialPercentage = 10;
+    uint32_t Seed = 42;
+    size_t NumThreads = 1;
+
+    /// Defaults, equal to mixsim without any options.
+    MixsimSettings() = default;
+
+    /// Parses the provided CLI::Results and retrieves a defined set of options.
+    MixsimSettings(const PacBio::CLI::Results& options);
+
+    /// Given the description of the tool and its version, create all
+    /// necessary CLI::Options for the mixsim executable.
+    static PacBio::CLI::Interface CreateCLI();
+};
+}
+}  // ::PacBio::Mixsim
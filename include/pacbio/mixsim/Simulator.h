@@ -0,0 +1,119 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <pbbam/BamHeader.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/ReadGroupInfo.h>
+
+#include <pacbio/juliet/ErrorEstimates.h>
+#include <pacbio/juliet/TargetConfig.h>
+#include <pacbio/mixsim/MixsimSettings.h>
+
+namespace PacBio {
+namespace Mixsim {
+
+/// A codon substitution carried by a simulated haplotype
+struct SimulatedVariant
+{
+    std::string Gene;
+    /// 1-based reference position of the first codon base
+    int Position;
+    /// 1-based amino acid position within the gene
+    int AminoAcidPosition;
+    std::string RefCodon;
+    std::string AltCodon;
+};
+
+struct SimulatedHaplotype
+{
+    std::string Name;
+    double Percentage;
+    size_t NumReads;
+    std::string Sequence;
+    std::vector<SimulatedVariant> Variants;
+};
+
+/// Simulates deep CCS amplicon sequencing of a mixture of haplotypes. Each
+/// minor haplotype carries its variants linked on every read. Reads are
+/// derived from the seed and their index only, such that the output is
+/// independent of the number of threads. Random numbers are drawn from
+/// mt19937 directly, not from the implementation-defined <random>
+/// distributions, such that the output is equal across standard libraries.
+class Simulator
+{
+public:
+    Simulator(const std::string& referenceName, const std::string& reference,
+              const MixsimSettings& settings);
+
+public:
+    const std::vector<SimulatedHaplotype>& Haplotypes() const { return haplotypes_; }
+    const Juliet::ErrorEstimates& Error() const { return error_; }
+    size_t NumReads() const { return readHaplotype_.size(); }
+
+    /// Read idx, aligned to the reference
+    BAM::BamRecord Read(size_t idx) const;
+    BAM::BamHeader Header() const;
+
+    /// Writes all reads in batches, generated in parallel, and a PBI index.
+    void WriteBam(const std::string& outputFile) const;
+    /// Writes haplotypes and their variants as JSON, the truth to compare
+    /// juliet's calls against.
+    void WriteTruth(std::ostream& out) const;
+
+private:
+    void CreateHaplotypes(std::vector<Juliet::TargetGene> genes);
+    void AssignReads();
+
+private:
+    const MixsimSettings settings_;
+    const std::string referenceName_;
+    const std::string reference_;
+    Juliet::ErrorEstimates error_;
+    BAM::ReadGroupInfo readGroup_;
+    std::vector<SimulatedHaplotype> haplotypes_;
+    /// Haplotype of each read
+    std::vector<uint32_t> readHaplotype_;
+};
+}
+}  // ::PacBio::Mixsim
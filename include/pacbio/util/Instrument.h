@@ -0,0 +1,85 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace PacBio {
+namespace Util {
+
+/// Process-wide switch and file output of an instrument T, shared by
+/// Profiler, Stats, and Tracer. Instrumented code checks Enabled, which
+/// costs a single relaxed load, such that it is free while disabled.
+template <typename T>
+class Instrument
+{
+public:
+    static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Writes T::WriteJson(std::ostream&) to filename.
+    static void WriteJson(const std::string& filename)
+    {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Could not open " + filename);
+        T::WriteJson(out);
+    }
+
+protected:
+    static void SetEnabled() { enabled_ = true; }
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+template <typename T>
+std::atomic<bool> Instrument<T>::enabled_(false);
+
+/// State that threads of an instrument register with. Never destroyed, pool
+/// threads may exit during static destruction.
+template <typename Registry>
+Registry& LeakedRegistry()
+{
+    static Registry* registry = new Registry;
+    return *registry;
+}
+
+}  // namespace Util
+}  // namespace PacBio
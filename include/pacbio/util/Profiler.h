@@ -0,0 +1,182 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include <pacbio/util/Instrument.h>
+#include <pacbio/util/Tracer.h>
+
+namespace PacBio {
+namespace Util {
+
+/// Process-wide stage profiler. Stages are opened with ScopedStage and
+/// nest per thread; tasks of the shared thread pool run under the stage
+/// that submitted them. Memory held by the major containers is accounted
+/// per subsystem with MemoryCounter.
+class Profiler : public Instrument<Profiler>
+{
+public:
+    struct Stage;
+
+public:
+    /// Starts collecting, usually once after parsing --profile.
+    static void Enable();
+
+    /// Writes the stage tree with calls, wall time, and CPU time per stage.
+    /// Wall time is summed over all calls, CPU time over all threads that
+    /// worked for the stage, both include nested stages. Each stage also
+    /// reports the RSS and the subsystem bytes at its end, the process peak
+    /// RSS, and how much the stage raised that peak, maxima over all calls.
+    static void WriteJson(std::ostream& out);
+    using Instrument<Profiler>::WriteJson;
+
+    /// Wraps a thread pool task to run under the stage of the calling
+    /// thread. CPU time of other threads is added to that stage.
+    static std::function<void()> Attach(std::function<void()> task);
+
+private:
+    friend class ScopedStage;
+
+    /// Child name of parent, created on first use
+    static Stage* Child(Stage* parent, const char* name);
+    /// Accounts one call of stage that started at peakRssBegin
+    static void Close(Stage* stage, int64_t wallNs, int64_t cpuNs, int64_t peakRssBegin);
+    /// Adds CPU time of another thread to stage and all of its ancestors
+    static void AddCpu(Stage* stage, int64_t cpuNs);
+    static int64_t ThreadCpuNs();
+    /// Process high-water mark of the resident set, 0 if unknown
+    static int64_t PeakRss();
+    /// Current resident set, 0 if unknown
+    static int64_t CurrentRss();
+};
+
+/// Times the enclosing scope as a stage named name, nested under the open
+/// stage of this thread. Also a span in the trace, if tracing.
+class ScopedStage
+{
+public:
+    explicit ScopedStage(const char* name)
+    {
+        if (Profiler::Enabled()) Begin(name);
+        if (Tracer::Enabled()) {
+            Tracer::Begin(name, "stage");
+            traced_ = true;
+        }
+    }
+    ~ScopedStage()
+    {
+        if (traced_) Tracer::End();
+        if (stage_) End();
+    }
+
+    ScopedStage(const ScopedStage&) = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+    void Begin(const char* name);
+    void End();
+
+private:
+    Profiler::Stage* stage_ = nullptr;
+    Profiler::Stage* parent_ = nullptr;
+    std::chrono::steady_clock::time_point wallBegin_;
+    int64_t cpuBegin_ = 0;
+    int64_t peakRssBegin_ = 0;
+    bool traced_ = false;
+};
+
+/// Bytes currently held by all objects of one subsystem, and their peak
+class MemoryCounter
+{
+public:
+    /// Counter of name, listed in the profile from its first use
+    static MemoryCounter& Get(const std::string& name);
+
+public:
+    void Add(int64_t bytes);
+    int64_t Bytes() const { return bytes_.load(std::memory_order_relaxed); }
+    int64_t PeakBytes() const { return peak_.load(std::memory_order_relaxed); }
+
+private:
+    MemoryCounter() = default;
+
+private:
+    std::atomic<int64_t> bytes_{0};
+    std::atomic<int64_t> peak_{0};
+};
+
+/// Accounts the bytes of one object to a MemoryCounter, for as long as the
+/// object lives. Copies account the same bytes again. Only sizes set while
+/// the profiler is enabled are accounted.
+class TrackedBytes
+{
+public:
+    explicit TrackedBytes(MemoryCounter& counter) : counter_(&counter) {}
+    TrackedBytes(const TrackedBytes& other) : counter_(other.counter_) { Set(other.bytes_); }
+    TrackedBytes& operator=(const TrackedBytes& other)
+    {
+        if (this != &other) {
+            Set(0);
+            counter_ = other.counter_;
+            Set(other.bytes_);
+        }
+        return *this;
+    }
+    ~TrackedBytes() { Set(0); }
+
+public:
+    void Set(const size_t bytes)
+    {
+        if (bytes == bytes_ || (bytes_ == 0 && !Profiler::Enabled())) return;
+        counter_->Add(static_cast<int64_t>(bytes) - static_cast<int64_t>(bytes_));
+        bytes_ = bytes;
+    }
+
+private:
+    MemoryCounter* counter_;
+    size_t bytes_ = 0;
+};
+
+}  // namespace Util
+}  // namespace PacBio
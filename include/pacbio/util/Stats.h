@@ -0,0 +1,105 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <pacbio/util/Instrument.h>
+
+namespace PacBio {
+namespace Util {
+
+/// Units of work counted in the hot paths
+enum class Stat : size_t
+{
+    READS_DECODED = 0,
+    READS_SKIPPED_SECONDARY,
+    READS_SKIPPED_SUPPLEMENTARY,
+    READS_SKIPPED_REGION,
+    BASES_FAILING_QV,
+    READS_COLLAPSED,
+    CODONS_EVALUATED,
+    CODONS_SKIPPED_GAP,
+    CODONS_SKIPPED_N,
+    CODONS_SKIPPED_UNCOVERED,
+    FISHER_TESTS,
+    HAPLOTYPE_COMPARISONS,
+    TRANSITION_LOOKUPS,
+    SIZE
+};
+
+/// Process-wide work counters. Every thread counts into its own block,
+/// without synchronization; blocks are summed when read and folded into
+/// the totals when their thread exits. Hot loops should count locally and
+/// add once.
+class Stats : public Instrument<Stats>
+{
+public:
+    static constexpr size_t NumStats = static_cast<size_t>(Stat::SIZE);
+
+public:
+    /// Starts counting, usually once after parsing --stats.
+    static void Enable();
+
+    static void Add(const Stat stat, const uint64_t n = 1)
+    {
+        if (n != 0 && Enabled()) AddLocal(stat, n);
+    }
+
+    /// Sums over all threads, running and exited
+    static std::array<uint64_t, NumStats> Totals();
+    /// snake_case name of stat, as written to JSON
+    static const char* Name(Stat stat);
+
+    /// Writes one line per counter.
+    static void Write(std::ostream& out);
+    /// Writes all counters as a single JSON object.
+    static void WriteJson(std::ostream& out);
+    using Instrument<Stats>::WriteJson;
+
+private:
+    static void AddLocal(Stat stat, uint64_t n);
+};
+
+}  // namespace Util
+}  // namespace PacBio
@@ -0,0 +1,177 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PacBio {
+namespace Util {
+
+/// Work-stealing thread pool. Every worker owns a task deque, runs its own
+/// tasks in LIFO order, and steals from the front of other deques when idle.
+/// A pool of n threads starts n - 1 workers; the thread waiting on a
+/// TaskGroup executes tasks as well.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    /// Number of threads executing tasks, including the waiting thread.
+    size_t NumThreads() const { return workers_.size() + 1; }
+
+    /// Process-wide pool shared by all stages, single-threaded until
+    /// Configure is called.
+    static ThreadPool& Default();
+    /// Resizes the process-wide pool. Must be called before any work is
+    /// submitted to it, usually once after parsing --num-threads.
+    static void Configure(size_t numThreads);
+    /// Resolves --num-threads n to a thread count, at most the number of
+    /// cores. Values below one are relative to the number of cores.
+    static size_t ThreadCount(int n);
+
+private:
+    friend class TaskGroup;
+
+    struct WorkQueue
+    {
+        std::mutex Mutex;
+        std::deque<std::function<void()>> Tasks;
+    };
+
+    void Submit(std::function<void()> task);
+    /// Executes one queued task, own deque first. Returns false if there
+    /// was nothing to do.
+    bool RunPendingTask();
+    bool PopTask(size_t first, std::function<void()>* task);
+    void WorkerLoop(size_t idx);
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> nextQueue_;
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+    bool stop_ = false;
+};
+
+/// A set of tasks that can be waited on. Tasks may spawn nested groups.
+/// The first exception thrown by any task is rethrown by Wait.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::Default());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+public:
+    void Run(std::function<void()> task);
+    /// Blocks until all tasks finished, executing queued tasks meanwhile.
+    void Wait();
+    /// Executes queued tasks until ready returns true or all tasks of this
+    /// group finished. Unlike Wait, exceptions are kept for Wait.
+    void WaitUntil(const std::function<bool()>& ready);
+
+private:
+    ThreadPool& pool_;
+    std::atomic<size_t> outstanding_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+/// Calls f(chunkBegin, chunkEnd) on consecutive, disjoint chunks of
+/// [begin, end). Chunks are handed out dynamically to balance uneven work.
+/// Use this form to amortize per-chunk setup, e.g. scratch buffers.
+template <typename F>
+void ParallelForRange(size_t begin, size_t end, const F& f,
+                      ThreadPool& pool = ThreadPool::Default())
+{
+    if (begin >= end) return;
+    const size_t n = end - begin;
+    const size_t numThreads = std::min(pool.NumThreads(), n);
+    if (numThreads == 1) {
+        f(begin, end);
+        return;
+    }
+
+    // Few chunks per thread keep the overhead low, but still allow stealing
+    const size_t chunkSize = std::max<size_t>(1, n / (numThreads * 8));
+    std::atomic<size_t> next(begin);
+    const auto Worker = [&]() {
+        for (size_t b = next.fetch_add(chunkSize); b < end; b = next.fetch_add(chunkSize))
+            f(b, std::min(end, b + chunkSize));
+    };
+
+    TaskGroup group(pool);
+    for (size_t i = 0; i < numThreads; ++i)
+        group.Run(Worker);
+    group.Wait();
+}
+
+/// Calls f(i) for every i in [begin, end).
+template <typename F>
+void ParallelFor(size_t begin, size_t end, const F& f, ThreadPool& pool = ThreadPool::Default())
+{
+    ParallelForRange(begin, end,
+                     [&f](size_t b, size_t e) {
+                         for (size_t i = b; i < e; ++i)
+                             f(i);
+                     },
+                     pool);
+}
+
+}  // namespace Util
+}  // namespace PacBio
@@ -0,0 +1,100 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include <pacbio/util/Instrument.h>
+
+namespace PacBio {
+namespace Util {
+
+/// Records spans as Chrome trace events, to load a run into Perfetto or
+/// chrome://tracing. Every thread appends to its own buffer without
+/// locking; buffers outlive their threads and are written once at the
+/// end.
+class Tracer : public Instrument<Tracer>
+{
+public:
+    /// Starts recording, names the calling thread "main" if unnamed.
+    static void Enable();
+
+    /// Opens a span on this thread. Spans nest and close in reverse order.
+    static void Begin(const std::string& name, const char* category);
+    /// Closes the innermost span of this thread.
+    static void End();
+    /// Name of this thread in the trace, can be set before Enable.
+    static void SetThreadName(const std::string& name);
+
+    /// Wraps a thread pool task into a span named after the innermost span
+    /// of the calling thread.
+    static std::function<void()> Attach(std::function<void()> task);
+
+    /// Writes all events in the Chrome JSON trace format. Must not be
+    /// called while traced work is running.
+    static void WriteJson(std::ostream& out);
+    using Instrument<Tracer>::WriteJson;
+};
+
+/// Traces the enclosing scope as a span, without profiling it as a stage.
+class TraceScope
+{
+public:
+    TraceScope(const std::string& name, const char* category)
+    {
+        if (!Tracer::Enabled()) return;
+        Tracer::Begin(name, category);
+        active_ = true;
+    }
+    ~TraceScope()
+    {
+        if (active_) Tracer::End();
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    bool active_ = false;
+};
+
+}  // namespace Util
+}  // namespace PacBio
@@ -36,7 +36,9 @@
 // Author: Armin Töpfer
 
 #include <array>
+#include <cctype>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <fstream>
@@ -55,17 +57,29 @@
 
 #include <boost/optional.hpp>
 
+#include <pacbio/Version.h>
+#include <pacbio/io/JsonWriter.h>
+#include <pacbio/io/VcfWriter.h>
 #include <pacbio/juliet/AminoAcidCaller.h>
 #include <pacbio/juliet/AminoAcidTable.h>
 #include <pacbio/juliet/HaplotypeType.h>
 #include <pacbio/statistics/Fisher.h>
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Stats.h>
 #include <pacbio/util/Termcolor.h>
+#include <pacbio/util/ThreadPool.h>
 #include <pbcopper/json/JSON.h>
 
 namespace PacBio {
 namespace Juliet {
 using AAT = AminoAcidTable;
 
+Util::MemoryCounter& AminoAcidCaller::HaplotypeMemory()
+{
+    static auto& counter = Util::MemoryCounter::Get("haplotypes");
+    return counter;
+}
+
 AminoAcidCaller::AminoAcidCaller(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads,
                                  const ErrorEstimates& error, const JulietSettings& settings)
     : msaByRow_(reads)
@@ -83,40 +97,81 @@ AminoAcidCaller::AminoAcidCaller(const std::vector<std::shared_ptr<Data::ArrayRe
     CallVariants();
 }
 
-int AminoAcidCaller::CountNumberOfTests(const std::vector<TargetGene>& genes) const
+AminoAcidCaller::CodonCounts AminoAcidCaller::CountCodons(const int bi) const
 {
-    int numberOfTests = 0;
-    for (const auto& gene : genes) {
-        for (int i = gene.begin; i < gene.end - 2; ++i) {
-            // Relative to gene begin
-            const int ri = i - gene.begin;
-            // Only work on beginnings of a codon
-            if (ri % 3 != 0) continue;
-            // Relative to window begin
-            const int bi = i - msaByRow_.BeginPos;
-
-            std::unordered_map<std::string, int> codons;
-            for (const auto& nucRow : msaByRow_.Rows) {
-                const auto& row = nucRow->Bases;
-                // Read does not cover codon
-                if (bi + 2 >= static_cast<int>(row.size()) || bi < 0) continue;
-                if (row.at(bi + 0) == ' ' || row.at(bi + 1) == ' ' || row.at(bi + 2) == ' ')
-                    continue;
+    CodonCounts result;
+    uint64_t uncovered = 0;
+    uint64_t gap = 0;
+    uint64_t bogus = 0;
+    for (const auto& nucRow : msaByRow_.Rows) {
+        const auto& row = nucRow->Bases;
+        const int weight = nucRow->Weight;
+        const auto CodonContains = [&row, &bi](const char x) {
+            return (row.at(bi + 0) == x || row.at(bi + 1) == x || row.at(bi + 2) == x);
+        };
 
-                // Read has a deletion
-                if (row.at(bi + 0) == '-' || row.at(bi + 1) == '-' || row.at(bi + 2) == '-')
-                    continue;
+        // Read does not cover codon
+        if (bi + 2 >= static_cast<int>(row.size()) || bi < 0 || CodonContains(' ')) {
+            uncovered += weight;
+            continue;
+        }
 
-                std::string codon = std::string() + row.at(bi) + row.at(bi + 1) + row.at(bi + 2);
+        // Read has a deletion
+        if (CodonContains('-')) {
+            gap += weight;
+            continue;
+        }
 
-                // Codon is bogus
-                if (AAT::FromCodon.find(codon) == AAT::FromCodon.cend()) continue;
+        const auto codon = std::string() + row.at(bi) + row.at(bi + 1) + row.at(bi + 2);
 
-                codons[codon]++;
-            }
-            numberOfTests += codons.size();
+        // Codon is bogus
+        if (AAT::FromCodon.find(codon) == AAT::FromCodon.cend()) {
+            bogus += weight;
+            continue;
         }
+        result.Coverage += weight;
+
+        result.Codons[codon] += weight;
     }
+    Util::Stats::Add(Util::Stat::CODONS_EVALUATED, msaByRow_.NumReads());
+    Util::Stats::Add(Util::Stat::CODONS_SKIPPED_UNCOVERED, uncovered);
+    Util::Stats::Add(Util::Stat::CODONS_SKIPPED_GAP, gap);
+    Util::Stats::Add(Util::Stat::CODONS_SKIPPED_N, bogus);
+    return result;
+}
+
+std::vector<std::vector<AminoAcidCaller::CodonCounts>> AminoAcidCaller::CountCodons(
+    const std::vector<TargetGene>& genes) const
+{
+    Util::ScopedStage stage("count_codons");
+    // Flatten all codon beginnings, to balance work across genes
+    std::vector<std::pair<size_t, int>> geneAndPos;
+    std::vector<std::vector<CodonCounts>> result(genes.size());
+    for (size_t g = 0; g < genes.size(); ++g) {
+        const auto& gene = genes[g];
+        for (int i = gene.begin; i < gene.end - 2; i += 3)
+            geneAndPos.emplace_back(g, i);
+        result[g].resize((std::max(0, gene.end - 2 - gene.begin) + 2) / 3);
+    }
+
+    Util::ParallelFor(0, geneAndPos.size(), [&](size_t j) {
+        const auto& gene = genes[geneAndPos[j].first];
+        const int i = geneAndPos[j].second;
+        // Relative to window begin
+        const int bi = i - msaByRow_.BeginPos;
+        result[geneAndPos[j].first][(i - gene.begin) / 3] = CountCodons(bi);
+    });
+    return result;
+}
+
+int AminoAcidCaller::CountNumberOfTests(
+    const std::vector<std::vector<CodonCounts>>& geneCodons) const
+{
+    Util::ScopedStage stage("count_tests");
+    int numberOfTests = 0;
+    for (const auto& codons : geneCodons)
+        for (const auto& c : codons)
+            numberOfTests += c.Codons.size();
     return numberOfTests;
 }
 
@@ -143,6 +198,7 @@ std::string AminoAcidCaller::FindDRMs(const std::string& geneName,
 
 void AminoAcidCaller::PhaseVariants()
 {
+    Util::ScopedStage stage("phase");
     std::vector<std::pair<int, std::shared_ptr<VariantGene::VariantPosition>>> variantPositions;
     for (const auto& vg : variantGenes_) {
         for (const auto& pos_vp : vg.relPositionToVariant)
@@ -171,27 +227,37 @@ void AminoAcidCaller::PhaseVariants()
         return codon;
     };
 
-    // For each read
-    for (const auto& row : msaByRow_.Rows) {
-
-        // Get all codons for this row
-        std::vector<std::string> codons;
-        uint8_t flag = 0;
+    // Get all codons for each row in parallel
+    const auto& rows = msaByRow_.Rows;
+    std::vector<std::vector<std::string>> rowCodons(rows.size());
+    std::vector<uint8_t> rowFlags(rows.size(), 0);
+    Util::ParallelFor(0, rows.size(), [&](size_t r) {
+        auto& codons = rowCodons[r];
+        codons.reserve(variantPositions.size());
         for (const auto& pos_var : variantPositions) {
-            std::string codon = ExtractRegionFromRow(row, pos_var, 0, 3);
+            std::string codon = ExtractRegionFromRow(rows[r], pos_var, 0, 3);
             if (!pos_var.second->IsHit(codon)) {
-                flag |= static_cast<int>(HaplotypeType::OFFTARGET);
+                rowFlags[r] |= static_cast<int>(HaplotypeType::OFFTARGET);
             }
             codons.emplace_back(std::move(codon));
         }
+    });
+
+    // For each distinct row; its reads are assigned to the haplotype below
+    uint64_t comparisons = 0;
+    std::vector<Haplotype*> rowHaplotype(rows.size(), nullptr);
+    for (size_t r = 0; r < rows.size(); ++r) {
+        auto& codons = rowCodons[r];
+        const uint8_t flag = rowFlags[r];
 
         // There are already haplotypes to compare against
         int miss = true;
 
         // Compare current row to existing haplotypes
-        auto CompareHaplotypes = [&miss, &codons,
-                                  &row](std::vector<std::shared_ptr<Haplotype>>& haplotypes) {
+        auto CompareHaplotypes = [&miss, &codons, &r, &rowHaplotype, &comparisons](
+            std::vector<std::shared_ptr<Haplotype>>& haplotypes) {
             for (auto& h : haplotypes) {
+                ++comparisons;
                 // Don't trust if the number of codons differ.
                 // That should only be the case if reads are not full-spanning.
                 if (h->Codons.size() != codons.size()) {
@@ -205,7 +271,7 @@ void AminoAcidCaller::PhaseVariants()
                     }
                 }
                 if (same) {
-                    h->Names.push_back(row->Read->Name);
+                    rowHaplotype[r] = h.get();
                     miss = false;
                     break;
                 }
@@ -217,13 +283,19 @@ void AminoAcidCaller::PhaseVariants()
         // If row could not be collapsed into an existing haplotype
         if (miss) {
             auto h = std::make_shared<Haplotype>();
-            h->Names = {row->Read->Name};
+            rowHaplotype[r] = h.get();
             h->SetCodons(std::move(codons));
             h->Flags |= flag;
             observations.emplace_back(std::move(h));
         }
     }
 
+    Util::Stats::Add(Util::Stat::HAPLOTYPE_COMPARISONS, comparisons);
+
+    // Read names in input order, as if every read had been compared
+    for (size_t i = 0; i < msaByRow_.NumReads(); ++i)
+        rowHaplotype[msaByRow_.RowOfRead[i]]->Names.push_back(msaByRow_.ReadNames[i]);
+
     std::vector<std::shared_ptr<Haplotype>> generators;
     std::vector<std::shared_ptr<Haplotype>> filtered;
     for (auto& h : observations) {
@@ -380,22 +452,25 @@ void AminoAcidCaller::PhaseVariants()
         std::cerr << "---" << std::endl;
         std::cerr << "SUM\t\t\t: " << genCounts_ + sumFiltered << std::endl;
     }
+
+    if (Util::Profiler::Enabled()) {
+        size_t bytes = 0;
+        for (const auto* haplotypes : {&reconstructedHaplotypes_, &filteredHaplotypes_}) {
+            for (const auto& h : *haplotypes) {
+                bytes += sizeof(Haplotype) + h.Name.capacity();
+                for (const auto& name : h.Names)
+                    bytes += sizeof(name) + name.capacity();
+                for (const auto& codon : h.Codons)
+                    bytes += sizeof(codon) + codon.capacity();
+            }
+        }
+        haplotypeMemory_.Set(bytes);
+    }
 }
 
 double AminoAcidCaller::Probability(const std::string& a, const std::string& b)
 {
-    if (a.size() != b.size()) return 0.0;
-
-    double p = 1;
-    for (size_t i = 0; i < a.size(); ++i) {
-        if (a[i] == '-' || b[i] == '-')
-            p *= error_.deletion;
-        else if (a[i] != b[i])
-            p *= error_.substitution;
-        else
-            p *= error_.match;
-    }
-    return p;
+    return error_.CodonProbability(a, b);
 };
 
 std::pair<bool, bool> AminoAcidCaller::MeasurePerformance(
@@ -442,7 +517,9 @@ std::pair<bool, bool> AminoAcidCaller::MeasurePerformance(
 
 void AminoAcidCaller::CallVariants()
 {
-    auto genes = targetConfig_.targetGenes;
+    Util::ScopedStage stage("call");
+    genes_ = targetConfig_.targetGenes;
+    auto& genes = genes_;
     const size_t numExpectedMinors = targetConfig_.NumExpectedMinors();
     const bool hasExpectedMinors = numExpectedMinors > 0;
 
@@ -469,14 +546,17 @@ void AminoAcidCaller::CallVariants()
         geneOffset = begin;
     };
 
-    const int numberOfTests = CountNumberOfTests(genes);
+    geneCodons_ = CountCodons(genes);
+    const auto& geneCodons = geneCodons_;
+    const int numberOfTests = CountNumberOfTests(geneCodons);
 
     double truePositives = 0;
     double falsePositives = 0;
     double falseNegative = 0;
     double trueNegative = 0;
 
-    for (const auto& gene : genes) {
+    for (size_t g = 0; g < genes.size(); ++g) {
+        const auto& gene = genes[g];
         SetNewGene(gene.begin, gene.name);
         for (int i = gene.begin; i < gene.end - 2; ++i) {
             // Absolute reference position
@@ -493,29 +573,8 @@ void AminoAcidCaller::CallVariants()
                 codonPos, std::make_shared<VariantGene::VariantPosition>());
             auto& curVariantPosition = curVariantGene.relPositionToVariant.at(codonPos);
 
-            std::map<std::string, int> codons;
-            int coverage = 0;
-            for (const auto& nucRow : msaByRow_.Rows) {
-                const auto& row = nucRow->Bases;
-                const auto CodonContains = [&row, &bi](const char x) {
-                    return (row.at(bi + 0) == x || row.at(bi + 1) == x || row.at(bi + 2) == x);
-                };
-
-                // Read does not cover codon
-                if (bi + 2 >= static_cast<int>(row.size()) || bi < 0) continue;
-                if (CodonContains(' ')) continue;
-
-                // Read has a deletion
-                if (CodonContains('-')) continue;
-
-                const auto codon = std::string() + row.at(bi) + row.at(bi + 1) + row.at(bi + 2);
-
-                // Codon is bogus
-                if (AAT::FromCodon.find(codon) == AAT::FromCodon.cend()) continue;
-                ++coverage;
-
-                codons[codon]++;
-            }
+            const auto& codons = geneCodons[g][ri / 3].Codons;
+            const int coverage = geneCodons[g][ri / 3].Coverage;
 
             auto FindMajorityCall = [&codons]() {
                 int max = -1;
@@ -616,22 +675,15 @@ void AminoAcidCaller::CallVariants()
                 for (int j = -3; j < 6; ++j) {
                     if (i + j >= msaByRow_.BeginPos && i + j < msaByRow_.EndPos) {
                         int abs = ai + j;
-                        JSON::Json msaCounts;
-                        msaCounts["rel_pos"] = j;
-                        msaCounts["abs_pos"] = abs;
-                        msaCounts["A"] = msaByColumn_[abs][0];
-                        msaCounts["C"] = msaByColumn_[abs][1];
-                        msaCounts["G"] = msaByColumn_[abs][2];
-                        msaCounts["T"] = msaByColumn_[abs][3];
-                        msaCounts["-"] = msaByColumn_[abs][4];
-                        msaCounts["N"] = msaByColumn_[abs][5];
+                        VariantGene::VariantPosition::MsaColumn column;
+                        column.relPos = j;
+                        column.absPos = abs;
+                        column.counts = msaByColumn_[abs];
                         if (hasReference)
-                            msaCounts["wt"] =
-                                std::string(1, targetConfig_.referenceSequence.at(abs));
+                            column.wt = targetConfig_.referenceSequence.at(abs);
                         else
-                            msaCounts["wt"] = std::string(
-                                1, Data::TagToNucleotide(msaByColumn_[abs].MaxElement()));
-                        curVariantPosition->msa.push_back(msaCounts);
+                            column.wt = Data::TagToNucleotide(msaByColumn_[abs].MaxElement());
+                        curVariantPosition->msa.push_back(column);
                     }
                 }
             }
@@ -655,35 +707,209 @@ void AminoAcidCaller::CallVariants()
         variantGenes_.emplace_back(std::move(curVariantGene));
 }
 
-JSON::Json AminoAcidCaller::JSON()
+void AminoAcidCaller::WriteJson(std::ostream& out, const int indent) const
+{
+    Util::ScopedStage stage("json");
+    IO::JsonWriter json(out, indent);
+    json.BeginObject();
+    json.Key("genes").BeginArray();
+    for (const auto& v : variantGenes_)
+        if (v.HasVariantPositions()) v.WriteJson(json);
+    json.EndArray();
+    json.Key("haplotype_read_counts").BeginObject();
+    json.Member("all_damaged", margOfftarget_);
+    json.Member("healthy_low_coverage", lowCov_);
+    json.Member("healthy_reported", genCounts_);
+    json.Member("marginal_partial_reads", margPartial_);
+    json.Member("marginal_with_gaps", margWithGap_);
+    json.Member("marginal_with_heteroduplexes", margWithHetero_);
+    json.EndObject();
+    json.Key("haplotypes").BeginArray();
+    for (const auto& h : reconstructedHaplotypes_)
+        h.WriteJson(json);
+    json.EndArray();
+    json.EndObject();
+}
+
+void AminoAcidCaller::WriteHtml(std::ostream& out, const std::string& filename,
+                                const std::string& parameters, const int pageSize) const
+{
+    Util::ScopedStage stage("html");
+    HtmlReport::ReadCounts counts;
+    counts.HealthyReported = genCounts_;
+    counts.HealthyLowCoverage = lowCov_;
+    counts.AllDamaged = margOfftarget_;
+    counts.MarginalWithGaps = margWithGap_;
+    counts.MarginalWithHeteroduplexes = margWithHetero_;
+    counts.MarginalPartial = margPartial_;
+    HtmlReport(variantGenes_, reconstructedHaplotypes_, counts, targetConfig_)
+        .Write(out, filename, parameters, pageSize);
+}
+
+void AminoAcidCaller::WriteVcf(const std::string& filename, const std::string& contig) const
+{
+    WriteVcf(variantGenes_, targetConfig_, filename, contig);
+}
+
+void AminoAcidCaller::WriteVcf(const std::vector<VariantGene>& variantGenes,
+                               const TargetConfig& targetConfig, const std::string& filename,
+                               const std::string& contig)
+{
+    Util::ScopedStage stage("vcf");
+    // INFO values must not contain whitespace, semicolons, equal signs, or commas
+    const auto Sanitize = [](std::string s) {
+        for (auto& c : s) {
+            if (std::isspace(static_cast<unsigned char>(c)))
+                c = '_';
+            else if (c == ';' || c == '=' || c == ',')
+                c = '|';
+        }
+        return s;
+    };
+    const auto Number = [](const double d) {
+        char tmp[32];
+        std::snprintf(tmp, sizeof(tmp), "%g", d);
+        return std::string(tmp);
+    };
+
+    std::vector<std::string> meta{"source=juliet " + PacBio::MinorseqVersion()};
+    if (!targetConfig.referenceSequence.empty())
+        meta.emplace_back("contig=<ID=" + contig + ",length=" +
+                          std::to_string(targetConfig.referenceSequence.size()) + ">");
+    // clang-format off
+    meta.emplace_back("INFO=<ID=AF,Number=1,Type=Float,Description=\"Codon frequency\">");
+    meta.emplace_back("INFO=<ID=DP,Number=1,Type=Integer,Description=\"Codon coverage\">");
+    meta.emplace_back("INFO=<ID=PV,Number=1,Type=Float,Description=\"Bonferroni-corrected p-value\">");
+    meta.emplace_back("INFO=<ID=GENE,Number=1,Type=String,Description=\"Gene\">");
+    meta.emplace_back("INFO=<ID=AA,Number=1,Type=String,Description=\"Amino acid change, relative to the gene\">");
+    meta.emplace_back("INFO=<ID=CODON,Number=1,Type=String,Description=\"Reference and variant codon\">");
+    meta.emplace_back("INFO=<ID=DRM,Number=1,Type=String,Description=\"Known drug-resistance mutations\">");
+    // clang-format on
+    IO::VcfWriter vcf(filename, meta);
+
+    // Genes may overlap, merge their codons by reference position
+    using PositionIt = std::map<int, std::shared_ptr<VariantGene::VariantPosition>>::const_iterator;
+    std::vector<std::pair<PositionIt, const VariantGene*>> cursors;
+    for (const auto& gene : variantGenes)
+        cursors.emplace_back(gene.relPositionToVariant.cbegin(), &gene);
+    const auto CodonBegin = [](const std::pair<PositionIt, const VariantGene*>& c) {
+        return c.second->geneOffset + 3 * (c.first->first - 1);
+    };
+
+    while (true) {
+        std::pair<PositionIt, const VariantGene*>* next = nullptr;
+        for (auto& c : cursors) {
+            if (c.first == c.second->relPositionToVariant.cend()) continue;
+            if (!next || CodonBegin(c) < CodonBegin(*next)) next = &c;
+        }
+        if (!next) break;
+        const int codonBegin = CodonBegin(*next);
+        const int codonPos = next->first->first;
+        const auto& gene = *next->second;
+        const auto& variantPosition = *next->first->second;
+        ++next->first;
+        if (!variantPosition.IsVariant()) continue;
+
+        // Codons of an overlapping frame may still precede this one
+        vcf.Flush(codonBegin);
+        const std::string& refCodon = variantPosition.refCodon;
+        for (const auto& aa_varCodon : variantPosition.aminoAcidToCodons) {
+            for (const auto& codon : aa_varCodon.second) {
+                // Trim to the differing nucleotides, SNVs stay SNVs
+                size_t begin = 0;
+                size_t end = refCodon.size();
+                while (end > begin + 1 && refCodon[end - 1] == codon.codon[end - 1])
+                    --end;
+                while (begin + 1 < end && refCodon[begin] == codon.codon[begin])
+                    ++begin;
+
+                IO::VcfWriter::Record record;
+                record.Chrom = contig;
+                record.Pos = codonBegin + begin;
+                record.Ref = refCodon.substr(begin, end - begin);
+                record.Alt = codon.codon.substr(begin, end - begin);
+                record.Info = "AF=" + Number(codon.frequency) + ";DP=" +
+                              std::to_string(variantPosition.coverage) + ";PV=" +
+                              Number(codon.pValue) + ";GENE=" + Sanitize(gene.geneName) + ";AA=" +
+                              variantPosition.refAminoAcid + std::to_string(codonPos) +
+                              aa_varCodon.first + ";CODON=" + refCodon + ">" + codon.codon;
+                if (!codon.knownDRM.empty()) record.Info += ";DRM=" + Sanitize(codon.knownDRM);
+                vcf.Add(std::move(record));
+            }
+        }
+    }
+    vcf.Close();
+}
+
+AminoAcidCaller::ReportSummary AminoAcidCaller::Summary() const
 {
-    using JSON::Json;
-    Json root;
-    std::vector<Json> genes;
+    ReportSummary summary;
     for (const auto& v : variantGenes_) {
-        Json j = v.ToJson();
-        if (j.find("variant_positions") != j.cend()) genes.push_back(j);
+        for (const auto& pos_variant : v.relPositionToVariant) {
+            if (!pos_variant.second->IsVariant()) continue;
+            ++summary.NumVariantPositions;
+            for (const auto& aa_varCodon : pos_variant.second->aminoAcidToCodons)
+                for (const auto& codon : aa_varCodon.second)
+                    if (!codon.knownDRM.empty()) summary.KnownDRMs.insert(codon.knownDRM);
+        }
+    }
+    summary.NumHaplotypes = reconstructedHaplotypes_.size();
+    return summary;
+}
+
+SampleArrays AminoAcidCaller::Arrays() const
+{
+    SampleArrays arrays;
+
+    arrays.MsaBeginPos = msaByColumn_.beginPos;
+    arrays.MsaCounts.reserve(msaByColumn_.counts.size() * SampleArrays::NumNucleotides);
+    for (const auto& column : msaByColumn_)
+        arrays.MsaCounts.insert(arrays.MsaCounts.end(), column.counts.cbegin(),
+                                column.counts.cend());
+
+    size_t numCodons = 0;
+    for (const auto& codons : geneCodons_)
+        numCodons += codons.size();
+    arrays.CodonGene.reserve(numCodons);
+    arrays.CodonPos.reserve(numCodons);
+    arrays.CodonCoverage.reserve(numCodons);
+    arrays.CodonCounts.assign(numCodons * SampleArrays::NumCodons, 0);
+    size_t row = 0;
+    for (size_t g = 0; g < genes_.size(); ++g) {
+        arrays.GeneNames.push_back(genes_[g].name);
+        for (size_t c = 0; c < geneCodons_[g].size(); ++c, ++row) {
+            arrays.CodonGene.push_back(g);
+            arrays.CodonPos.push_back(genes_[g].begin + 3 * c);
+            arrays.CodonCoverage.push_back(geneCodons_[g][c].Coverage);
+            for (const auto& codon_count : geneCodons_[g][c].Codons) {
+                const int index = SampleArrays::CodonIndex(codon_count.first);
+                if (index >= 0)
+                    arrays.CodonCounts[row * SampleArrays::NumCodons + index] = codon_count.second;
+            }
+        }
     }
-    root["genes"] = genes;
-    auto HapsToJson = [](const std::vector<Haplotype>& haps) {
-        std::vector<Json> haplotypes;
-        for (const auto& h : haps) {
-            haplotypes.push_back(h.ToJson());
+
+    for (const auto& v : variantGenes_) {
+        int geneIndex = -1;
+        for (size_t g = 0; g < genes_.size(); ++g)
+            if (genes_[g].begin == v.geneOffset && genes_[g].name == v.geneName) geneIndex = g;
+        for (const auto& pos_variant : v.relPositionToVariant) {
+            const auto& variant = *pos_variant.second;
+            for (const auto& aa_varCodon : variant.aminoAcidToCodons) {
+                for (const auto& codon : aa_varCodon.second) {
+                    arrays.VariantGene.push_back(geneIndex);
+                    arrays.VariantCodonPos.push_back(pos_variant.first);
+                    arrays.VariantRefCodon.push_back(SampleArrays::CodonIndex(variant.refCodon));
+                    arrays.VariantAltCodon.push_back(SampleArrays::CodonIndex(codon.codon));
+                    arrays.VariantCoverage.push_back(variant.coverage);
+                    arrays.VariantFrequency.push_back(codon.frequency);
+                    arrays.VariantPValue.push_back(codon.pValue);
+                    arrays.VariantDRM.push_back(codon.knownDRM);
+                }
+            }
         }
-        return haplotypes;
-    };
-    root["haplotypes"] = HapsToJson(reconstructedHaplotypes_);
-    // root["haplotypes_low_counts"] = HapsToJson(lowCountHaplotypes_);
-    // root["haplotypes_filtered"] = HapsToJson(filteredHaplotypes_);
-    Json counts;
-    counts["healthy_reported"] = genCounts_;
-    counts["healthy_low_coverage"] = lowCov_;
-    counts["all_damaged"] = margOfftarget_;
-    counts["marginal_with_gaps"] = margWithGap_;
-    counts["marginal_with_heteroduplexes"] = margWithHetero_;
-    counts["marginal_partial_reads"] = margPartial_;
-    root["haplotype_read_counts"] = counts;
-    return root;
+    }
+    return arrays;
 }
 }
 }  // ::PacBio::Juliet
@@ -51,7 +51,16 @@
 namespace PacBio {
 namespace Data {
 
-ArrayRead::ArrayRead(const int idx, const std::string& name) : Idx(idx), Name(name){};
+namespace {
+Util::MemoryCounter& ReadsMemory()
+{
+    static auto& counter = Util::MemoryCounter::Get("reads");
+    return counter;
+}
+}
+
+ArrayRead::ArrayRead(const int idx, const std::string& name)
+    : Idx(idx), Name(name), memory_(ReadsMemory()){};
 
 BAMArrayRead::BAMArrayRead(const BAM::BamRecord& record, int idx)
     : ArrayRead(idx, record.FullName())
@@ -99,6 +108,10 @@ BAMArrayRead::BAMArrayRead(const BAM::BamRecord& record, int idx)
     else
         for (size_t i = 0; i < cigar.length(); ++i)
             Bases.emplace_back(cigar.at(i), seq.at(i), 0);
+
+    // Unrolled bases plus, roughly, the retained record
+    const size_t recordBytes = seq.size() * (1 + hasQualities + 3 * richQVs);
+    memory_.Set(Bases.capacity() * sizeof(ArrayBase) + Name.capacity() + recordBytes);
 }
 
 std::string ArrayRead::SequencingChemistry() const { return ""; }
@@ -37,6 +37,10 @@
 
 #include <pbbam/DataSet.h>
 
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Stats.h>
+#include <pacbio/util/ThreadPool.h>
+
 #include <pacbio/io/BamParser.h>
 
 namespace PacBio {
@@ -53,27 +57,129 @@ std::unique_ptr<BAM::internal::IQuery> BamQuery(const std::string& filePath)
     return query;
 }
 
+namespace {
+bool IsInRegion(const BAM::BamRecord& record, int regionStart, int regionEnd)
+{
+    using Util::Stat;
+    using Util::Stats;
+    if (record.Impl().IsSupplementaryAlignment()) {
+        Stats::Add(Stat::READS_SKIPPED_SUPPLEMENTARY);
+        return false;
+    }
+    if (!record.Impl().IsPrimaryAlignment()) {
+        Stats::Add(Stat::READS_SKIPPED_SECONDARY);
+        return false;
+    }
+    if (record.ReferenceStart() < regionEnd && record.ReferenceEnd() > regionStart) return true;
+    Stats::Add(Stat::READS_SKIPPED_REGION);
+    return false;
+}
+
+/// Clips and unrolls the selected records on the shared thread pool.
+std::vector<std::shared_ptr<Data::ArrayRead>> DecodeArrayReads(std::vector<BAM::BamRecord>* records,
+                                                               int regionStart, int regionEnd)
+{
+    Util::Stats::Add(Util::Stat::READS_DECODED, records->size());
+    std::vector<std::shared_ptr<Data::ArrayRead>> returnList(records->size());
+    Util::ParallelFor(0, records->size(), [&](size_t i) {
+        auto& record = records->at(i);
+        record.Clip(BAM::ClipType::CLIP_TO_REFERENCE, regionStart, regionEnd);
+        returnList[i] = std::make_shared<Data::BAMArrayRead>(record, i);
+    });
+    return returnList;
+}
+}
+
 std::vector<std::shared_ptr<Data::ArrayRead>> BamToArrayReads(const std::string& filePath,
                                                               int regionStart, int regionEnd)
 {
-    std::vector<std::shared_ptr<Data::ArrayRead>> returnList;
+    Util::ScopedStage stage("decode");
     regionStart = std::max(regionStart - 1, 0);
     regionEnd = std::max(regionEnd - 1, 0);
 
     auto query = BamQuery(filePath);
 
-    int idx = 0;
-    // Iterate over all records and convert online
-    for (auto& record : *query) {
-        if (record.Impl().IsSupplementaryAlignment()) continue;
-        if (!record.Impl().IsPrimaryAlignment()) continue;
-        if (record.ReferenceStart() < regionEnd && record.ReferenceEnd() > regionStart) {
-            record.Clip(BAM::ClipType::CLIP_TO_REFERENCE, regionStart, regionEnd);
-            returnList.emplace_back(
-                std::make_shared<Data::BAMArrayRead>(Data::BAMArrayRead(record, idx++)));
+    // Parsing is sequential, clipping and unrolling run in parallel
+    std::vector<BAM::BamRecord> records;
+    for (auto& record : *query)
+        if (IsInRegion(record, regionStart, regionEnd)) records.emplace_back(record);
+    return DecodeArrayReads(&records, regionStart, regionEnd);
+}
+
+std::map<std::string, std::vector<std::shared_ptr<Data::ArrayRead>>> BamToArrayReadsByReadGroup(
+    const std::string& filePath, int regionStart, int regionEnd)
+{
+    Util::ScopedStage stage("decode");
+    regionStart = std::max(regionStart - 1, 0);
+    regionEnd = std::max(regionEnd - 1, 0);
+
+    auto query = BamQuery(filePath);
+
+    // One parse and one parallel decode for all groups, then route by id
+    std::vector<BAM::BamRecord> records;
+    for (auto& record : *query)
+        if (IsInRegion(record, regionStart, regionEnd)) records.emplace_back(record);
+    auto reads = DecodeArrayReads(&records, regionStart, regionEnd);
+
+    std::map<std::string, std::vector<std::shared_ptr<Data::ArrayRead>>> readGroups;
+    for (size_t i = 0; i < records.size(); ++i)
+        readGroups[records[i].ReadGroupId()].emplace_back(std::move(reads[i]));
+    return readGroups;
+}
+
+void StreamArrayReads(
+    const std::string& filePath, int regionStart, int regionEnd, const size_t batchSize,
+    const std::function<void(const std::vector<std::shared_ptr<Data::ArrayRead>>&)>& f)
+{
+    regionStart = std::max(regionStart - 1, 0);
+    regionEnd = std::max(regionEnd - 1, 0);
+
+    auto query = BamQuery(filePath);
+
+    std::vector<BAM::BamRecord> records;
+    const auto Flush = [&]() {
+        std::vector<std::shared_ptr<Data::ArrayRead>> reads;
+        {
+            Util::ScopedStage stage("decode");
+            reads = DecodeArrayReads(&records, regionStart, regionEnd);
         }
+        records.clear();
+        f(reads);
+    };
+    for (auto& record : *query) {
+        if (!IsInRegion(record, regionStart, regionEnd)) continue;
+        records.emplace_back(record);
+        if (records.size() == batchSize) Flush();
     }
+    if (!records.empty()) Flush();
+}
+
+std::vector<Data::ArrayRead> RecordsToArrayReads(const std::vector<BAM::BamRecord>& records)
+{
+    Util::ScopedStage stage("decode");
+    Util::Stats::Add(Util::Stat::READS_DECODED, records.size());
+    std::vector<std::unique_ptr<Data::BAMArrayRead>> decoded(records.size());
+    Util::ParallelFor(0, records.size(),
+                      [&](size_t i) { decoded[i].reset(new Data::BAMArrayRead(records[i], i)); });
+
+    std::vector<Data::ArrayRead> returnList;
+    returnList.reserve(records.size());
+    for (auto& r : decoded)
+        returnList.emplace_back(std::move(*r));
     return returnList;
 }
+
+std::vector<std::shared_ptr<Data::ArrayRead>> BamToArrayReads(
+    const std::vector<BAM::BamRecord>& records, int regionStart, int regionEnd)
+{
+    Util::ScopedStage stage("decode");
+    regionStart = std::max(regionStart - 1, 0);
+    regionEnd = std::max(regionEnd - 1, 0);
+
+    std::vector<BAM::BamRecord> selected;
+    for (const auto& record : records)
+        if (IsInRegion(record, regionStart, regionEnd)) selected.emplace_back(record);
+    return DecodeArrayReads(&selected, regionStart, regionEnd);
+}
 }
 }  // ::PacBio::IO
@@ -0,0 +1,294 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pacbio/Version.h>
+#include <pacbio/capi/Minorseq.h>
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/AminoAcidCaller.h>
+#include <pacbio/juliet/AminoAcidTable.h>
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/SampleArrays.h>
+#include <pacbio/juliet/SampleReader.h>
+#include <pacbio/util/ThreadPool.h>
+
+using namespace PacBio;
+using AAT = PacBio::Juliet::AminoAcidTable;
+
+struct ms_config
+{
+    Juliet::JulietSettings Settings;
+};
+
+struct ms_reads
+{
+    std::vector<std::shared_ptr<Data::ArrayRead>> Reads;
+};
+
+struct ms_result
+{
+    std::unique_ptr<Juliet::AminoAcidCaller> Caller;
+    Juliet::SampleArrays Arrays;
+};
+
+namespace {
+thread_local std::string lastError;
+
+/// Runs f, converting exceptions into MS_ERROR and ms_last_error()
+template <typename F>
+ms_status Guard(F f)
+{
+    try {
+        f();
+        return MS_OK;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+    } catch (...) {
+        lastError = "Unknown error";
+    }
+    return MS_ERROR;
+}
+
+template <typename T>
+void CheckHandle(const T* handle, const char* name)
+{
+    if (handle == nullptr) throw std::runtime_error(std::string(name) + " must not be null");
+}
+
+/// Codon of each SampleArrays::CodonIndex, alive for the whole process
+const std::vector<std::string>& CodonNames()
+{
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> codons;
+        for (int i = 0; i < Juliet::SampleArrays::NumCodons; ++i)
+            codons.emplace_back(Juliet::SampleArrays::Codon(i));
+        return codons;
+    }();
+    return names;
+}
+}
+
+extern "C" {
+
+const char* ms_version(void) { return MSVersion; }
+
+const char* ms_last_error(void) { return lastError.c_str(); }
+
+ms_status ms_set_num_threads(const size_t num_threads)
+{
+    return Guard([&] { Util::ThreadPool::Configure(num_threads); });
+}
+
+ms_status ms_config_create(ms_config** config)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        *config = new ms_config;
+    });
+}
+
+void ms_config_free(ms_config* config) { delete config; }
+
+ms_status ms_config_set_target(ms_config* config, const char* target)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        CheckHandle(target, "target");
+        config->Settings.TargetConfigUser = Juliet::TargetConfig(target);
+    });
+}
+
+ms_status ms_config_set_region(ms_config* config, const int begin, const int end)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        if (begin < 0 || end < 0) throw std::runtime_error("Indexing is 1-based");
+        config->Settings.RegionStart = begin;
+        config->Settings.RegionEnd = end == 0 ? std::numeric_limits<int>::max() : end;
+    });
+}
+
+ms_status ms_config_set_mode(ms_config* config, const ms_mode mode)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        switch (mode) {
+            case MS_MODE_AMINO:
+                config->Settings.Mode = Juliet::AnalysisMode::AMINO;
+                break;
+            case MS_MODE_PHASING:
+                config->Settings.Mode = Juliet::AnalysisMode::PHASING;
+                break;
+            default:
+                throw std::runtime_error("Unknown mode " + std::to_string(mode));
+        }
+    });
+}
+
+ms_status ms_config_set_drm_only(ms_config* config, const int drm_only)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        config->Settings.DRMOnly = drm_only != 0;
+    });
+}
+
+ms_status ms_config_set_percentages(ms_config* config, const double min_perc, const double max_perc)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        if (min_perc < 0 || max_perc > 100 || min_perc > max_perc)
+            throw std::runtime_error("Percentages must satisfy 0 <= min <= max <= 100");
+        config->Settings.MinimalPerc = min_perc;
+        config->Settings.MaximalPerc = max_perc;
+    });
+}
+
+ms_status ms_config_set_error_rates(ms_config* config, const double substitution_rate,
+                                    const double deletion_rate)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        if (substitution_rate < 0 || deletion_rate < 0 || substitution_rate + deletion_rate >= 1)
+            throw std::runtime_error("Error rates must be non-negative and sum to less than 1");
+        config->Settings.SubstitutionRate = substitution_rate;
+        config->Settings.DeletionRate = deletion_rate;
+    });
+}
+
+ms_status ms_reads_create(ms_reads** reads)
+{
+    return Guard([&] {
+        CheckHandle(reads, "reads");
+        *reads = new ms_reads;
+    });
+}
+
+void ms_reads_free(ms_reads* reads) { delete reads; }
+
+ms_status ms_reads_open(ms_reads* reads, const char* bam_path, const ms_config* config)
+{
+    return Guard([&] {
+        CheckHandle(reads, "reads");
+        CheckHandle(bam_path, "bam_path");
+        CheckHandle(config, "config");
+        // Release the previous sample before decoding the next one
+        reads->Reads.clear();
+        reads->Reads =
+            IO::BamToArrayReads(bam_path, config->Settings.RegionStart, config->Settings.RegionEnd);
+    });
+}
+
+size_t ms_reads_count(const ms_reads* reads) { return reads ? reads->Reads.size() : 0; }
+
+ms_status ms_result_create(ms_result** result)
+{
+    return Guard([&] {
+        CheckHandle(result, "result");
+        *result = new ms_result;
+    });
+}
+
+void ms_result_free(ms_result* result) { delete result; }
+
+ms_status ms_call(const ms_config* config, const ms_reads* reads, ms_result* result)
+{
+    return Guard([&] {
+        CheckHandle(config, "config");
+        CheckHandle(reads, "reads");
+        CheckHandle(result, "result");
+        result->Caller.reset();
+        result->Arrays = Juliet::SampleArrays();
+        result->Caller = Juliet::SampleReader::Call(reads->Reads, config->Settings);
+        result->Arrays = result->Caller->Arrays();
+    });
+}
+
+size_t ms_result_num_variants(const ms_result* result)
+{
+    return result ? result->Arrays.NumVariants() : 0;
+}
+
+ms_status ms_result_variant(const ms_result* result, const size_t index, ms_variant* variant)
+{
+    return Guard([&] {
+        CheckHandle(result, "result");
+        CheckHandle(variant, "variant");
+        const auto& a = result->Arrays;
+        if (index >= static_cast<size_t>(a.NumVariants()))
+            throw std::runtime_error("Variant index " + std::to_string(index) + " out of range");
+
+        const auto& ref = CodonNames().at(a.VariantRefCodon[index]);
+        const auto& alt = CodonNames().at(a.VariantAltCodon[index]);
+        variant->gene = a.GeneNames.at(a.VariantGene[index]).c_str();
+        variant->codon_pos = a.VariantCodonPos[index];
+        variant->ref_codon = ref.c_str();
+        variant->alt_codon = alt.c_str();
+        variant->ref_amino_acid = AAT::FromCodon.at(ref);
+        variant->alt_amino_acid = AAT::FromCodon.at(alt);
+        variant->coverage = a.VariantCoverage[index];
+        variant->frequency = a.VariantFrequency[index];
+        variant->p_value = a.VariantPValue[index];
+        variant->known_drm = a.VariantDRM[index].c_str();
+    });
+}
+
+size_t ms_result_num_haplotypes(const ms_result* result)
+{
+    return result && result->Caller ? result->Caller->Summary().NumHaplotypes : 0;
+}
+
+ms_status ms_result_write_json(const ms_result* result, const char* path)
+{
+    return Guard([&] {
+        CheckHandle(result, "result");
+        CheckHandle(path, "path");
+        if (!result->Caller) throw std::runtime_error("No variants have been called");
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("Could not open " + std::string(path));
+        result->Caller->WriteJson(out);
+        out << std::endl;
+    });
+}
+}
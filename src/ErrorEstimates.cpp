@@ -36,34 +36,85 @@
 // Author: Armin Töpfer
 
 #include <pacbio/juliet/ErrorEstimates.h>
+#include <pacbio/juliet/ErrorModel.h>
+#include <pacbio/juliet/ErrorModelRegistry.h>
 #include <stdexcept>
 
 namespace PacBio {
 namespace Juliet {
+constexpr int ErrorEstimates::numCodons;
 
 ErrorEstimates::ErrorEstimates(const std::string& chemistry)
 {
-    match = 0.9956844883;
-    substitution = 0.0005244257 / 3.0;
-    deletion = 0.003791086;
-    insertion = 0;
-    if (chemistry != "S/P1-C1" && chemistry != "S/P1-C1.2" && chemistry != "S/P2-C2") {
-        std::cerr << "+---------------------------------------------------+" << std::endl
-                  << "|                     ATTENTION!                    |" << std::endl
-                  << "| - - - - - - - - - - - - - - - - - - - - - - - - - |" << std::endl
-                  << "|           This chemistry is unsupported.          |" << std::endl
-                  << "|            Running in permissive mode.            |" << std::endl
-                  << "|   Possibly increased type I and II error rates!   |" << std::endl
-                  << "+---------------------------------------------------+" << std::endl;
+    const auto& registry = ErrorModelRegistry::Default();
+    const auto* known = registry.Find(chemistry);
+    if (known) {
+        *this = *known;
+        return;
     }
+    *this = registry.Fallback();
+    std::cerr << "+---------------------------------------------------+" << std::endl
+              << "|                     ATTENTION!                    |" << std::endl
+              << "| - - - - - - - - - - - - - - - - - - - - - - - - - |" << std::endl
+              << "|           This chemistry is unsupported.          |" << std::endl
+              << "|            Running in permissive mode.            |" << std::endl
+              << "|   Possibly increased type I and II error rates!   |" << std::endl
+              << "+---------------------------------------------------+" << std::endl;
 }
 
 ErrorEstimates::ErrorEstimates(const double substitutionRate, const double deletionRate)
-    : match(1 - substitutionRate - deletionRate)
-    , substitution(substitutionRate / 3.0)
-    , deletion(deletionRate)
-    , insertion(0)
+    : match_(1 - substitutionRate - deletionRate)
+    , substitution_(substitutionRate / 3.0)
+    , deletion_(deletionRate)
+    , insertion_(0)
 {
+    DeriveCodonMatrix();
+}
+
+ErrorEstimates::ErrorEstimates(const double matchRate, const double substitutionRate,
+                               const double deletionRate, const double insertionRate)
+    : match_(matchRate)
+    , substitution_(substitutionRate / 3.0)
+    , deletion_(deletionRate)
+    , insertion_(insertionRate)
+{
+    DeriveCodonMatrix();
+}
+
+ErrorEstimates::ErrorEstimates(const ErrorModel& model)
+    : ErrorEstimates(1 - model.Global.Substitution - model.Global.Deletion,
+                     model.Global.Substitution, model.Global.Deletion, model.Global.Insertion)
+{
+}
+
+double ErrorEstimates::ComputeProbability(const std::string& a, const std::string& b) const
+{
+    if (a.size() != b.size()) return 0.0;
+
+    double p = 1;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == '-' || b[i] == '-')
+            p *= deletion_;
+        else if (a[i] != b[i])
+            p *= substitution_;
+        else
+            p *= match_;
+    }
+    return p;
+}
+
+void ErrorEstimates::DeriveCodonMatrix()
+{
+    static const char bases[] = "ACGT-";
+    std::vector<std::string> codons;
+    for (int i = 0; i < numCodons; ++i)
+        codons.push_back({bases[i / 25], bases[i / 5 % 5], bases[i % 5]});
+
+    std::shared_ptr<std::vector<double>> matrix(new std::vector<double>(numCodons * numCodons));
+    for (int i = 0; i < numCodons; ++i)
+        for (int j = 0; j < numCodons; ++j)
+            (*matrix)[i * numCodons + j] = ComputeProbability(codons[i], codons[j]);
+    codons_ = matrix;
 }
 }
 }
\ No newline at end of file
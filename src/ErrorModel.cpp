@@ -0,0 +1,402 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/data/QvThresholds.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/io/JsonWriter.h>
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Stats.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/juliet/ErrorModel.h>
+
+namespace PacBio {
+namespace Juliet {
+constexpr int ErrorModel::Version;
+constexpr int ErrorModel::MaxHomopolymer;
+constexpr int ErrorModel::MinCoverage;
+
+namespace {
+// Reads held in memory at a time, per input
+const size_t batchSize = 4096;
+
+/// Base counts of one column, indexed like NucleotideToTag
+struct ColumnCounts
+{
+    std::array<int64_t, 6> Bases{{0, 0, 0, 0, 0, 0}};
+    int64_t Insertions = 0;
+
+    int64_t Coverage() const
+    {
+        int64_t coverage = 0;
+        for (const auto& b : Bases)
+            coverage += b;
+        return coverage;
+    }
+};
+
+/// Adds reads to columns, which start at reference position 0. Bases are
+/// masked by the QV thresholds like in MSAByRow.
+void CountReads(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads,
+                const Data::QvThresholds& qvThresholds, std::vector<ColumnCounts>* columns)
+{
+    Util::ScopedStage stage("count_errors");
+    int numColumns = columns->size();
+    for (const auto& r : reads)
+        numColumns = std::max(numColumns, r->ReferenceEnd());
+    columns->resize(numColumns);
+
+    // Every chunk counts into its own columns, merged once per chunk
+    std::mutex mutex;
+    Util::ParallelForRange(0, reads.size(), [&](size_t chunkBegin, size_t chunkEnd) {
+        int begin = std::numeric_limits<int>::max();
+        int end = 0;
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            begin = std::min(begin, reads[i]->ReferenceStart());
+            end = std::max(end, reads[i]->ReferenceEnd());
+        }
+        if (begin >= end) return;
+
+        std::vector<ColumnCounts> local(end - begin);
+        uint64_t failingQv = 0;
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            int pos = reads[i]->ReferenceStart() - begin;
+            bool insertion = false;
+            const auto CheckInsertion = [&]() {
+                if (insertion && pos < static_cast<int>(local.size())) ++local[pos].Insertions;
+                insertion = false;
+            };
+            for (const auto& b : reads[i]->Bases) {
+                switch (b.Cigar) {
+                    case 'X':
+                    case '=': {
+                        CheckInsertion();
+                        uint8_t tag = 5;
+                        if (b.MeetQVThresholds(qvThresholds))
+                            tag = Data::NucleotideToTag(b.Nucleotide);
+                        else
+                            ++failingQv;
+                        if (tag > 5)
+                            throw std::runtime_error("Unexpected base " +
+                                                     std::string(1, b.Nucleotide));
+                        ++local[pos++].Bases[tag];
+                        break;
+                    }
+                    case 'D':
+                        CheckInsertion();
+                        ++local[pos++].Bases[4];
+                        break;
+                    case 'I':
+                        insertion = true;
+                        break;
+                    case 'P':
+                    case 'S':
+                        CheckInsertion();
+                        break;
+                    default:
+                        throw std::runtime_error("Unexpected cigar " + std::to_string(b.Cigar));
+                }
+            }
+        }
+        Util::Stats::Add(Util::Stat::BASES_FAILING_QV, failingQv);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t j = 0; j < local.size(); ++j) {
+            auto& column = (*columns)[begin + j];
+            for (int k = 0; k < 6; ++k)
+                column.Bases[k] += local[j].Bases[k];
+            column.Insertions += local[j].Insertions;
+        }
+    });
+}
+
+void Add(const PositionErrorRates& p, ErrorRates* rates)
+{
+    ++rates->Columns;
+    rates->Substitution += p.Substitution;
+    rates->Deletion += p.Deletion;
+    rates->Insertion += p.Insertion;
+}
+
+void Normalize(ErrorRates* rates)
+{
+    if (rates->Columns == 0) return;
+    rates->Substitution /= rates->Columns;
+    rates->Deletion /= rates->Columns;
+    rates->Insertion /= rates->Columns;
+}
+
+void WriteRates(const ErrorRates& rates, IO::JsonWriter* json)
+{
+    json->Member("columns", rates.Columns);
+    json->Member("substitution", rates.Substitution);
+    json->Member("deletion", rates.Deletion);
+    json->Member("insertion", rates.Insertion);
+}
+
+void AddChemistries(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads,
+                    std::set<std::string>* chemistries)
+{
+    for (const auto& r : reads)
+        chemistries->insert(r->SequencingChemistry());
+}
+
+std::string Join(const std::set<std::string>& chemistries)
+{
+    std::string joined;
+    for (const auto& c : chemistries)
+        joined += (joined.empty() ? "" : ",") + c;
+    return joined;
+}
+
+/// Derives all rates of model from the counted columns
+void Finish(const std::vector<ColumnCounts>& columns, ErrorModel* model)
+{
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const auto& c = columns[i];
+        const int64_t coverage = c.Coverage();
+        if (coverage == 0) continue;
+        const int maxElement =
+            std::distance(c.Bases.cbegin(), std::max_element(c.Bases.cbegin(), c.Bases.cend()));
+        const int64_t matches = maxElement == 4 ? 0 : c.Bases[maxElement];
+
+        PositionErrorRates p;
+        p.RefPos = i + 1;
+        p.Consensus = Data::TagToNucleotide(maxElement);
+        p.Coverage = coverage;
+        p.Substitution = static_cast<double>(coverage - matches - c.Bases[4]) / coverage;
+        p.Deletion = static_cast<double>(c.Bases[4]) / coverage;
+        p.Insertion = static_cast<double>(c.Insertions) / coverage;
+        model->Positions.emplace_back(p);
+        if (coverage > ErrorModel::MinCoverage) {
+            auto global = p;
+            global.Substitution =
+                static_cast<double>(coverage - c.Bases[maxElement] - c.Bases[4]) / coverage;
+            Add(global, &model->Global);
+        }
+    }
+
+    // Contexts are defined on the consensus, gap and N columns are skipped
+    std::vector<const PositionErrorRates*> sequence;
+    for (const auto& p : model->Positions)
+        if (p.Consensus != '-' && p.Consensus != 'N') sequence.emplace_back(&p);
+    for (size_t runBegin = 0; runBegin < sequence.size();) {
+        size_t runEnd = runBegin + 1;
+        while (runEnd < sequence.size() &&
+               sequence[runEnd]->Consensus == sequence[runBegin]->Consensus)
+            ++runEnd;
+        const int length = std::min<int>(runEnd - runBegin, ErrorModel::MaxHomopolymer);
+        for (size_t k = runBegin; k < runEnd; ++k) {
+            const auto& p = *sequence[k];
+            if (p.Coverage <= ErrorModel::MinCoverage) continue;
+            Add(p, &model->Homopolymers[length]);
+            if (k == 0 || k + 1 == sequence.size()) continue;
+            const std::string context{sequence[k - 1]->Consensus, p.Consensus,
+                                      sequence[k + 1]->Consensus};
+            Add(p, &model->Trinucleotides[context]);
+        }
+        runBegin = runEnd;
+    }
+
+    Normalize(&model->Global);
+    for (auto& h : model->Homopolymers)
+        Normalize(&h.second);
+    for (auto& t : model->Trinucleotides)
+        Normalize(&t.second);
+}
+
+ErrorRates ReadRates(const JSON::Json& json)
+{
+    ErrorRates rates;
+    rates.Columns = json.at("columns").get<int64_t>();
+    rates.Substitution = json.at("substitution").get<double>();
+    rates.Deletion = json.at("deletion").get<double>();
+    rates.Insertion = json.at("insertion").get<double>();
+    return rates;
+}
+}
+
+ErrorModel ErrorModel::Estimate(const std::string& filePath, int regionStart, int regionEnd)
+{
+    ErrorModel model;
+    model.Input = filePath;
+
+    const Data::QvThresholds qvThresholds;
+    std::vector<ColumnCounts> columns;
+    std::set<std::string> chemistries;
+    IO::StreamArrayReads(filePath, regionStart, regionEnd, batchSize,
+                         [&](const std::vector<std::shared_ptr<Data::ArrayRead>>& reads) {
+                             AddChemistries(reads, &chemistries);
+                             model.NumReads += reads.size();
+                             CountReads(reads, qvThresholds, &columns);
+                         });
+    if (model.NumReads == 0) throw std::runtime_error("Empty input " + filePath);
+
+    model.Chemistry = Join(chemistries);
+    Finish(columns, &model);
+    return model;
+}
+
+ErrorModel ErrorModel::Estimate(const std::vector<std::shared_ptr<Data::ArrayRead>>& reads)
+{
+    ErrorModel model;
+    std::set<std::string> chemistries;
+    AddChemistries(reads, &chemistries);
+    model.Chemistry = Join(chemistries);
+    model.NumReads = reads.size();
+
+    std::vector<ColumnCounts> columns;
+    CountReads(reads, Data::QvThresholds(), &columns);
+    Finish(columns, &model);
+    return model;
+}
+
+ErrorModel ErrorModel::Load(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in) throw std::runtime_error("Could not open error model " + filename);
+
+    ErrorModel model;
+    try {
+        const auto root = JSON::Json::parse(in);
+        if (root.at("version").get<int>() != Version)
+            throw std::runtime_error("unsupported version");
+        model.Chemistry = root.at("chemistry").get<std::string>();
+        model.Input = root.at("input").get<std::string>();
+        model.NumReads = root.at("num_reads").get<int64_t>();
+        model.Global = ReadRates(root.at("global"));
+        for (const auto& h : root.at("homopolymers"))
+            model.Homopolymers[h.at("length").get<int>()] = ReadRates(h);
+        for (const auto& t : root.at("trinucleotides"))
+            model.Trinucleotides[t.at("context").get<std::string>()] = ReadRates(t);
+
+        const auto& positions = root.at("positions");
+        const auto& refPos = positions.at("pos");
+        const auto consensus = positions.at("consensus").get<std::string>();
+        const auto& coverage = positions.at("coverage");
+        const auto& substitution = positions.at("substitution");
+        const auto& deletion = positions.at("deletion");
+        const auto& insertion = positions.at("insertion");
+        for (size_t i = 0; i < refPos.size(); ++i)
+            model.Positions.push_back(
+                {refPos.at(i).get<int>(), consensus.at(i), coverage.at(i).get<int64_t>(),
+                 substitution.at(i).get<double>(), deletion.at(i).get<double>(),
+                 insertion.at(i).get<double>()});
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Could not read error model " + filename + ": " + e.what());
+    }
+    return model;
+}
+
+void ErrorModel::WriteJson(std::ostream& out) const
+{
+    // Compact, the positions alone are six values per reference base
+    IO::JsonWriter json(out, -1);
+    json.BeginObject();
+    json.Member("version", Version);
+    json.Member("chemistry", Chemistry);
+    json.Member("input", Input);
+    json.Member("num_reads", NumReads);
+    json.Member("min_coverage", MinCoverage);
+    json.Key("global").BeginObject();
+    WriteRates(Global, &json);
+    json.EndObject();
+
+    json.Key("homopolymers").BeginArray();
+    for (const auto& h : Homopolymers) {
+        json.BeginObject();
+        json.Member("length", h.first);
+        WriteRates(h.second, &json);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.Key("trinucleotides").BeginArray();
+    for (const auto& t : Trinucleotides) {
+        json.BeginObject();
+        json.Member("context", t.first);
+        WriteRates(t.second, &json);
+        json.EndObject();
+    }
+    json.EndArray();
+
+    // Column-wise, one array per field
+    std::vector<int> refPos;
+    std::string consensus;
+    std::vector<int64_t> coverage;
+    std::vector<double> substitution;
+    std::vector<double> deletion;
+    std::vector<double> insertion;
+    for (const auto& p : Positions) {
+        refPos.push_back(p.RefPos);
+        consensus += p.Consensus;
+        coverage.push_back(p.Coverage);
+        substitution.push_back(p.Substitution);
+        deletion.push_back(p.Deletion);
+        insertion.push_back(p.Insertion);
+    }
+    json.Key("positions").BeginObject();
+    json.Member("pos", refPos);
+    json.Member("consensus", consensus);
+    json.Member("coverage", coverage);
+    json.Member("substitution", substitution);
+    json.Member("deletion", deletion);
+    json.Member("insertion", insertion);
+    json.EndObject();
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+
+void ErrorModel::WriteJson(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    if (!out) throw std::runtime_error("Could not open error model " + filename);
+    WriteJson(out);
+}
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,128 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+#include <pacbio/juliet/ErrorModel.h>
+
+#include <pacbio/juliet/ErrorModelRegistry.h>
+
+namespace PacBio {
+namespace Juliet {
+constexpr int ErrorModelRegistry::Version;
+constexpr const char* ErrorModelRegistry::EnvironmentVariable;
+
+namespace {
+// Substitution rates are summed over the three alternative bases
+const char* builtinRegistry = R"({
+    "version": 1,
+    "fallback": "S/P2-C2",
+    "chemistries": [
+        {"chemistry": "S/P1-C1", "match": 0.9956844883, "substitution": 0.0005244257,
+         "deletion": 0.003791086, "insertion": 0},
+        {"chemistry": "S/P1-C1.2", "match": 0.9956844883, "substitution": 0.0005244257,
+         "deletion": 0.003791086, "insertion": 0},
+        {"chemistry": "S/P2-C2", "match": 0.9956844883, "substitution": 0.0005244257,
+         "deletion": 0.003791086, "insertion": 0}
+    ]
+})";
+}
+
+ErrorModelRegistry::ErrorModelRegistry() { Add(JSON::Json::parse(builtinRegistry), ""); }
+
+const ErrorModelRegistry& ErrorModelRegistry::Default()
+{
+    static const ErrorModelRegistry registry = []() {
+        ErrorModelRegistry r;
+        const char* path = std::getenv(EnvironmentVariable);
+        if (path != nullptr && *path != '\0') r.Load(path);
+        return r;
+    }();
+    return registry;
+}
+
+void ErrorModelRegistry::Load(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in) throw std::runtime_error("Could not open error model registry " + filename);
+
+    const auto slash = filename.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "" : filename.substr(0, slash + 1);
+    try {
+        Add(JSON::Json::parse(in), directory);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Could not read error model registry " + filename + ": " +
+                                 e.what());
+    }
+}
+
+void ErrorModelRegistry::Add(const JSON::Json& root, const std::string& directory)
+{
+    if (root.at("version").get<int>() != Version) throw std::runtime_error("unsupported version");
+
+    for (const auto& c : root.at("chemistries")) {
+        ErrorEstimates estimates;
+        if (c.count("model")) {
+            auto path = c.at("model").get<std::string>();
+            if (!path.empty() && path.front() != '/') path = directory + path;
+            estimates = ErrorEstimates(ErrorModel::Load(path));
+        } else {
+            const double substitution = c.at("substitution").get<double>();
+            const double deletion = c.at("deletion").get<double>();
+            const double insertion = c.count("insertion") ? c.at("insertion").get<double>() : 0;
+            const double match = c.count("match") ? c.at("match").get<double>()
+                                                  : 1 - substitution - deletion - insertion;
+            estimates = ErrorEstimates(match, substitution, deletion, insertion);
+        }
+        entries_[c.at("chemistry").get<std::string>()] = std::move(estimates);
+    }
+    if (root.count("fallback")) fallback_ = root.at("fallback").get<std::string>();
+    if (!entries_.count(fallback_))
+        throw std::runtime_error("unknown fallback chemistry " + fallback_);
+}
+
+const ErrorEstimates* ErrorModelRegistry::Find(const std::string& chemistry) const
+{
+    const auto it = entries_.find(chemistry);
+    return it == entries_.cend() ? nullptr : &it->second;
+}
+
+const ErrorEstimates& ErrorModelRegistry::Fallback() const { return entries_.at(fallback_); }
+}
+}  // ::PacBio::Juliet
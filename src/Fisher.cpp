@@ -5,12 +5,14 @@
 #include <float.h>
 #include <math.h>
 #include <pacbio/statistics/Fisher.h>
+#include <pacbio/util/Stats.h>
 #include <stdio.h>
 
 namespace PacBio {
 namespace Statistics {
 double Fisher::fisher_exact_tiss(int chi11, int chi12, int chi21, int chi22)
 {
+    Util::Stats::Add(Util::Stat::FISHER_TESTS);
     int co_occ = chi11;
 
     const int gene_a = chi11 + chi12;
@@ -0,0 +1,1159 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <pbbam/DataSet.h>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/io/JsonWriter.h>
+#include <pacbio/juliet/HtmlReport.h>
+#include <pacbio/util/Profiler.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace {
+/// Percentage with two significant digits, as shown in the report
+double SignificantPercent(double fOrig)
+{
+    double fTmp;
+    int exp = 0;
+    do {
+        fTmp = fOrig * std::pow(10, ++exp);
+    } while (static_cast<int>(fTmp) < 10);
+    fOrig = static_cast<int>(fOrig * std::pow(10, exp));
+    fOrig /= std::pow(10, exp - 2);
+    return fOrig;
+}
+
+/// Haplotype column colors, repeated for more haplotypes
+const std::vector<std::string>& HaplotypeColors()
+{
+    static const std::vector<std::string> colors = {"#ea3c1c", "#f48e00", "#ebff0a", "#56e400",
+                                                    "#51c6ff", "#4a80ff", "#ae37ff", "#db005f"};
+    return colors;
+}
+
+/// Removes leading and trailing blanks and collapses inner runs of blanks
+std::string TrimBlanks(const std::string& s)
+{
+    std::string result;
+    result.reserve(s.size());
+    for (const char c : s) {
+        if (c == ' ' && (result.empty() || result.back() == ' ')) continue;
+        result.push_back(c);
+    }
+    if (!result.empty() && result.back() == ' ') result.pop_back();
+    return result;
+}
+
+Util::MemoryCounter& HtmlMemory()
+{
+    static auto& counter = Util::MemoryCounter::Get("html");
+    return counter;
+}
+}
+
+/// Append-only view on the preallocated output, formats numbers like an
+/// std::ostream with default flags.
+class HtmlReport::Buffer
+{
+public:
+    explicit Buffer(size_t capacity) : memory_(HtmlMemory())
+    {
+        data_.reserve(capacity);
+        memory_.Set(data_.capacity());
+    }
+
+    Buffer& operator<<(const char* s)
+    {
+        data_.append(s);
+        return *this;
+    }
+    Buffer& operator<<(const std::string& s)
+    {
+        data_.append(s);
+        return *this;
+    }
+    Buffer& operator<<(const char c)
+    {
+        data_.push_back(c);
+        return *this;
+    }
+    Buffer& operator<<(const double d)
+    {
+        char tmp[32];
+        const int n = std::snprintf(tmp, sizeof(tmp), "%g", d);
+        data_.append(tmp, n);
+        return *this;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, Buffer&>::type operator<<(const T i)
+    {
+        data_.append(std::to_string(i));
+        return *this;
+    }
+
+    std::string& Data()
+    {
+        memory_.Set(data_.capacity());
+        return data_;
+    }
+
+private:
+    std::string data_;
+    /// Accounted to the "html" subsystem of the profile
+    Util::TrackedBytes memory_;
+};
+
+HtmlReport::HtmlReport(const std::vector<VariantGene>& genes,
+                       const std::vector<Haplotype>& haplotypes, const ReadCounts& counts,
+                       const TargetConfig& config)
+    : haplotypes_(haplotypes), counts_(counts), config_(config)
+{
+    for (const auto& gene : genes)
+        if (gene.HasVariantPositions()) genes_.push_back(&gene);
+}
+
+int HtmlReport::CountNumHaplotypes() const
+{
+    int i = -1;
+    for (const auto gene : genes_) {
+        for (const auto& pos_variant : gene->relPositionToVariant) {
+            for (const auto& aa_varCodon : pos_variant.second->aminoAcidToCodons) {
+                for (const auto& codon : aa_varCodon.second) {
+                    const int tmp = codon.haplotypeHit.size();
+                    if (i == -1)
+                        i = tmp;
+                    else if (i != tmp)
+                        throw std::runtime_error("Different number of haplotypes.");
+                }
+            }
+        }
+    }
+    return i;
+}
+
+size_t HtmlReport::EstimateSize(const int pageSize) const
+{
+    // Static head and legend, plus one row and one MSA table per codon. Paged
+    // reports only carry the compact data blob.
+    const bool paged = pageSize > 0;
+    size_t size = 32 * 1024;
+    for (const auto gene : genes_) {
+        size += 1024 + 96 * haplotypes_.size();
+        for (const auto& pos_variant : gene->relPositionToVariant) {
+            const size_t msaSize = pos_variant.second->msa.size();
+            if (paged) size += 32 + 24 * msaSize;
+            for (const auto& aa_varCodon : pos_variant.second->aminoAcidToCodons) {
+                const size_t perCodon = paged ? 48 + 4 * haplotypes_.size()
+                                              : 768 + 160 * msaSize + 16 * haplotypes_.size();
+                size += perCodon * aa_varCodon.second.size();
+            }
+        }
+    }
+    return size;
+}
+
+void HtmlReport::DRMView(Buffer& out) const
+{
+    std::map<std::string, std::string> geneStart;
+    for (const auto& targetGene : config_.targetGenes) {
+        geneStart[targetGene.name] = std::to_string(targetGene.begin);
+    }
+
+    struct VariantDRM
+    {
+        char refAA;
+        int refPos;
+        char curAA;
+        double frequency;
+    };
+    std::map<std::string, std::map<std::string, std::vector<VariantDRM>>> drmsWithVariants;
+    for (const auto gene : genes_) {
+        const std::string key = geneStart[gene->geneName] + "|" + gene->geneName;
+        for (const auto& pos_variant : gene->relPositionToVariant) {
+            const auto& variantPosition = *pos_variant.second;
+            for (const auto& aa_varCodon : variantPosition.aminoAcidToCodons) {
+                for (const auto& codon : aa_varCodon.second) {
+                    if (codon.knownDRM.empty()) continue;
+                    size_t begin = 0;
+                    while (begin <= codon.knownDRM.size()) {
+                        size_t end = codon.knownDRM.find('+', begin);
+                        if (end == std::string::npos) end = codon.knownDRM.size();
+                        VariantDRM v;
+                        v.refAA = variantPosition.refAminoAcid;
+                        v.refPos = pos_variant.first;
+                        v.curAA = aa_varCodon.first;
+                        v.frequency = codon.frequency;
+                        drmsWithVariants[TrimBlanks(codon.knownDRM.substr(begin, end - begin))][key]
+                            .emplace_back(v);
+                        begin = end + 1;
+                    }
+                }
+            }
+        }
+    }
+    if (drmsWithVariants.empty()) {
+        out << "No known drug-resistance mutations present.\n";
+        return;
+    }
+    size_t geneWidth = 0;
+    for (const auto& targetGene : config_.targetGenes) {
+        geneWidth = std::max(targetGene.name.size(), geneWidth);
+    }
+    geneWidth *= 8;
+    size_t drugWidth = 0;
+    for (const auto& a : drmsWithVariants) {
+        drugWidth = std::max(a.first.size(), drugWidth);
+    }
+    drugWidth *= 10;
+    out << "<table class=\"drmview\">\n";
+    // clang-format off
+    out << "<tr><th colspan=2></th><th colspan=2 style=\"border-right: 1px dashed black\">Reference</th><th colspan=2>Sample</th></tr>";
+    out << "<tr><th>Drug</th><th>Gene</th><th>AA</th><th style=\"border-right: 1px dashed black\">Pos</th><th>AA</th><th>%</th></tr>";
+    // clang-format on
+    for (const auto& a : drmsWithVariants) {
+        size_t numRow = 0;
+        for (const auto& b : a.second)
+            numRow += b.second.size();
+        std::string drug = a.first;
+        Encode(drug);
+        out << "<tr><td rowspan=\"" << numRow << "\" class=\"gene\" style=\"width:" << drugWidth
+            << "px\">" << drug << "</td>\n";
+        bool firstInDrug = true;
+        for (const auto& b : a.second) {
+
+            const char* drugSuffix = "";
+            if (!firstInDrug)
+                out << "<tr>";
+            else
+                drugSuffix = "First";
+
+            const auto idx = b.first.find_first_of('|');
+            out << "<td rowspan=\"" << b.second.size() << "\" class=\"drug" << drugSuffix
+                << "\" style=\"width:" << geneWidth << "px\">" << b.first.substr(idx + 1)
+                << "</td>\n";
+            bool firstInGene = true;
+            for (const auto& c : b.second) {
+                const char* classSuffix = "";
+                if (!firstInGene) out << "<tr>";
+                if (firstInDrug)
+                    classSuffix = "FirstDrug";
+                else if (firstInGene)
+                    classSuffix = "FirstGene";
+                out << "<td class=\"refaa" << classSuffix << "\">" << c.refAA << "</td>";
+                out << "<td class=\"refpos" << classSuffix << "\">" << c.refPos << "</td>";
+                out << "<td class=\"curaa" << classSuffix << "\">" << c.curAA << "</td>";
+                out << "<td class=\"freq" << classSuffix << "\">" << SignificantPercent(c.frequency)
+                    << "</td>";
+                out << "</tr>";
+                firstInDrug = false;
+                firstInGene = false;
+            }
+            firstInDrug = false;
+        }
+    }
+    out << "</table>\n";
+}
+
+void HtmlReport::Encode(std::string& data)
+{
+    std::string buffer;
+    buffer.reserve(data.size());
+    for (size_t pos = 0; pos != data.size(); ++pos) {
+        switch (data[pos]) {
+            case '&':
+                buffer.append("&amp;");
+                break;
+            case '\"':
+                buffer.append("&quot;");
+                break;
+            case '\'':
+                buffer.append("&apos;");
+                break;
+            case '<':
+                buffer.append("&lt;");
+                break;
+            case '>':
+                buffer.append("&gt;");
+                break;
+            default:
+                buffer.append(&data[pos], 1);
+                break;
+        }
+    }
+    data.swap(buffer);
+}
+
+void HtmlReport::Write(std::ostream& out, std::string filename, std::string parameters,
+                       const int pageSize) const
+{
+    const std::string html = Render(std::move(filename), std::move(parameters), pageSize);
+    out.write(html.data(), html.size());
+}
+
+std::string HtmlReport::Render(std::string filename, std::string parameters,
+                               const int pageSize) const
+{
+    if (pageSize < 0) throw std::runtime_error("HTML page size must not be negative");
+    Encode(filename);
+    Encode(parameters);
+    const int numHaplotypes = CountNumHaplotypes();
+
+    Buffer out(EstimateSize(pageSize));
+
+    out << "<!-- Juliet Minor Variant Summary by Dr. Armin Toepfer (Pacific Biosciences) -->"
+        << '\n'
+        << "<html>" << '\n'
+        << "<head>" << '\n';
+    // Paged reports render rows on demand and bring their own handlers
+    if (pageSize == 0)
+        out << R"(
+            <script src="http://ajax.googleapis.com/ajax/libs/jquery/1.11.1/jquery.min.js"></script>
+            <script type="text/javascript">
+            $(document).ready(function() {
+                $(".var").bind( "click", function( event ) {
+                    $(this).next().slideToggle(0);
+            });
+            });
+            </script>)"
+            << '\n';
+    out << "<style>" << '\n'
+        << R"(
+        *,
+        *:before,
+        *:after {
+            -moz-box-sizing: border-box;
+            -webkit-box-sizing: border-box;
+            box-sizing: border-box;
+        }
+
+        html {
+            font-family: Helvetica, Arial, sans-serif;
+            font-size: 100%;
+            background: #fff;
+            -webkit-font-smoothing: antialiased;
+        }
+
+        details {
+            border-radius: 5px;
+            border-left: 2px solid black;
+        }
+
+        summary {
+            border-radius: 3px;
+            padding: 5px 10px;
+            outline: none;
+            font-weight: bold;
+        }
+
+        /* Tooltip container */
+        .tooltip {
+            position: relative;
+            display: inline-block;
+        }
+
+        /* Tooltip text */
+        .tooltip .tooltiptext, .tooltip .tooltiptextlarge {
+            visibility: hidden;
+            width: 50px;
+            border: 1px dotted #2d2d2d;
+            color: black;
+            text-align: center;
+            padding: 5px 0;
+            border-radius: 6px;
+            background-color: white;
+
+            bottom: 100%;
+            left: 50%;
+            margin-left: -25px;
+
+            /* Position the tooltip text - see examples below! */
+            position: absolute;
+            z-index: 1;
+        }
+
+        /* Show the tooltip text when you mouse over the tooltip container */
+        .tooltip:hover .tooltiptext, .tooltip:hover .tooltiptextlarge {
+            visibility: visible;
+        }
+
+        .tooltip .tooltiptextlarge {
+            width: 380px;
+            margin-left: -190px;
+            align:center;
+        }
+
+        table.hapcounts {
+            margin-left: auto;
+            margin-right: auto;
+        }
+
+        table.discovery {
+            border-collapse: collapse;
+            margin-bottom: 5px;
+        }
+
+        table.discovery>tbody>tr:nth-child(1),
+        table.msacounts>tbody>tr:nth-child(1) {
+            background-color: #3d3d3d;
+            color: white;
+        }
+
+        table.discovery tr:nth-child(3):not(.msa) th {
+            padding: 5px 5px 5px 5px;
+            text-align: center;
+            border-bottom: 1px solid #2d2d2d;
+        }
+
+        table.discovery tr:nth-child(2):not(.msa) th:nth-child(2) {
+            border-left: 1px dashed black;
+        }
+
+        table.discovery tr:nth-child(3):not(.msa) th:nth-child(3) {
+            border-right: 1px dashed black;
+        })";
+    if (numHaplotypes)
+        out << R"(
+        table.discovery tr:nth-child(2):not(.msa) th:nth-child(2) {
+            border-right: 1px dashed black;
+        })";
+
+    out << R"(
+        table.discovery tr:nth-child(3):not(.msa) th:nth-child(9) {
+            border-left: 1px dashed black;
+        }
+
+        table.discovery tr.var td {
+            padding: 15px 5px 15px 5px;
+            text-align: center;
+            border-bottom: 1px solid white;
+        }
+
+        table.discovery tr.var td:nth-child(1) {
+            background-color: #ddd;
+            border-right: 1px solid #eee;
+        }
+
+        table.discovery tr.var td:nth-child(2) {
+            background-color: #eee;
+            border-right: 1px solid #ddd;
+        }
+
+        table.discovery tr.var td:nth-child(3) {
+            background-color: #fff;
+            border-right: 1px solid #ddd;
+            font-weight: bold;
+        }
+
+        table.discovery tr.var td:nth-child(4) {
+            background-color: #eee;
+            border-right: 1px dashed #ccc;
+        }
+
+        table.discovery tr.var td:nth-child(5) {
+            background-color: #ddd;
+            border-right: 1px dashed #bbb;
+        }
+
+        table.discovery tr.var td:nth-child(6) {
+            background-color: #ccc;
+            border-right: 1px dashed #aaa;
+        }
+
+        table.discovery tr.var td:nth-child(7) {
+            background-color: #bbb;
+        }
+
+        table.discovery tr.var td:nth-child(8) {
+            background-color: #aaa;
+            color: white
+        }
+
+        table.discovery tr.var td:nth-child(8) {
+            border-right: 1px solid white;
+        }
+
+        table.discovery tr.var td:nth-child(n+9) {
+            border-left: 1px dotted white;
+        }
+
+        table.discovery tr.var td:nth-child(n+9) {
+            background-color: #4a4a4a;
+        }
+
+        table.discovery tr.var:hover td {
+            background-color: white;
+        }
+
+        table.discovery tr.var:hover td:nth-child(8) {
+            color: purple;
+        }
+
+        table.discovery tr.msa table tr:hover td {
+            background-color: gray;
+            color: white;
+        }
+
+        table.discovery tr.msa table {
+            border-collapse: collapse;
+            background-color: white;
+            border: 0;
+        }
+
+        table.discovery tr.msa table td {
+            background-color: white;
+            text-align: center;
+            padding: 15px 5px 15px 5px;
+            border: 0;
+            border-bottom: 1px solid gray;
+            font-weight: normal
+        }
+
+        table.discovery tr.msa table tr {
+            border: 0;
+        }
+
+        table.discovery tr.msa table th {
+            border: 0;
+        }
+
+        .msa {
+            display: none;
+        })";
+    out << R"(
+        table.drmview {
+            border-collapse: collapse;
+            margin-bottom: 20px;
+            min-width: 200px;
+            text-align: center;
+            margin-left: 20px;
+        }
+
+        table.drmview td {
+            padding: 15px;
+        }
+
+        table.drmview td.gene {
+            border-top: 3px solid white;
+            background-color: #b50937;
+            color:white;
+            vertical-align:top;
+            font-weight: bold;
+        }
+
+        table.drmview td.drug, table.drmview td.drugFirst {
+            border-top: 1px dashed white;
+            background-color: #2d2d2d;
+            color:white;
+            vertical-align:top;
+        }
+
+        table.drmview td.drugFirst {
+            border-top: 3px solid white;
+        }
+
+        table.drmview td.refaa, table.drmview td.refaaFirstDrug, table.drmview td.refaaFirstGene {
+            background-color: #bbb;
+            border-right: 1px solid #ddd;
+        }
+        table.drmview td.refaaFirstDrug {
+            border-top: 3px solid white;
+        }
+        table.drmview td.refaaFirstGene {
+            border-top: 1px dashed white;
+        }
+
+        table.drmview td.refpos, table.drmview td.refposFirstDrug, table.drmview td.refposFirstGene {
+            background-color: #ccc;
+            border-right: 1px solid #ddd;
+        }
+        table.drmview td.refposFirstDrug {
+            border-top: 3px solid white;
+        }
+        table.drmview td.refposFirstGene {
+            border-top: 1px dashed white;
+        }
+
+        table.drmview td.curaa, table.drmview td.curaaFirstDrug, table.drmview td.curaaFirstGene {
+            background-color: #ddd;
+            border-right: 1px dashed #ccc;
+        }
+        table.drmview td.curaaFirstDrug {
+            border-top: 3px solid white;
+        }
+        table.drmview td.curaaFirstGene {
+            border-top: 1px dashed white;
+        }
+
+        table.drmview td.freq, table.drmview td.freqFirstDrug, table.drmview td.freqFirstGene {
+            background-color: #eee;
+        }
+        table.drmview td.freqFirstDrug {
+            border-top: 3px solid white;
+        }
+        table.drmview td.freqFirstGene {
+            border-top: 1px dashed white;
+        })"
+        << '\n'
+        << "</style>" << '\n'
+        << "</head>" << '\n'
+        << R"(<body>
+            <h1 style="margin-top:5px">Minor Variants Summary (Juliet)</h1>
+            <details style="margin-bottom: 20px">
+            <summary>Input data</summary>
+            <div style="margin-left:20px; padding-top: 10px">)";
+    out << "<table>";
+    out << "<tr><td>Timestamp:</td><td><code>" << BAM::ToIso8601(std::chrono::system_clock::now())
+        << "</code></td></tr>";
+    out << "<tr><td>Input File:</td><td><code>" << filename << "</td></tr>";
+    out << R"(<tr><td>Command Line Call:</td><td><code>)";
+    if (parameters.empty())
+        out << "Invoked from SMRTLink, please check SMRTLink logs for parameters";
+    else
+        out << parameters;
+    out << "</td></tr>"
+        << R"(<tr><td>Juliet Version:</td><td><code>)" << PacBio::MinorseqVersion() << " (commit "
+        << PacBio::MinorseqGitSha1() << ")"
+        << "</td></tr>";
+    out << "</table>";
+    out << "</div></details>" << '\n';
+
+    out << R"(
+            <details style="margin-bottom: 20px;margin-top:10px">
+            <summary>Target config</summary>
+            <div style="padding-left:20px;padding-top:10px">)";
+    out << "<table>";
+    const std::string version = config_.version.empty() ? "NA" : config_.version;
+    const std::string referenceName = config_.referenceName.empty() ? "NA" : config_.referenceName;
+    const std::string referenceSequenceLength =
+        config_.referenceSequence.empty() ? "NA" : std::to_string(config_.referenceSequence.size());
+    out << "<tr><td>Config Version:</td><td><code>" << version << "</code></td></tr>";
+    out << "<tr><td>Reference Name:</td><td><code>" << referenceName << "</code></td></tr>";
+    out << "<tr><td>Reference Length:</td><td><code>" << referenceSequenceLength
+        << "</code></td></tr>";
+    if (config_.targetGenes.empty()) out << "<tr><td>Genes:</td><td><code>NA</code></td></tr>";
+    out << "</table>";
+    if (!config_.targetGenes.empty()) {
+        out << "<span style=\"padding-left:3px\">Genes:</span><ul style=\"margin-top:0px\">"
+            << '\n';
+        for (const auto& gene : config_.targetGenes) {
+            out << "<li style=\"margin-top:5px;\">"
+                << "<b>" << gene.name << "</b>"
+                << " (" << gene.begin << "-" << gene.end << ")";
+            if (!gene.drms.empty()) {
+                out << "<ul>";
+                for (const auto& drm : gene.drms) {
+                    out << "<li>"
+                        << "<code>" << drm.name << ":";
+
+                    for (const auto& pos : drm.positions) {
+                        out << " " << std::string(pos);
+                    }
+                    out << "</code>"
+                        << "</li>";
+                }
+                out << "</ul>" << '\n';
+            }
+            out << "</li>" << '\n';
+        }
+        out << "</ul>" << '\n';
+    }
+    out << "</div></details>" << '\n';
+
+    out << R"(<details open style="margin-bottom: 20px">
+            <summary>Variant Discovery</summary>
+            <div style="margin-left:20px; padding-top:10px">)";
+    if (pageSize > 0)
+        PagedDiscovery(out, numHaplotypes, pageSize);
+    else
+        Discovery(out, numHaplotypes);
+    out << "</div></details>" << '\n';
+    out << R"(<details style="margin-bottom: 20px">
+            <summary>Drug Summaries</summary>)";
+    DRMView(out);
+    out << "</details>" << '\n';
+    out << '\n' << "</body>" << '\n' << "</html>" << '\n';
+    return std::move(out.Data());
+}
+
+void HtmlReport::Discovery(Buffer& out, const int numHaplotypes) const
+{
+    const auto& colors = HaplotypeColors();
+    for (const auto gene : genes_) {
+        out << "<table class=\"discovery\">\n";
+        DiscoveryHeader(out, *gene, numHaplotypes);
+        for (const auto& pos_variant : gene->relPositionToVariant) {
+            const auto& variantPosition = *pos_variant.second;
+            if (!variantPosition.IsVariant()) continue;
+            const std::string& refCodon = variantPosition.refCodon;
+            bool first = true;
+            for (const auto& aa_varCodon : variantPosition.aminoAcidToCodons) {
+                for (const auto& codon : aa_varCodon.second) {
+                    if (first) {
+                        out << "<tr class=\"var\">\n"
+                            << "<td>" << refCodon[0] << " " << refCodon[1] << " " << refCodon[2]
+                            << "</td>\n"
+                            << "<td>" << variantPosition.refAminoAcid << "</td>\n"
+                            << "<td>" << pos_variant.first << "</td>";
+                    } else {
+                        out << "<tr class=\"var\"><td></td><td></td><td></td>";
+                    }
+                    out << "<td>" << aa_varCodon.first << "</td>";
+                    out << "<td>";
+                    for (int j = 0; j < 3; ++j) {
+                        const bool mutated = refCodon[j] != codon.codon[j];
+                        if (mutated) out << "<b style=\"color:#E90032; font-weight:normal\">";
+                        out << codon.codon[j] << " ";
+                        if (mutated) out << "</b>";
+                    }
+                    out << "<td>" << SignificantPercent(codon.frequency) << "</td>";
+                    if (first) {
+                        out << "<td>" << variantPosition.coverage << "</td>";
+                        first = false;
+                    } else {
+                        out << "<td></td>";
+                    }
+                    std::string knownDRM = codon.knownDRM;
+                    Encode(knownDRM);
+                    out << "<td>" << knownDRM << "</td>";
+                    int col = 0;
+                    for (const bool hit : codon.haplotypeHit) {
+                        if (hit)
+                            out << "<td style=\"background-color:" << colors.at(col % colors.size())
+                                << "\"></td>";
+                        else
+                            out << "<td></td>";
+                        ++col;
+                    }
+                    out << "</tr>\n";
+
+                    out << R"(
+                        <tr class="msa">
+                        <td colspan=3 style="background-color: white"></td>
+                        <td colspan=14 style="padding:0; margin:0">
+                        <table style="padding:0; margin:0" class="msacounts">
+                        <col width="50px" />
+                        <col width="67px" />
+                        <col width="67px" />
+                        <col width="67px" />
+                        <col width="67px" />
+                        <col width="67px" />
+                        <col width="67px" />
+                        <tr style="padding:0">
+                        <th style="padding:2px 0 0px 0">Pos</th>
+                        <th style="padding:2px 0 0px 0">A</th>
+                        <th style="padding:2px 0 0px 0">C</th>
+                        <th style="padding:2px 0 0px 0">G</th>
+                        <th style="padding:2px 0 0px 0">T</th>
+                        <th style="padding:2px 0 0px 0">-</th>
+                        <th style="padding:2px 0 0px 0">N</th>
+                        </tr>
+                        )";
+
+                    for (const auto& column : variantPosition.msa) {
+                        const int relPos = column.relPos;
+                        const int codonTag = relPos >= 0 && relPos < 3
+                                                 ? Data::NucleotideToTag(codon.codon[relPos])
+                                                 : -1;
+                        const int wtTag = Data::NucleotideToTag(column.wt);
+                        out << "<tr><td>" << relPos << "</td>\n";
+                        for (int j = 0; j < 6; ++j) {
+                            out << "<td style=\"";
+                            if (j == codonTag) out << "color:#B50A36;";
+                            if (j == wtTag) out << "font-weight:bold;";
+                            out << "\">" << column.counts[j] << "</td>\n";
+                        }
+                        out << "</tr>\n";
+                    }
+                    out << "</table></tr>\n";
+                }
+            }
+        }
+    }
+    out << "</table>" << '\n';
+    Legend(out, numHaplotypes);
+}
+
+void HtmlReport::PagedDiscovery(Buffer& out, const int numHaplotypes, const int pageSize) const
+{
+    for (size_t g = 0; g < genes_.size(); ++g) {
+        out << "<table class=\"discovery\" id=\"discovery" << g << "\">\n";
+        DiscoveryHeader(out, *genes_[g], numHaplotypes);
+        out << "</table>\n<div class=\"pager\" id=\"pager" << g << "\"></div>\n";
+    }
+
+    // Compact data blob, one array per variant position:
+    // [pos, ref codon, ref aa, coverage, [msa column: rel pos, A, C, G, T, -, N, wt tag]*,
+    //  [[aa, codon, %, known drms, [hit haplotype index]*]*]]
+    std::ostringstream blob;
+    {
+        IO::JsonWriter json(blob, -1);
+        json.BeginObject();
+        json.Member("page_size", pageSize);
+        json.Member("num_haplotypes", std::max(numHaplotypes, 0));
+        json.Key("genes").BeginArray();
+        for (const auto gene : genes_) {
+            json.BeginArray();
+            for (const auto& pos_variant : gene->relPositionToVariant) {
+                const auto& variantPosition = *pos_variant.second;
+                if (!variantPosition.IsVariant()) continue;
+                json.BeginArray();
+                json.Value(pos_variant.first);
+                json.Value(variantPosition.refCodon);
+                json.Value(std::string(1, variantPosition.refAminoAcid));
+                json.Value(variantPosition.coverage);
+                json.BeginArray();
+                for (const auto& column : variantPosition.msa) {
+                    json.Value(column.relPos);
+                    for (const int count : column.counts)
+                        json.Value(count);
+                    json.Value(Data::NucleotideToTag(column.wt));
+                }
+                json.EndArray();
+                json.BeginArray();
+                for (const auto& aa_varCodon : variantPosition.aminoAcidToCodons) {
+                    for (const auto& codon : aa_varCodon.second) {
+                        json.BeginArray();
+                        json.Value(std::string(1, aa_varCodon.first));
+                        json.Value(codon.codon);
+                        json.Value(SignificantPercent(codon.frequency));
+                        json.Value(codon.knownDRM);
+                        json.BeginArray();
+                        for (size_t h = 0; h < codon.haplotypeHit.size(); ++h)
+                            if (codon.haplotypeHit[h]) json.Value(h);
+                        json.EndArray();
+                        json.EndArray();
+                    }
+                }
+                json.EndArray();
+                json.EndArray();
+            }
+            json.EndArray();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+    // "</" must not appear inside a script element, "<\/" is the same JSON
+    const std::string data = blob.str();
+    out << "<script type=\"application/json\" id=\"juliet-data\">";
+    size_t begin = 0;
+    for (size_t end = data.find("</"); end != std::string::npos; end = data.find("</", begin)) {
+        out << data.substr(begin, end - begin) << "<\\/";
+        begin = end + 2;
+    }
+    out << data.substr(begin) << "</script>\n";
+
+    out << "<script type=\"text/javascript\">\nvar colors = [";
+    const auto& colors = HaplotypeColors();
+    for (size_t i = 0; i < colors.size(); ++i)
+        out << (i ? ", " : "") << '"' << colors[i] << '"';
+    out << "];\n";
+    // clang-format off
+    out << R"(var data = JSON.parse(document.getElementById("juliet-data").textContent);
+var pages = [];
+function esc(s) {
+    return String(s).replace(/&/g, "&amp;").replace(/</g, "&lt;").replace(/>/g, "&gt;").replace(/"/g, "&quot;");
+}
+function renderRows(g) {
+    var positions = data.genes[g];
+    var html = [];
+    var end = Math.min(positions.length, (pages[g] + 1) * data.page_size);
+    for (var i = pages[g] * data.page_size; i < end; ++i) {
+        var p = positions[i], ref = p[1], variants = p[5];
+        for (var k = 0; k < variants.length; ++k) {
+            var v = variants[k], codon = v[1], hits = v[4], next = 0;
+            html.push('<tr class="var" data-gene="' + g + '" data-pos="' + i + '" data-var="' + k + '">');
+            if (k == 0)
+                html.push("<td>" + ref[0] + " " + ref[1] + " " + ref[2] + "</td><td>" + p[2] + "</td><td>" + p[0] + "</td>");
+            else
+                html.push("<td></td><td></td><td></td>");
+            html.push("<td>" + v[0] + "</td><td>");
+            for (var j = 0; j < 3; ++j) {
+                if (ref[j] != codon[j])
+                    html.push('<b style="color:#E90032; font-weight:normal">' + codon[j] + " </b>");
+                else
+                    html.push(codon[j] + " ");
+            }
+            html.push("</td><td>" + v[2] + "</td><td>" + (k == 0 ? p[3] : "") + "</td><td>" + esc(v[3]) + "</td>");
+            for (var h = 0; h < data.num_haplotypes; ++h) {
+                if (next < hits.length && hits[next] == h) {
+                    html.push('<td style="background-color:' + colors[h % colors.length] + '"></td>');
+                    ++next;
+                } else {
+                    html.push("<td></td>");
+                }
+            }
+            html.push("</tr>");
+        }
+    }
+    return html.join("");
+}
+function msaRow(g, i, k) {
+    var msa = data.genes[g][i][4], codon = data.genes[g][i][5][k][1];
+    var html = ['<td colspan=3 style="background-color: white"></td><td colspan=14 style="padding:0; margin:0">',
+                '<table style="padding:0; margin:0" class="msacounts">',
+                '<col width="50px" /><col width="67px" /><col width="67px" /><col width="67px" />',
+                '<col width="67px" /><col width="67px" /><col width="67px" /><tr style="padding:0">'];
+    var header = ["Pos", "A", "C", "G", "T", "-", "N"];
+    for (var c = 0; c < header.length; ++c)
+        html.push('<th style="padding:2px 0 0px 0">' + header[c] + "</th>");
+    html.push("</tr>");
+    for (var m = 0; m < msa.length; m += 8) {
+        var relPos = msa[m];
+        var codonTag = relPos >= 0 && relPos < 3 ? "ACGT-N".indexOf(codon[relPos]) : -1;
+        html.push("<tr><td>" + relPos + "</td>");
+        for (var j = 0; j < 6; ++j) {
+            var style = (j == codonTag ? "color:#B50A36;" : "") + (j == msa[m + 7] ? "font-weight:bold;" : "");
+            html.push('<td style="' + style + '">' + msa[m + 1 + j] + "</td>");
+        }
+        html.push("</tr>");
+    }
+    html.push("</table></td>");
+    return html.join("");
+}
+function showPage(g, page) {
+    var table = document.getElementById("discovery" + g);
+    var numPages = Math.max(1, Math.ceil(data.genes[g].length / data.page_size));
+    pages[g] = Math.min(Math.max(page, 0), numPages - 1);
+    var body = table.tBodies[0];
+    while (body.rows.length > 3)
+        body.deleteRow(-1);
+    body.insertAdjacentHTML("beforeend", renderRows(g));
+    var pager = document.getElementById("pager" + g);
+    if (numPages == 1) return;
+    pager.innerHTML = '<button data-gene="' + g + '" data-page="' + (pages[g] - 1) + '"' +
+                      (pages[g] == 0 ? " disabled" : "") + ">&laquo;</button> Page " + (pages[g] + 1) +
+                      " of " + numPages + ' <button data-gene="' + g + '" data-page="' + (pages[g] + 1) +
+                      '"' + (pages[g] == numPages - 1 ? " disabled" : "") + ">&raquo;</button>";
+}
+document.addEventListener("click", function(event) {
+    var target = event.target;
+    if (target.tagName == "BUTTON" && target.hasAttribute("data-page")) {
+        showPage(+target.getAttribute("data-gene"), +target.getAttribute("data-page"));
+        return;
+    }
+    while (target && !(target.tagName == "TR" && target.className == "var"))
+        target = target.parentNode;
+    if (!target) return;
+    var next = target.nextElementSibling;
+    if (next && next.className == "msa") {
+        next.style.display = next.style.display == "none" ? "table-row" : "none";
+        return;
+    }
+    var row = target.parentNode.insertRow(target.sectionRowIndex + 1);
+    row.className = "msa";
+    row.style.display = "table-row";
+    row.innerHTML = msaRow(+target.getAttribute("data-gene"), +target.getAttribute("data-pos"),
+                           +target.getAttribute("data-var"));
+});
+for (var g = 0; g < data.genes.length; ++g)
+    showPage(g, 0);
+</script>
+)";
+    // clang-format on
+    Legend(out, numHaplotypes);
+}
+
+void HtmlReport::DiscoveryHeader(Buffer& out, const VariantGene& gene,
+                                 const int numHaplotypes) const
+{
+    const auto& colors = HaplotypeColors();
+    const std::string& referenceName = config_.referenceName;
+
+    out << R"(
+            <col width="40px"/>
+            <col width="40px"/>
+            <col width="40px"/>
+            <col width="40px"/>
+            <col width="40px"/>
+            <col width="60px"/>
+            <col width="60px"/>
+            <col width="180px"/>)";
+    for (int hap = 0; hap < numHaplotypes; ++hap) {
+        out << R"(<col width="40"/>)";
+    }
+    out << R"(<tr>
+            <th colspan=")"
+        << 8 << R"(">)" << gene.geneName << "</th>";
+    for (int hap = 0; hap < numHaplotypes; ++hap) {
+        out << "<th style=\"color:" << colors.at(hap % colors.size()) << "\">"
+            << haplotypes_.at(hap).Name;
+        out << "</th>";
+    }
+
+    out << R"(</tr><tr>
+            <th colspan="3">)";
+    if (referenceName.empty()) out << "Majority Call";
+    if (referenceName.size() > 11)
+        out << referenceName.substr(0, 11) << "...";
+    else
+        out << referenceName;
+    out << R"(</th>
+            <th colspan="5">Sample Variants</th>)";
+    if (numHaplotypes > 0) {
+        out << R"(<th colspan=")" << (numHaplotypes) << R"("><div class="tooltip">)";
+        out << "<span class=\"tooltiptextlarge\">";
+        out << R"(<table class="hapcounts"><col width="280px" /><col width="60px" />)";
+        out << "<tr><td>"
+            << "<b>Haplotype Category</b>"
+            << "</td><td>"
+            << "<b>#Reads</b>"
+            << "</td</tr>\n";
+        out << "<tr><td>"
+            << "Reported"
+            << "</td><td>" << counts_.HealthyReported << "</td</tr>\n";
+        out << "<tr><td>"
+            << "Insufficient Coverage (unreported)"
+            << "</td><td>" << counts_.HealthyLowCoverage << "</td</tr>\n";
+        out << "<tr><td>"
+            << "Overall Damaged (unreported)"
+            << "</td><td>" << counts_.AllDamaged << "</td</tr>\n";
+        out << "<tr><td>"
+            << R"(<span style="padding-left:10px">- Marginal Gaps</span>)"
+            << "</td><td>" << counts_.MarginalWithGaps << "</td</tr>\n";
+        out << "<tr><td>"
+            << R"(<span style="padding-left:10px">- Marginal Heteroduplexes</span>)"
+            << "</td><td>" << counts_.MarginalWithHeteroduplexes << "</td</tr>\n";
+        out << "<tr><td>"
+            << R"(<span style="padding-left:10px">- Marginal Partial</span>)"
+            << "</td><td>" << counts_.MarginalPartial << "</td</tr>\n";
+        out << "</table>";
+        out << "</span>"
+            << "Haplotypes %</div></th>";
+    }
+    out << R"(
+            </tr>
+            <tr>
+            <th>Codon</th>
+            <th>AA</th>
+            <th>Pos</th>
+            <th>AA</th>
+            <th>Codon</th>
+            <th>%</th>
+            <th>Coverage</th>
+            <th>Affected Drugs)";
+    if (!config_.dbVersion.empty()) out << "<sup>*</sup>";
+    out << "</th>";
+    for (int hap = 0; hap < numHaplotypes; ++hap) {
+        const auto& haplotype = haplotypes_.at(hap);
+        out << R"(<th><div class="tooltip">)"
+            << std::round(1000 * haplotype.GlobalFrequency) / 10.0;
+        out << "<span class=\"tooltiptext\">" << haplotype.Names.size() << "</span>";
+        out << "</div></th>";
+    }
+    out << "</tr>\n";
+}
+
+void HtmlReport::Legend(Buffer& out, const int numHaplotypes) const
+{
+    const bool hasConf = !config_.referenceName.empty() && !config_.referenceSequence.empty();
+
+    if (!config_.dbVersion.empty()) out << "<b><sup>*</sup>" << config_.dbVersion << "</b>";
+    out << R"(
+            <details style="margin-bottom: 20px;margin-top:15px">
+            <summary>Legend</summary>
+            <div style="padding-left:20px">)";
+
+    out << "<p>General:<br/><ul>" << '\n';
+    if (hasConf) {
+        out << "<li>Every table represents a gene.</li>" << '\n';
+        out << "<li>Positions are relative to the current gene.</li>" << '\n';
+    } else {
+        out << "<li>There is at maximum one table with an \"Unnamed ORF\"</li>" << '\n';
+        out << "<li>Reading frame starts at the first position of the reference used for "
+               "alignment.</li>"
+            << '\n';
+        out << "<li>The left side of the table shows major codons / AAs observed in this "
+               "sample.</li>"
+            << '\n';
+    }
+    out << "<li>Each row stands for a mutated amino acid.</li>" << '\n';
+    out << "<li>Positions without significant mutations are omitted.</li>" << '\n';
+    out << "<li>All coordinates are in reference space.</li>" << '\n';
+    out << "<li>The mutated nucleotide is highlighted in the codon.</li>" << '\n';
+    out << "<li>Percentage is per codon.</li>" << '\n';
+    out << "<li>Coverage includes deletions.</li>" << '\n';
+    out << "<li>Drugs affected by known drug resistance mutations are listed in the corresponding "
+           "column.</li>"
+        << '\n';
+    out << "</ul>" << '\n';
+    out << "<p>Alignment Details:</p>" << '\n';
+    out << "<ul>" << '\n';
+    out << "<li>Clicking on a row unfolds the counts of the multiple sequence alignment of the "
+           "codon position and up to ±3 surrounding positions.</li>"
+        << '\n';
+    out << "<li>Nucleotides of this codon are in red and wild type in bold.</li>" << '\n';
+    out << "</ul>" << '\n';
+    out << "<p>Limitations:</p>" << '\n';
+    out << "<ul>" << '\n';
+    out << "<li>Deletions and insertions are being ignored in this version.</li>" << '\n';
+    out << "</ul>" << '\n';
+    if (numHaplotypes > 0) {
+        out << "<p>Haplotypes:</p>" << '\n';
+        out << "<ul>" << '\n';
+        out << "<li>The row-wise variant calls are \"transposed\" onto the per column "
+               "haplotypes.</li>"
+            << '\n';
+        out << "<li>For each variant, the haplotype shows a colored box, wild type is represented "
+               "by plain dark gray.</li>"
+            << '\n';
+        out << "<li>A color gradiant helps to distinguish between columns. Colors are purely for "
+               "the visualization.</li>"
+            << '\n';
+        out << "<li>Haplotypes are sorted in descending order by their relative abundance in "
+               "percent.</li>"
+            << '\n';
+        out << "<li>Haplotypes are assigned a single or combination of letters for documentation "
+               "purposes.</li>"
+            << '\n';
+        if (hasConf) out << "<li>Haplotypes are phased across genes.</li>" << '\n';
+        out << "</ul>" << '\n';
+    }
+    out << "<p>This software is for research only and has not been clinically "
+           "validated!</p></div></details>"
+        << '\n';
+}
+}
+}  //::PacBio::Juliet
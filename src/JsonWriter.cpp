@@ -0,0 +1,207 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <stdexcept>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/io/JsonWriter.h>
+
+namespace PacBio {
+namespace IO {
+namespace {
+// Large enough to amortize stream calls, small enough to not matter
+const size_t flushThreshold = 1 << 16;
+
+Util::MemoryCounter& JsonMemory()
+{
+    static auto& counter = Util::MemoryCounter::Get("json");
+    return counter;
+}
+}
+
+JsonWriter::JsonWriter(std::ostream& out, const int indent)
+    : out_(out), indent_(indent), memory_(JsonMemory())
+{
+    buffer_.reserve(flushThreshold + 4096);
+    memory_.Set(buffer_.capacity());
+}
+
+JsonWriter::~JsonWriter() { Flush(); }
+
+void JsonWriter::Flush()
+{
+    out_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+void JsonWriter::NewLine()
+{
+    if (indent_ < 0) return;
+    buffer_ += '\n';
+    buffer_.append(scopes_.size() * indent_, ' ');
+}
+
+void JsonWriter::BeginValue()
+{
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (scopes_.empty()) return;
+    if (scopes_.back().IsObject) throw std::logic_error("JSON object member without key");
+    if (!scopes_.back().Empty) buffer_ += ',';
+    scopes_.back().Empty = false;
+    NewLine();
+}
+
+JsonWriter& JsonWriter::EndValue()
+{
+    if (buffer_.size() >= flushThreshold) Flush();
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(const std::string& key)
+{
+    if (scopes_.empty() || !scopes_.back().IsObject || afterKey_)
+        throw std::logic_error("JSON key outside of an object");
+    if (!scopes_.back().Empty) buffer_ += ',';
+    scopes_.back().Empty = false;
+    NewLine();
+    AppendString(key);
+    buffer_ += indent_ < 0 ? ":" : ": ";
+    afterKey_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginObject()
+{
+    BeginValue();
+    buffer_ += '{';
+    scopes_.push_back({true, true});
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray()
+{
+    BeginValue();
+    buffer_ += '[';
+    scopes_.push_back({false, true});
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() { return End(true); }
+
+JsonWriter& JsonWriter::EndArray() { return End(false); }
+
+JsonWriter& JsonWriter::End(const bool isObject)
+{
+    if (scopes_.empty() || scopes_.back().IsObject != isObject || afterKey_)
+        throw std::logic_error("Unbalanced JSON scopes");
+    const bool empty = scopes_.back().Empty;
+    scopes_.pop_back();
+    if (!empty) NewLine();
+    buffer_ += isObject ? '}' : ']';
+    return EndValue();
+}
+
+JsonWriter& JsonWriter::Value(const std::string& value)
+{
+    BeginValue();
+    AppendString(value);
+    return EndValue();
+}
+
+JsonWriter& JsonWriter::Value(const char* value) { return Value(std::string(value)); }
+
+JsonWriter& JsonWriter::Value(const bool value)
+{
+    BeginValue();
+    buffer_ += value ? "true" : "false";
+    return EndValue();
+}
+
+JsonWriter& JsonWriter::Value(const double value)
+{
+    BeginValue();
+    // Numbers are formatted by the JSON library, exponents and the
+    // shortest round-trip digits included; non-finite values are null
+    buffer_ += JSON::Json(value).dump();
+    return EndValue();
+}
+
+void JsonWriter::AppendString(const std::string& s)
+{
+    static const char* hex = "0123456789abcdef";
+    buffer_ += '"';
+    for (const char c : s) {
+        switch (c) {
+            case '"':
+                buffer_ += "\\\"";
+                break;
+            case '\\':
+                buffer_ += "\\\\";
+                break;
+            case '\b':
+                buffer_ += "\\b";
+                break;
+            case '\f':
+                buffer_ += "\\f";
+                break;
+            case '\n':
+                buffer_ += "\\n";
+                break;
+            case '\r':
+                buffer_ += "\\r";
+                break;
+            case '\t':
+                buffer_ += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    buffer_ += "\\u00";
+                    buffer_ += hex[(c >> 4) & 0xF];
+                    buffer_ += hex[c & 0xF];
+                } else {
+                    buffer_ += c;
+                }
+        }
+    }
+    buffer_ += '"';
+}
+}
+}  // ::PacBio::IO
@@ -35,19 +35,31 @@
 
 // Author: Armin Töpfer
 
+#include <algorithm>
 #include <numeric>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <pacbio/data/ArrayRead.h>
 #include <pacbio/data/MSAColumn.h>
 #include <pacbio/data/QvThresholds.h>
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/ThreadPool.h>
 
 #include <pacbio/data/MSAByColumn.h>
 
 namespace PacBio {
 namespace Data {
+Util::MemoryCounter& MSAByColumn::Memory()
+{
+    static auto& counter = Util::MemoryCounter::Get("msa_columns");
+    return counter;
+}
+
 MSAByColumn::MSAByColumn(const MSAByRow& msaRows)
 {
+    Util::ScopedStage stage("msa_columns");
     beginPos = msaRows.BeginPos - 1;
     endPos = msaRows.EndPos - 1;
     counts.resize(msaRows.EndPos - msaRows.BeginPos);
@@ -57,29 +69,39 @@ MSAByColumn::MSAByColumn(const MSAByRow& msaRows)
         ++pos;
     }
 
-    for (const auto& row : msaRows.Rows) {
-        int localPos = 0;
-        for (const auto& c : row->Bases) {
-            switch (c) {
-                case 'A':
-                case 'C':
-                case 'G':
-                case 'T':
-                case '-':
-                case 'N':
-                    counts.at(localPos)[c]++;
-                    ++localPos;
-                    break;
-                case ' ':
-                    ++localPos;
-                    break;
-                default:
-                    throw std::runtime_error("Unexpected base " + std::string(1, c));
+    // Every task owns a range of columns, no synchronization needed
+    Util::ParallelForRange(0, counts.size(), [this, &msaRows](size_t begin, size_t end) {
+        for (const auto& row : msaRows.Rows) {
+            const size_t rowEnd = std::min(end, row->Bases.size());
+            for (size_t localPos = begin; localPos < rowEnd; ++localPos) {
+                const char c = row->Bases[localPos];
+                switch (c) {
+                    case 'A':
+                    case 'C':
+                    case 'G':
+                    case 'T':
+                    case '-':
+                    case 'N':
+                        counts[localPos][c] += row->Weight;
+                        break;
+                    case ' ':
+                        break;
+                    default:
+                        throw std::runtime_error("Unexpected base " + std::string(1, c));
+                }
             }
+            for (auto it = row->Insertions.lower_bound(begin);
+                 it != row->Insertions.cend() && it->first < static_cast<int>(end); ++it)
+                counts[it->first].insertions[it->second] += row->Weight;
         }
-        for (const auto& ins : row->Insertions) {
-            counts[ins.first].insertions[ins.second]++;
-        }
+    });
+
+    if (Util::Profiler::Enabled()) {
+        size_t bytes = counts.capacity() * sizeof(MSAColumn);
+        for (const auto& c : counts)
+            for (const auto& ins_count : c.insertions)
+                bytes += sizeof(ins_count) + ins_count.first.capacity() + 32;
+        memory_.Set(bytes);
     }
 }
 }  // namespace Data
@@ -0,0 +1,286 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <pacbio/io/JsonWriter.h>
+
+#include <pacbio/util/Profiler.h>
+
+namespace PacBio {
+namespace Util {
+
+struct Profiler::Stage
+{
+    std::string Name;
+    Stage* Parent = nullptr;
+    std::map<std::string, std::unique_ptr<Stage>> Children;
+    size_t Calls = 0;
+    int64_t WallNs = 0;
+    int64_t CpuNs = 0;
+    int64_t RssBytes = 0;
+    int64_t PeakRssBytes = 0;
+    int64_t PeakRssIncrease = 0;
+    std::map<std::string, int64_t> HeldBytes;
+};
+
+namespace {
+// Guards the whole stage tree and the counter registry; neither stages
+// nor counters are ever removed
+std::mutex treeMutex;
+Profiler::Stage root;
+std::map<std::string, std::unique_ptr<MemoryCounter>> counters;
+std::chrono::steady_clock::time_point enabledAt;
+
+// Innermost open stage of this thread, nullptr outside of any stage
+thread_local Profiler::Stage* currentStage = nullptr;
+
+int64_t Nanoseconds(const std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+int64_t CpuNs(const clockid_t clock)
+{
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void WriteStage(const Profiler::Stage& stage, IO::JsonWriter* json)
+{
+    json->BeginObject();
+    json->Member("name", stage.Name);
+    json->Member("calls", stage.Calls);
+    json->Member("wall_seconds", stage.WallNs / 1e9);
+    json->Member("cpu_seconds", stage.CpuNs / 1e9);
+    json->Member("rss_bytes", stage.RssBytes);
+    json->Member("peak_rss_bytes", stage.PeakRssBytes);
+    json->Member("peak_rss_increase_bytes", stage.PeakRssIncrease);
+    if (!stage.HeldBytes.empty()) {
+        json->Key("held_bytes").BeginObject();
+        for (const auto& name_bytes : stage.HeldBytes)
+            json->Member(name_bytes.first, name_bytes.second);
+        json->EndObject();
+    }
+    if (!stage.Children.empty()) {
+        json->Key("stages").BeginArray();
+        for (const auto& name_child : stage.Children)
+            WriteStage(*name_child.second, json);
+        json->EndArray();
+    }
+    json->EndObject();
+}
+}
+
+void Profiler::Enable()
+{
+    std::lock_guard<std::mutex> lock(treeMutex);
+    enabledAt = std::chrono::steady_clock::now();
+    SetEnabled();
+}
+
+void Profiler::WriteJson(std::ostream& out)
+{
+    // The writer accounts its buffer, which needs the registry lock
+    IO::JsonWriter json(out);
+    std::lock_guard<std::mutex> lock(treeMutex);
+    json.BeginObject();
+    json.Member("wall_seconds", Nanoseconds(std::chrono::steady_clock::now() - enabledAt) / 1e9);
+    json.Member("cpu_seconds", CpuNs(CLOCK_PROCESS_CPUTIME_ID) / 1e9);
+    json.Member("peak_rss_bytes", PeakRss());
+    json.Key("memory").BeginArray();
+    for (const auto& name_counter : counters) {
+        json.BeginObject();
+        json.Member("name", name_counter.first);
+        json.Member("bytes", name_counter.second->Bytes());
+        json.Member("peak_bytes", name_counter.second->PeakBytes());
+        json.EndObject();
+    }
+    json.EndArray();
+    json.Key("stages").BeginArray();
+    for (const auto& name_child : root.Children)
+        WriteStage(*name_child.second, &json);
+    json.EndArray();
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+
+std::function<void()> Profiler::Attach(std::function<void()> task)
+{
+    Stage* const stage = currentStage;
+    if (stage == nullptr) return task;
+    const auto submitter = std::this_thread::get_id();
+    return [stage, submitter, task]() {
+        // Restores the worker and accounts its CPU time, even if task throws
+        struct Scope
+        {
+            Profiler::Stage* const Owner;
+            Profiler::Stage* const Previous;
+            // The submitting thread accounts its own CPU time already
+            const bool Foreign;
+            const int64_t CpuBegin;
+
+            Scope(Profiler::Stage* owner, const bool foreign)
+                : Owner(owner)
+                , Previous(currentStage)
+                , Foreign(foreign)
+                , CpuBegin(foreign ? ThreadCpuNs() : 0)
+            {
+                currentStage = owner;
+            }
+            ~Scope()
+            {
+                currentStage = Previous;
+                if (Foreign) AddCpu(Owner, ThreadCpuNs() - CpuBegin);
+            }
+        } scope(stage, std::this_thread::get_id() != submitter);
+        task();
+    };
+}
+
+Profiler::Stage* Profiler::Child(Stage* parent, const char* name)
+{
+    if (parent == nullptr) parent = &root;
+    std::lock_guard<std::mutex> lock(treeMutex);
+    auto& child = parent->Children[name];
+    if (!child) {
+        child.reset(new Stage);
+        child->Name = name;
+        child->Parent = parent;
+    }
+    return child.get();
+}
+
+void Profiler::Close(Stage* stage, const int64_t wallNs, const int64_t cpuNs,
+                     const int64_t peakRssBegin)
+{
+    const int64_t rss = CurrentRss();
+    const int64_t peakRss = PeakRss();
+    std::lock_guard<std::mutex> lock(treeMutex);
+    ++stage->Calls;
+    stage->WallNs += wallNs;
+    stage->CpuNs += cpuNs;
+    stage->RssBytes = std::max(stage->RssBytes, rss);
+    stage->PeakRssBytes = std::max(stage->PeakRssBytes, peakRss);
+    stage->PeakRssIncrease = std::max(stage->PeakRssIncrease, peakRss - peakRssBegin);
+    for (const auto& name_counter : counters) {
+        const int64_t bytes = name_counter.second->Bytes();
+        if (bytes == 0) continue;
+        auto& held = stage->HeldBytes[name_counter.first];
+        held = std::max(held, bytes);
+    }
+}
+
+void Profiler::AddCpu(Stage* stage, const int64_t cpuNs)
+{
+    std::lock_guard<std::mutex> lock(treeMutex);
+    for (Stage* s = stage; s != nullptr && s != &root; s = s->Parent)
+        s->CpuNs += cpuNs;
+}
+
+int64_t Profiler::ThreadCpuNs() { return CpuNs(CLOCK_THREAD_CPUTIME_ID); }
+
+int64_t Profiler::PeakRss()
+{
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+int64_t Profiler::CurrentRss()
+{
+    // Second field of statm are the resident pages, only available on Linux
+    std::ifstream statm("/proc/self/statm");
+    int64_t size = 0;
+    int64_t resident = 0;
+    if (!(statm >> size >> resident)) return 0;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+void ScopedStage::Begin(const char* name)
+{
+    parent_ = currentStage;
+    stage_ = Profiler::Child(parent_, name);
+    currentStage = stage_;
+    peakRssBegin_ = Profiler::PeakRss();
+    cpuBegin_ = Profiler::ThreadCpuNs();
+    wallBegin_ = std::chrono::steady_clock::now();
+}
+
+void ScopedStage::End()
+{
+    const int64_t wallNs = Nanoseconds(std::chrono::steady_clock::now() - wallBegin_);
+    const int64_t cpuNs = Profiler::ThreadCpuNs() - cpuBegin_;
+    currentStage = parent_;
+    // Nested stages of this thread are part of the parents' CPU time already
+    Profiler::Close(stage_, wallNs, cpuNs, peakRssBegin_);
+}
+
+MemoryCounter& MemoryCounter::Get(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(treeMutex);
+    auto& counter = counters[name];
+    if (!counter) counter.reset(new MemoryCounter);
+    return *counter;
+}
+
+void MemoryCounter::Add(const int64_t bytes)
+{
+    const int64_t now = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = peak_.load(std::memory_order_relaxed);
+    while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace Util
+}  // namespace PacBio
@@ -0,0 +1,425 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <pbbam/DataSet.h>
+#include <pbbam/FastaReader.h>
+#include <pbbam/MD5.h>
+
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/align/ReadAligner.h>
+
+namespace PacBio {
+namespace Align {
+namespace {
+using Minimizer = std::pair<uint64_t, int32_t>;
+
+int8_t TwoBit(const char c)
+{
+    switch (c) {
+        case 'A':
+            return 0;
+        case 'C':
+            return 1;
+        case 'G':
+            return 2;
+        case 'T':
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+// Invertible integer hash, spreads lexicographically close k-mers
+uint64_t Hash64(uint64_t key, const uint64_t mask)
+{
+    key = (~key + (key << 21)) & mask;
+    key = key ^ key >> 24;
+    key = ((key + (key << 3)) + (key << 8)) & mask;
+    key = key ^ key >> 14;
+    key = ((key + (key << 2)) + (key << 4)) & mask;
+    key = key ^ key >> 28;
+    key = (key + (key << 31)) & mask;
+    return key;
+}
+
+// Smallest k-mer hash of each window of w consecutive k-mers, k-mers
+// containing non-ACGT characters never become minimizers.
+void Minimizers(const std::string& seq, const int kmerSize, const int windowSize,
+                std::vector<Minimizer>* minimizers)
+{
+    minimizers->clear();
+    const uint64_t mask = (1ULL << (2 * kmerSize)) - 1;
+    const uint64_t invalid = std::numeric_limits<uint64_t>::max();
+
+    std::deque<Minimizer> window;
+    uint64_t kmer = 0;
+    int validBases = 0;
+    int32_t lastPos = -1;
+    for (int32_t i = 0; i < static_cast<int32_t>(seq.size()); ++i) {
+        const int8_t code = TwoBit(seq[i]);
+        if (code < 0) {
+            validBases = 0;
+        } else {
+            kmer = ((kmer << 2) | code) & mask;
+            ++validBases;
+        }
+        if (i + 1 < kmerSize) continue;
+
+        const int32_t pos = i + 1 - kmerSize;
+        const uint64_t hash = validBases >= kmerSize ? Hash64(kmer, mask) : invalid;
+        while (!window.empty() && window.back().first > hash)
+            window.pop_back();
+        window.emplace_back(hash, pos);
+        while (window.front().second + windowSize <= pos)
+            window.pop_front();
+
+        if (pos + 1 >= windowSize && window.front().first != invalid &&
+            window.front().second != lastPos) {
+            lastPos = window.front().second;
+            minimizers->emplace_back(window.front());
+        }
+    }
+}
+
+std::string ReverseComplement(const std::string& seq)
+{
+    std::string rc(seq.rbegin(), seq.rend());
+    for (auto& c : rc) {
+        switch (c) {
+            case 'A':
+                c = 'T';
+                break;
+            case 'C':
+                c = 'G';
+                break;
+            case 'G':
+                c = 'C';
+                break;
+            case 'T':
+                c = 'A';
+                break;
+            default:
+                c = 'N';
+        }
+    }
+    return rc;
+}
+
+std::vector<std::string> UpperCaseSequences(const std::vector<BAM::FastaSequence>& references)
+{
+    std::vector<std::string> sequences;
+    sequences.reserve(references.size());
+    for (const auto& r : references) {
+        sequences.emplace_back(r.Bases());
+        std::transform(sequences.back().begin(), sequences.back().end(), sequences.back().begin(),
+                       ::toupper);
+    }
+    return sequences;
+}
+}
+
+MinimizerIndex::MinimizerIndex(const std::vector<std::string>& sequences, const int kmerSize,
+                               const int windowSize, const int maxOccurrences)
+    : kmerSize_(kmerSize), windowSize_(windowSize)
+{
+    if (kmerSize < 1 || kmerSize > 31)
+        throw std::runtime_error("k-mer size has to be between 1 and 31");
+    if (windowSize < 1) throw std::runtime_error("Minimizer window size has to be positive");
+
+    std::vector<Minimizer> minimizers;
+    for (size_t refId = 0; refId < sequences.size(); ++refId) {
+        Minimizers(sequences[refId], kmerSize, windowSize, &minimizers);
+        for (const auto& m : minimizers)
+            hits_[m.first].push_back({static_cast<int32_t>(refId), m.second});
+    }
+
+    // Repetitive seeds only add noise to the diagonal vote
+    for (auto it = hits_.begin(); it != hits_.end();) {
+        if (static_cast<int>(it->second.size()) > maxOccurrences)
+            it = hits_.erase(it);
+        else
+            ++it;
+    }
+}
+
+const std::vector<MinimizerIndex::Hit>* MinimizerIndex::Find(const uint64_t hash) const
+{
+    const auto it = hits_.find(hash);
+    return it == hits_.cend() ? nullptr : &it->second;
+}
+
+ReadAligner::ReadAligner(const std::vector<BAM::FastaSequence>& references,
+                         const ReadAlignerConfig& config)
+    : config_(config)
+    , references_(references)
+    , sequences_(UpperCaseSequences(references))
+    , index_(sequences_, config.KmerSize, config.WindowSize, config.MaxOccurrences)
+{
+}
+
+void ReadAligner::FindCandidates(const std::string& forward, const std::string& reverse,
+                                 Candidate* best, Candidate* second) const
+{
+    *best = Candidate();
+    *second = Candidate();
+
+    const auto Overlaps = [this](const Candidate& a, const Candidate& b) {
+        return a.ReferenceId == b.ReferenceId && a.Reverse == b.Reverse &&
+               a.DiagonalBegin <= b.DiagonalEnd + config_.BandWidth &&
+               b.DiagonalBegin <= a.DiagonalEnd + config_.BandWidth;
+    };
+
+    struct Seed
+    {
+        int32_t ReferenceId;
+        int32_t Diagonal;
+        bool operator<(const Seed& other) const
+        {
+            return std::tie(ReferenceId, Diagonal) < std::tie(other.ReferenceId, other.Diagonal);
+        }
+    };
+
+    std::vector<Minimizer> minimizers;
+    std::vector<Seed> seeds;
+    for (const bool isReverse : {false, true}) {
+        Minimizers(isReverse ? reverse : forward, index_.KmerSize(), index_.WindowSize(),
+                   &minimizers);
+        seeds.clear();
+        for (const auto& m : minimizers) {
+            const auto* hits = index_.Find(m.first);
+            if (!hits) continue;
+            for (const auto& h : *hits)
+                seeds.push_back({h.ReferenceId, h.Position - m.second});
+        }
+        std::sort(seeds.begin(), seeds.end());
+
+        // Densest bands of diagonals, each seed opens one band
+        for (size_t i = 0, j = 0; i < seeds.size(); ++i) {
+            while (j < seeds.size() && seeds[j].ReferenceId == seeds[i].ReferenceId &&
+                   seeds[j].Diagonal - seeds[i].Diagonal <= config_.BandWidth)
+                ++j;
+
+            Candidate c;
+            c.ReferenceId = seeds[i].ReferenceId;
+            c.Reverse = isReverse;
+            c.DiagonalBegin = seeds[i].Diagonal;
+            c.DiagonalEnd = seeds[j - 1].Diagonal;
+            c.Seeds = j - i;
+
+            if (c.Seeds > best->Seeds) {
+                if (!Overlaps(c, *best)) *second = *best;
+                *best = c;
+            } else if (c.Seeds > second->Seeds && !Overlaps(c, *best)) {
+                *second = c;
+            }
+        }
+    }
+}
+
+bool ReadAligner::Map(const std::string& read, Aligner* aligner, ReadAlignment* result) const
+{
+    std::string forward = read;
+    std::transform(forward.begin(), forward.end(), forward.begin(), ::toupper);
+    const std::string reverse = ReverseComplement(forward);
+
+    Candidate best;
+    Candidate second;
+    FindCandidates(forward, reverse, &best, &second);
+    if (best.Seeds < config_.MinSeeds) return false;
+
+    const auto& query = best.Reverse ? reverse : forward;
+    const auto& reference = sequences_.at(best.ReferenceId);
+    const int32_t windowBegin = std::max(0, best.DiagonalBegin - config_.BandWidth);
+    const int32_t windowEnd =
+        std::min<int32_t>(reference.size(), best.DiagonalEnd + static_cast<int32_t>(query.size()) +
+                                                config_.BandWidth);
+    if (windowEnd <= windowBegin) return false;
+
+    PariwiseAlignmentFasta alignment;
+    aligner->Align(boost::string_ref(reference).substr(windowBegin, windowEnd - windowBegin), query,
+                   &alignment);
+
+    const auto& transcript = alignment.Transcript;
+    const size_t coreBegin = transcript.find_first_not_of("PS");
+    if (coreBegin == std::string::npos) return false;
+    const size_t coreEnd = transcript.find_last_not_of("PS") + 1;
+
+    LeftAlignGaps(&alignment.Query, alignment.Target, coreBegin, coreEnd);
+    LeftAlignGaps(&alignment.Target, alignment.Query, coreBegin, coreEnd);
+
+    auto& cigar = result->Cigar;
+    cigar.clear();
+    const auto Push = [&cigar](const BAM::CigarOperationType type, const uint32_t length) {
+        if (length == 0) return;
+        if (!cigar.empty() && cigar.back().Type() == type)
+            cigar.back().Length(cigar.back().Length() + length);
+        else
+            cigar.emplace_back(type, length);
+    };
+
+    Push(BAM::CigarOperationType::SOFT_CLIP,
+         std::count(transcript.cbegin(), transcript.cbegin() + coreBegin, 'S'));
+    for (size_t i = coreBegin; i < coreEnd; ++i) {
+        const char t = alignment.Target[i];
+        const char q = alignment.Query[i];
+        if (t == '-')
+            Push(BAM::CigarOperationType::INSERTION, 1);
+        else if (q == '-')
+            Push(BAM::CigarOperationType::DELETION, 1);
+        else if (t == q && t != 'N')
+            Push(BAM::CigarOperationType::SEQUENCE_MATCH, 1);
+        else
+            Push(BAM::CigarOperationType::SEQUENCE_MISMATCH, 1);
+    }
+    Push(BAM::CigarOperationType::SOFT_CLIP,
+         std::count(transcript.cbegin() + coreEnd, transcript.cend(), 'S'));
+
+    result->ReferenceId = best.ReferenceId;
+    result->Reverse = best.Reverse;
+    result->ReferenceStart =
+        windowBegin + std::count(transcript.cbegin(), transcript.cbegin() + coreBegin, 'P');
+    result->MappingQuality =
+        static_cast<uint8_t>(60.0 * (1.0 - static_cast<double>(second.Seeds) / best.Seeds));
+
+    return true;
+}
+
+std::vector<BAM::BamRecord> ReadAligner::Map(const std::vector<BAM::BamRecord>& records) const
+{
+    std::vector<BAM::BamRecord> mapped(records.size());
+    std::vector<char> isMapped(records.size(), 0);
+
+    Util::ParallelForRange(0, records.size(), [&](size_t begin, size_t end) {
+        Aligner aligner(config_.MatchScore, config_.MismatchPenalty, config_.GapOpenPenalty,
+                        config_.GapExtendPenalty);
+        ReadAlignment alignment;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& record = records[i];
+            if (record.Impl().IsMapped())
+                throw std::runtime_error("Input reads have to be unaligned: " + record.FullName());
+            if (!Map(record.Sequence(), &aligner, &alignment)) continue;
+            mapped[i] = BAM::BamRecord::Mapped(
+                record, alignment.ReferenceId, alignment.ReferenceStart,
+                alignment.Reverse ? BAM::Strand::REVERSE : BAM::Strand::FORWARD, alignment.Cigar,
+                alignment.MappingQuality);
+            isMapped[i] = 1;
+        }
+    });
+
+    std::vector<BAM::BamRecord> result;
+    result.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+        if (isMapped[i]) result.emplace_back(std::move(mapped[i]));
+
+    std::stable_sort(result.begin(), result.end(),
+                     [](const BAM::BamRecord& a, const BAM::BamRecord& b) {
+                         return std::make_pair(a.Impl().ReferenceId(), a.Impl().Position()) <
+                                std::make_pair(b.Impl().ReferenceId(), b.Impl().Position());
+                     });
+    return result;
+}
+
+void LeftAlignGaps(std::string* gapped, const std::string& other, const size_t begin,
+                   const size_t end)
+{
+    auto& a = *gapped;
+    for (size_t i = begin; i < end; ++i) {
+        if (a[i] != '-') continue;
+        size_t runEnd = i;
+        while (runEnd < end && a[runEnd] == '-')
+            ++runEnd;
+
+        // Rotating the gap run by one column keeps the score, if the base
+        // leaving on the left equals the base entering on the right.
+        // The first column stays aligned, alignments never start with a gap.
+        size_t s = i;
+        size_t e = runEnd;
+        while (s > begin + 1 && a[s - 1] != '-' && other[s - 1] != '-' &&
+               other[s - 1] == other[e - 1]) {
+            std::swap(a[s - 1], a[e - 1]);
+            --s;
+            --e;
+        }
+        i = runEnd - 1;
+    }
+}
+
+std::vector<BAM::FastaSequence> ReadReferences(const std::string& referenceFile)
+{
+    std::vector<BAM::FastaSequence> references;
+    BAM::DataSet ds(referenceFile);
+    for (const auto& fasta : ds.FastaFiles()) {
+        BAM::FastaReader reader(fasta);
+        BAM::FastaSequence f;
+        while (reader.GetNext(f))
+            references.emplace_back(f);
+    }
+    if (references.empty())
+        throw std::runtime_error("Could not find reference sequences in " + referenceFile);
+    return references;
+}
+
+BAM::BamHeader AlignedHeader(const std::string& inputFile,
+                             const std::vector<BAM::FastaSequence>& references)
+{
+    const auto bamFiles = BAM::DataSet(inputFile).BamFiles();
+    if (bamFiles.empty()) throw std::runtime_error("Could not find BAM files in " + inputFile);
+
+    auto header = bamFiles.front().Header().DeepCopy();
+    for (size_t i = 1; i < bamFiles.size(); ++i)
+        header += bamFiles.at(i).Header();
+
+    header.ClearSequences();
+    for (const auto& r : references) {
+        std::string bases = r.Bases();
+        std::transform(bases.begin(), bases.end(), bases.begin(), ::toupper);
+        header.AddSequence(BAM::SequenceInfo(r.Name(), std::to_string(bases.size()))
+                               .Checksum(BAM::MD5Hash(bases)));
+    }
+    header.SortOrder("coordinate");
+    return header;
+}
+}
+}  // ::PacBio::Align
@@ -0,0 +1,84 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <stdexcept>
+#include <string>
+
+#include <pacbio/juliet/SampleArrays.h>
+
+namespace PacBio {
+namespace Juliet {
+
+constexpr int SampleArrays::NumNucleotides;
+constexpr int SampleArrays::NumCodons;
+
+int SampleArrays::CodonIndex(const std::string& codon)
+{
+    if (codon.size() != 3) return -1;
+    int index = 0;
+    for (const char c : codon) {
+        int n;
+        switch (c) {
+            case 'A':
+                n = 0;
+                break;
+            case 'C':
+                n = 1;
+                break;
+            case 'G':
+                n = 2;
+                break;
+            case 'T':
+                n = 3;
+                break;
+            default:
+                return -1;
+        }
+        index = 4 * index + n;
+    }
+    return index;
+}
+
+std::string SampleArrays::Codon(const int index)
+{
+    if (index < 0 || index >= NumCodons)
+        throw std::runtime_error("Codon index out of range: " + std::to_string(index));
+    static constexpr char nucleotides[] = "ACGT";
+    return {nucleotides[index / 16], nucleotides[(index / 4) % 4], nucleotides[index % 4]};
+}
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,90 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/ErrorEstimates.h>
+#include <pacbio/juliet/ErrorModel.h>
+
+#include <pacbio/juliet/SampleReader.h>
+
+namespace PacBio {
+namespace Juliet {
+
+SampleReader::SampleReader(const std::vector<std::string>& inputs, const JulietSettings& settings)
+    : inputs_(inputs), settings_(settings)
+{
+}
+
+std::shared_ptr<SampleArrays> SampleReader::Next()
+{
+    if (next_ == inputs_.size()) return nullptr;
+    name_ = inputs_.at(next_++);
+
+    const auto reads = IO::BamToArrayReads(name_, settings_.RegionStart, settings_.RegionEnd);
+    if (reads.empty()) throw std::runtime_error("Empty input " + name_);
+    return std::make_shared<SampleArrays>(Call(reads, settings_)->Arrays());
+}
+
+std::unique_ptr<AminoAcidCaller> SampleReader::Call(
+    const std::vector<std::shared_ptr<Data::ArrayRead>>& reads, const JulietSettings& settings)
+{
+    if (reads.empty()) throw std::runtime_error("No reads to call variants on");
+
+    const std::string chemistry = reads.front()->SequencingChemistry();
+    for (size_t i = 1; i < reads.size(); ++i)
+        if (chemistry != reads.at(i)->SequencingChemistry())
+            throw std::runtime_error("Mixed chemistries are not allowed");
+
+    ErrorEstimates error;
+    if (settings.SubstitutionRate != 0.0 && settings.DeletionRate != 0.0)
+        error = ErrorEstimates(settings.SubstitutionRate, settings.DeletionRate);
+    else if (!settings.ErrorModelFile.empty())
+        error = ErrorEstimates(ErrorModel::Load(settings.ErrorModelFile));
+    else
+        error = ErrorEstimates(chemistry);
+
+    std::unique_ptr<AminoAcidCaller> aac(new AminoAcidCaller(reads, error, settings));
+    if (settings.Mode == AnalysisMode::PHASING) aac->PhaseVariants();
+    return aac;
+}
+}
+}  // ::PacBio::Juliet
@@ -35,88 +35,178 @@
 
 // Author: Armin Töpfer
 
+#include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <stdexcept>
 
-#include <ssw_cpp.h>
+#include <ssw.h>
 
-#include <pbbam/Cigar.h>
+#include <pacbio/util/ThreadPool.h>
 
 #include <pacbio/align/SimdAlignment.h>
 
 namespace PacBio {
 namespace Align {
-PariwiseAlignmentFasta SimdNeedleWunschAlignment(const std::string& target,
-                                                 const std::string& query)
+namespace {
+// Same as the default translation of StripedSmithWaterman::Aligner
+// clang-format off
+const int8_t baseTranslation[128] = {
+    4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+    4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+    4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+    4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+  //   A     C            G
+    4, 0, 4, 1,  4, 4, 4, 2,  4, 4, 4, 4,  4, 4, 4, 4,
+  //             T
+    4, 4, 4, 4,  3, 0, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+  //   a     c            g
+    4, 0, 4, 1,  4, 4, 4, 2,  4, 4, 4, 4,  4, 4, 4, 4,
+  //             t
+    4, 4, 4, 4,  3, 0, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4
+};
+// clang-format on
+constexpr int alphabetSize = 5;
+}
+
+Aligner::Aligner(uint8_t matchScore, uint8_t mismatchPenalty, uint8_t gapOpenPenalty,
+                 uint8_t gapExtendPenalty)
+    : gapOpenPenalty_(gapOpenPenalty)
+    , gapExtendPenalty_(gapExtendPenalty)
+    , scoreMatrix_(alphabetSize * alphabetSize, -static_cast<int8_t>(mismatchPenalty))
+{
+    // N always mismatches, also against itself
+    for (int i = 0; i < alphabetSize - 1; ++i)
+        scoreMatrix_[i * alphabetSize + i] = matchScore;
+}
+
+Aligner::~Aligner()
+{
+    if (profile_) init_destroy(profile_);
+}
+
+void Aligner::Translate(boost::string_ref seq, std::vector<int8_t>* translated) const
 {
-    StripedSmithWaterman::Aligner aligner;
-    StripedSmithWaterman::Filter filter;
-    StripedSmithWaterman::Alignment alignment;
-    aligner.Align(query.c_str(), target.c_str(), target.size(), filter, &alignment);
-
-    size_t qryPos = 0;
-    size_t tgtPos = 0;
-
-    std::string refAlign;
-    std::string qryAlign;
-    std::string transcript;
-
-    for (int i = 0; i < alignment.ref_begin; ++i) {
-        refAlign += target.at(tgtPos);
-        ++tgtPos;
-        qryAlign += "-";
-        transcript += "P";
+    translated->resize(seq.size());
+    std::transform(seq.cbegin(), seq.cend(), translated->begin(),
+                   [](const char c) { return baseTranslation[c & 0x7F]; });
+}
+
+void Aligner::Query(boost::string_ref query)
+{
+    if (profile_ && query == query_) return;
+    if (profile_) init_destroy(profile_);
+    profile_ = nullptr;
+
+    query_.assign(query.cbegin(), query.cend());
+    Translate(query, &translatedQuery_);
+    // The profile stores a pointer to translatedQuery_, which is stable until the next call
+    if (!translatedQuery_.empty())
+        profile_ = ssw_init(translatedQuery_.data(), translatedQuery_.size(), scoreMatrix_.data(),
+                            alphabetSize, 2);
+}
+
+void Aligner::Align(boost::string_ref target, boost::string_ref query,
+                    PariwiseAlignmentFasta* result)
+{
+    Query(query);
+    Align(target, result);
+}
+
+void Aligner::Align(boost::string_ref target, PariwiseAlignmentFasta* result)
+{
+    auto& refAlign = result->Target;
+    auto& qryAlign = result->Query;
+    auto& transcript = result->Transcript;
+    refAlign.clear();
+    qryAlign.clear();
+    transcript.clear();
+    refAlign.reserve(target.size() + query_.size());
+    qryAlign.reserve(target.size() + query_.size());
+    transcript.reserve(target.size() + query_.size());
+
+    const auto AppendTarget = [&](size_t pos, size_t length, char op) {
+        refAlign.append(target.data() + pos, length);
+        qryAlign.append(length, '-');
+        transcript.append(length, op);
+    };
+    const auto AppendQuery = [&](size_t pos, size_t length, char op) {
+        refAlign.append(length, '-');
+        qryAlign.append(query_.data() + pos, length);
+        transcript.append(length, op);
+    };
+
+    s_align* alignment = nullptr;
+    if (profile_ && !target.empty()) {
+        Translate(target, &translatedTarget_);
+        alignment =
+            ssw_align(profile_, translatedTarget_.data(), translatedTarget_.size(), gapOpenPenalty_,
+                      gapExtendPenalty_, 0x0f, 0, 32767, translatedQuery_.size());
     }
-    for (const auto& c : BAM::Cigar::FromStdString(alignment.cigar_string)) {
-        for (size_t i = 0; i < c.Length(); ++i) {
-            transcript += c.Char();
-
-            if (c.Char() == '=') assert(target.at(tgtPos) == query.at(qryPos));
-
-            switch (c.Char()) {
-                case '=':
-                case 'M':
-                case 'X':
-                    refAlign += target.at(tgtPos);
-                    ++tgtPos;
-                    qryAlign += query.at(qryPos);
-                    ++qryPos;
-                    break;
-                case 'D':
-                    refAlign += target.at(tgtPos);
-                    ++tgtPos;
-                    qryAlign += "-";
-                    break;
-                case 'I':
-                case 'S':
-                    refAlign += "-";
-                    qryAlign += query.at(qryPos);
-                    ++qryPos;
-                    break;
-                case 'H':
-                    throw std::runtime_error("H");
-                default:
-                    throw std::runtime_error("unknown");
-            }
-        }
+
+    if (!alignment || alignment->cigarLen == 0 || alignment->ref_begin1 < 0 ||
+        alignment->read_begin1 < 0) {
+        // Nothing aligns, report query as insertion ahead of the target
+        AppendQuery(0, query_.size(), 'S');
+        AppendTarget(0, target.size(), 'P');
+        if (alignment) align_destroy(alignment);
+        return;
     }
 
-    while (tgtPos < target.size()) {
-        refAlign += target.at(tgtPos);
-        ++tgtPos;
-        qryAlign += "-";
-        transcript += "P";
+    size_t tgtPos = alignment->ref_begin1;
+    size_t qryPos = alignment->read_begin1;
+    AppendTarget(0, tgtPos, 'P');
+    AppendQuery(0, qryPos, 'S');
+
+    for (int32_t i = 0; i < alignment->cigarLen; ++i) {
+        const char op = cigar_int_to_op(alignment->cigar[i]);
+        const uint32_t length = cigar_int_to_len(alignment->cigar[i]);
+        switch (op) {
+            case 'M':
+                for (uint32_t j = 0; j < length; ++j, ++tgtPos, ++qryPos) {
+                    refAlign += target[tgtPos];
+                    qryAlign += query_[qryPos];
+                    transcript += translatedTarget_[tgtPos] == translatedQuery_[qryPos] ? '=' : 'X';
+                }
+                break;
+            case 'D':
+                AppendTarget(tgtPos, length, 'D');
+                tgtPos += length;
+                break;
+            case 'I':
+                AppendQuery(qryPos, length, 'I');
+                qryPos += length;
+                break;
+            default:
+                align_destroy(alignment);
+                throw std::runtime_error("Unexpected cigar operation " + std::string(1, op));
+        }
     }
+    align_destroy(alignment);
 
-    PariwiseAlignmentFasta result;
-    result.Target = std::move(refAlign);
-    result.Query = std::move(qryAlign);
-    result.Transcript = std::move(transcript);
+    AppendQuery(qryPos, query_.size() - qryPos, 'S');
+    AppendTarget(tgtPos, target.size() - tgtPos, 'P');
 
     assert(refAlign.size() == qryAlign.size());
+}
 
+PariwiseAlignmentFasta SimdNeedleWunschAlignment(const std::string& target,
+                                                 const std::string& query)
+{
+    Aligner aligner;
+    PariwiseAlignmentFasta result;
+    aligner.Align(target, query, &result);
     return result;
 }
+
+void SimdNeedleWunschAlignment(boost::string_ref target, const std::vector<std::string>& queries,
+                               std::vector<PariwiseAlignmentFasta>* results)
+{
+    results->resize(queries.size());
+    Util::ParallelForRange(0, queries.size(), [&](size_t begin, size_t end) {
+        Aligner aligner;
+        for (size_t i = begin; i < end; ++i)
+            aligner.Align(target, queries[i], &results->at(i));
+    });
+}
 }
 }  // namespace PacBio::Align
@@ -0,0 +1,162 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
+#include <pacbio/io/JsonWriter.h>
+
+#include <pacbio/util/Stats.h>
+
+namespace PacBio {
+namespace Util {
+namespace {
+using Values = std::array<std::atomic<uint64_t>, Stats::NumStats>;
+
+struct Registry
+{
+    std::mutex Mutex;
+    std::set<const Values*> Live;
+    std::array<uint64_t, Stats::NumStats> Exited{};
+};
+
+Registry& GetRegistry() { return LeakedRegistry<Registry>(); }
+
+/// Counters of one thread, only written by that thread
+struct LocalBlock
+{
+    Values Counts;
+
+    LocalBlock()
+    {
+        for (auto& c : Counts)
+            c.store(0, std::memory_order_relaxed);
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        registry.Live.insert(&Counts);
+    }
+    ~LocalBlock()
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        for (size_t i = 0; i < Stats::NumStats; ++i)
+            registry.Exited[i] += Counts[i].load(std::memory_order_relaxed);
+        registry.Live.erase(&Counts);
+    }
+};
+
+thread_local LocalBlock localBlock;
+}
+
+constexpr size_t Stats::NumStats;
+void Stats::Enable() { SetEnabled(); }
+
+void Stats::AddLocal(const Stat stat, const uint64_t n)
+{
+    // Single writer, a relaxed read-modify-write needs no lock prefix
+    auto& c = localBlock.Counts[static_cast<size_t>(stat)];
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+std::array<uint64_t, Stats::NumStats> Stats::Totals()
+{
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Mutex);
+    auto totals = registry.Exited;
+    for (const auto block : registry.Live)
+        for (size_t i = 0; i < NumStats; ++i)
+            totals[i] += (*block)[i].load(std::memory_order_relaxed);
+    return totals;
+}
+
+const char* Stats::Name(const Stat stat)
+{
+    switch (stat) {
+        case Stat::READS_DECODED:
+            return "reads_decoded";
+        case Stat::READS_SKIPPED_SECONDARY:
+            return "reads_skipped_secondary";
+        case Stat::READS_SKIPPED_SUPPLEMENTARY:
+            return "reads_skipped_supplementary";
+        case Stat::READS_SKIPPED_REGION:
+            return "reads_skipped_region";
+        case Stat::BASES_FAILING_QV:
+            return "bases_failing_qv";
+        case Stat::READS_COLLAPSED:
+            return "reads_collapsed";
+        case Stat::CODONS_EVALUATED:
+            return "codons_evaluated";
+        case Stat::CODONS_SKIPPED_GAP:
+            return "codons_skipped_gap";
+        case Stat::CODONS_SKIPPED_N:
+            return "codons_skipped_n";
+        case Stat::CODONS_SKIPPED_UNCOVERED:
+            return "codons_skipped_uncovered";
+        case Stat::FISHER_TESTS:
+            return "fisher_tests";
+        case Stat::HAPLOTYPE_COMPARISONS:
+            return "haplotype_comparisons";
+        case Stat::TRANSITION_LOOKUPS:
+            return "transition_lookups";
+        default:
+            throw std::runtime_error("Unknown stat " + std::to_string(static_cast<size_t>(stat)));
+    }
+}
+
+void Stats::Write(std::ostream& out)
+{
+    const auto totals = Totals();
+    for (size_t i = 0; i < NumStats; ++i)
+        out << std::left << std::setw(30) << Name(static_cast<Stat>(i)) << std::right
+            << std::setw(16) << totals[i] << std::endl;
+}
+
+void Stats::WriteJson(std::ostream& out)
+{
+    const auto totals = Totals();
+    IO::JsonWriter json(out);
+    json.BeginObject();
+    for (size_t i = 0; i < NumStats; ++i)
+        json.Member(Name(static_cast<Stat>(i)), totals[i]);
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+}
+}  // ::PacBio::Util
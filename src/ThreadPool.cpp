@@ -0,0 +1,226 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Tracer.h>
+
+#include <pacbio/util/ThreadPool.h>
+
+namespace PacBio {
+namespace Util {
+namespace {
+// Identifies the pool and deque of the current worker thread
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+
+std::mutex defaultMutex;
+std::unique_ptr<ThreadPool> defaultPool;
+}
+
+ThreadPool::ThreadPool(size_t numThreads) : pending_(0), nextQueue_(0)
+{
+    const size_t numWorkers = std::max<size_t>(1, numThreads) - 1;
+    // The last deque takes tasks submitted from outside the pool
+    for (size_t i = 0; i <= numWorkers; ++i)
+        queues_.emplace_back(new WorkQueue);
+    for (size_t i = 0; i < numWorkers; ++i)
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    for (auto& w : workers_)
+        w.join();
+}
+
+ThreadPool& ThreadPool::Default()
+{
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    if (!defaultPool) defaultPool.reset(new ThreadPool(1));
+    return *defaultPool;
+}
+
+void ThreadPool::Configure(size_t numThreads)
+{
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    if (defaultPool && defaultPool->NumThreads() == std::max<size_t>(1, numThreads)) return;
+    defaultPool.reset(new ThreadPool(numThreads));
+}
+
+size_t ThreadPool::ThreadCount(int n)
+{
+    const int m = std::thread::hardware_concurrency();
+
+    if (n < 1) return std::max(1, m + n);
+
+    return std::min(m, n);
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    const size_t idx =
+        currentPool == this ? currentQueue : nextQueue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[idx]->Mutex);
+        queues_[idx]->Tasks.emplace_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++pending_;
+    }
+    wakeUp_.notify_one();
+}
+
+bool ThreadPool::PopTask(const size_t first, std::function<void()>* task)
+{
+    // Own deque from the back, to keep nested work hot in cache
+    {
+        auto& q = *queues_[first];
+        std::lock_guard<std::mutex> lock(q.Mutex);
+        if (!q.Tasks.empty()) {
+            *task = std::move(q.Tasks.back());
+            q.Tasks.pop_back();
+            --pending_;
+            return true;
+        }
+    }
+    // Steal the oldest, usually largest, task of another deque
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        auto& q = *queues_[(first + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(q.Mutex);
+        if (!q.Tasks.empty()) {
+            *task = std::move(q.Tasks.front());
+            q.Tasks.pop_front();
+            --pending_;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::RunPendingTask()
+{
+    if (pending_ == 0) return false;
+    const size_t first = currentPool == this ? currentQueue : queues_.size() - 1;
+    std::function<void()> task;
+    if (!PopTask(first, &task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(const size_t idx)
+{
+    currentPool = this;
+    currentQueue = idx;
+    Tracer::SetThreadName("worker " + std::to_string(idx));
+    std::function<void()> task;
+    while (true) {
+        if (PopTask(idx, &task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeUp_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+        if (stop_) return;
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool_(pool), outstanding_(0) {}
+
+TaskGroup::~TaskGroup()
+{
+    // Tasks reference this group, never leave before they finished
+    try {
+        Wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::Run(std::function<void()> task)
+{
+    if (Profiler::Enabled()) task = Profiler::Attach(std::move(task));
+    if (Tracer::Enabled()) task = Tracer::Attach(std::move(task));
+    ++outstanding_;
+    pool_.Submit([this, task]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        // Decrement under the lock, Wait may destroy the group right after
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--outstanding_ == 0) done_.notify_all();
+    });
+}
+
+void TaskGroup::WaitUntil(const std::function<bool()>& ready)
+{
+    if (outstanding_ == 0 || ready()) return;
+    // Helping with pending tasks nests their spans in this one
+    TraceScope wait("wait", "wait");
+    do {
+        if (pool_.RunPendingTask()) continue;
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return outstanding_ == 0; });
+    } while (outstanding_ > 0 && !ready());
+}
+
+void TaskGroup::Wait()
+{
+    WaitUntil([]() { return false; });
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+}
+}  // namespace Util
+}  // namespace PacBio
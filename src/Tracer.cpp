@@ -0,0 +1,188 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <pacbio/io/JsonWriter.h>
+
+#include <pacbio/util/Tracer.h>
+
+namespace PacBio {
+namespace Util {
+namespace {
+struct Event
+{
+    /// Empty for end events
+    std::string Name;
+    const char* Category;
+    int64_t Ns;
+    char Phase;
+};
+
+/// Events of one thread, only written by that thread
+struct ThreadBuffer
+{
+    int Tid;
+    std::string ThreadName;
+    std::vector<Event> Events;
+    /// Indices of the begin events of all open spans
+    std::vector<size_t> Open;
+};
+
+struct Registry
+{
+    std::mutex Mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+    std::chrono::steady_clock::time_point EnabledAt;
+};
+
+Registry& GetRegistry() { return LeakedRegistry<Registry>(); }
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+thread_local std::string localThreadName;
+
+ThreadBuffer& LocalBuffer()
+{
+    if (localBuffer == nullptr) {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        registry.Buffers.emplace_back(new ThreadBuffer);
+        localBuffer = registry.Buffers.back().get();
+        localBuffer->Tid = registry.Buffers.size();
+        localBuffer->ThreadName = localThreadName;
+    }
+    return *localBuffer;
+}
+
+int64_t Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                GetRegistry().EnabledAt)
+        .count();
+}
+}
+
+void Tracer::Enable()
+{
+    if (localThreadName.empty()) SetThreadName("main");
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        registry.EnabledAt = std::chrono::steady_clock::now();
+    }
+    SetEnabled();
+}
+
+void Tracer::Begin(const std::string& name, const char* category)
+{
+    auto& buffer = LocalBuffer();
+    buffer.Open.push_back(buffer.Events.size());
+    buffer.Events.push_back({name, category, Now(), 'B'});
+}
+
+void Tracer::End()
+{
+    auto& buffer = LocalBuffer();
+    if (buffer.Open.empty()) return;
+    const char* category = buffer.Events[buffer.Open.back()].Category;
+    buffer.Open.pop_back();
+    buffer.Events.push_back({std::string(), category, Now(), 'E'});
+}
+
+void Tracer::SetThreadName(const std::string& name)
+{
+    localThreadName = name;
+    if (localBuffer != nullptr) {
+        std::lock_guard<std::mutex> lock(GetRegistry().Mutex);
+        localBuffer->ThreadName = name;
+    }
+}
+
+std::function<void()> Tracer::Attach(std::function<void()> task)
+{
+    const auto& buffer = LocalBuffer();
+    const std::string name = buffer.Open.empty() ? "task" : buffer.Events[buffer.Open.back()].Name;
+    return [name, task]() {
+        TraceScope scope(name, "task");
+        task();
+    };
+}
+
+void Tracer::WriteJson(std::ostream& out)
+{
+    IO::JsonWriter json(out, -1);
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Mutex);
+    const int pid = getpid();
+    json.BeginObject();
+    json.Member("displayTimeUnit", "ms");
+    json.Key("traceEvents").BeginArray();
+    for (const auto& buffer : registry.Buffers) {
+        json.BeginObject();
+        json.Member("name", "thread_name");
+        json.Member("ph", "M");
+        json.Member("pid", pid);
+        json.Member("tid", buffer->Tid);
+        json.Key("args").BeginObject();
+        json.Member("name", buffer->ThreadName.empty() ? "thread " + std::to_string(buffer->Tid)
+                                                       : buffer->ThreadName);
+        json.EndObject();
+        json.EndObject();
+        for (const auto& e : buffer->Events) {
+            json.BeginObject();
+            if (e.Phase == 'B') json.Member("name", e.Name);
+            json.Member("cat", e.Category);
+            json.Member("ph", std::string(1, e.Phase));
+            json.Member("ts", e.Ns / 1e3);
+            json.Member("pid", pid);
+            json.Member("tid", buffer->Tid);
+            json.EndObject();
+        }
+    }
+    json.EndArray();
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+}
+}  // ::PacBio::Util
@@ -36,10 +36,12 @@
 // Author: Armin Töpfer
 
 #include <pacbio/juliet/TransitionTable.h>
+#include <pacbio/util/Stats.h>
 #include <boost/algorithm/string.hpp>
 
 double PacBio::Juliet::TransitionTable::Transition(std::string ref, std::string read)
 {
+    PacBio::Util::Stats::Add(PacBio::Util::Stat::TRANSITION_LOOKUPS);
     boost::erase_all(ref, "-");
     boost::erase_all(read, "-");
 
@@ -0,0 +1,167 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <fstream>
+#include <stdexcept>
+
+#include <htslib/bgzf.h>
+#include <htslib/tbx.h>
+
+#include <pacbio/io/VcfWriter.h>
+
+namespace PacBio {
+namespace IO {
+namespace {
+// One BGZF block holds at most 64 KiB
+const size_t flushThreshold = 1 << 16;
+
+bool EndsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}
+
+/// Either a plain file or a BGZF stream
+class VcfWriter::Output
+{
+public:
+    Output(const std::string& filename, const bool compressed)
+    {
+        if (compressed) {
+            bgzf_ = bgzf_open(filename.c_str(), "w");
+            if (!bgzf_) throw std::runtime_error("Could not open " + filename);
+        } else {
+            plain_.open(filename);
+            if (!plain_) throw std::runtime_error("Could not open " + filename);
+        }
+    }
+    ~Output()
+    {
+        if (bgzf_) bgzf_close(bgzf_);
+    }
+
+    void Write(const std::string& data)
+    {
+        if (bgzf_) {
+            if (bgzf_write(bgzf_, data.data(), data.size()) < 0)
+                throw std::runtime_error("Could not write BGZF block");
+        } else {
+            plain_.write(data.data(), data.size());
+            if (!plain_) throw std::runtime_error("Could not write VCF");
+        }
+    }
+
+    void Close()
+    {
+        if (bgzf_) {
+            const int ret = bgzf_close(bgzf_);
+            bgzf_ = nullptr;
+            if (ret != 0) throw std::runtime_error("Could not close BGZF file");
+        } else {
+            plain_.close();
+        }
+    }
+
+private:
+    BGZF* bgzf_ = nullptr;
+    std::ofstream plain_;
+};
+
+VcfWriter::VcfWriter(const std::string& filename, const std::vector<std::string>& metaLines)
+    : filename_(filename)
+    , compressed_(EndsWith(filename, ".gz"))
+    , out_(new Output(filename, compressed_))
+{
+    buffer_.reserve(flushThreshold + 4096);
+    buffer_ += "##fileformat=VCFv4.2\n";
+    for (const auto& line : metaLines)
+        buffer_ += "##" + line + '\n';
+    buffer_ += "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+}
+
+VcfWriter::~VcfWriter() = default;
+
+void VcfWriter::Add(Record record)
+{
+    const int pos = record.Pos;
+    pending_.emplace(pos, std::move(record));
+}
+
+void VcfWriter::Flush(const int position)
+{
+    const auto end = pending_.lower_bound(position);
+    for (auto it = pending_.begin(); it != end; ++it)
+        WriteRecord(it->second);
+    pending_.erase(pending_.begin(), end);
+}
+
+void VcfWriter::Close()
+{
+    if (!out_) return;
+    for (const auto& pos_record : pending_)
+        WriteRecord(pos_record.second);
+    pending_.clear();
+    WriteBuffer();
+    out_->Close();
+    out_.reset();
+    if (compressed_ && tbx_index_build(filename_.c_str(), 0, &tbx_conf_vcf) != 0)
+        throw std::runtime_error("Could not build tabix index of " + filename_);
+}
+
+void VcfWriter::WriteRecord(const Record& record)
+{
+    buffer_ += record.Chrom;
+    buffer_ += '\t';
+    buffer_ += std::to_string(record.Pos);
+    buffer_ += "\t.\t";
+    buffer_ += record.Ref;
+    buffer_ += '\t';
+    buffer_ += record.Alt;
+    buffer_ += "\t.\tPASS\t";
+    buffer_ += record.Info.empty() ? "." : record.Info;
+    buffer_ += '\n';
+    if (buffer_.size() >= flushThreshold) WriteBuffer();
+}
+
+void VcfWriter::WriteBuffer()
+{
+    out_->Write(buffer_);
+    buffer_.clear();
+}
+}
+}  // ::PacBio::IO
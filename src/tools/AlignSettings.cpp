@@ -0,0 +1,154 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/align/AlignSettings.h>
+
+namespace PacBio {
+namespace Align {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+const PlainOption BandWidth{
+    "band_width",
+    { "band-width" },
+    "Band Width",
+    "Number of reference bases the alignment may deviate from the seed diagonal.",
+    CLI::Option::IntType(100)
+};
+const PlainOption MinSeeds{
+    "min_seeds",
+    { "min-seeds" },
+    "Minimal Seeds",
+    "Minimal number of minimizer seeds to align a read.",
+    CLI::Option::IntType(3)
+};
+// clang-format on
+}  // namespace OptionNames
+
+AlignSettings::AlignSettings(const PacBio::CLI::Results& options)
+    : NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
+{
+    const auto& args = options.PositionalArguments();
+    if (args.size() != 3)
+        throw std::runtime_error("Align needs one BAM input, one reference, and one output!");
+    InputFile = args[0];
+    ReferenceFile = args[1];
+    OutputFile = args[2];
+
+    Config.BandWidth = options[OptionNames::BandWidth];
+    Config.MinSeeds = options[OptionNames::MinSeeds];
+}
+
+PacBio::CLI::Interface AlignSettings::CreateCLI()
+{
+    using Task = PacBio::CLI::ToolContract::Task;
+
+    PacBio::CLI::Interface i{
+        "minorseq align", "Align CCS reads to a reference, writes sorted and indexed BAM",
+        PacBio::MinorseqVersion() + " (commit " + PacBio::MinorseqGitSha1() + ")"};
+
+    i.AddHelpOption();     // use built-in help output
+    i.AddVersionOption();  // use built-in version output
+
+    // clang-format off
+    i.AddPositionalArguments({
+        {"bam", "Unaligned CCS BAM or ConsensusReadSet", "FILE"},
+        {"ref", "Reference Fasta or ReferenceSet", "FILE"},
+        {"output", "Output BAM", "FILE"}
+    });
+
+    i.AddOptions(
+    {
+        OptionNames::NumThreads,
+        OptionNames::BandWidth,
+        OptionNames::MinSeeds
+    });
+
+    const std::string id = "minorseq.tasks.align";
+    Task tcTask(id);
+    tcTask.AddOption(OptionNames::BandWidth);
+    tcTask.AddOption(OptionNames::MinSeeds);
+    tcTask.NumProcessors(Task::MAX_NPROC);
+
+    tcTask.InputFileTypes({
+        {
+            "ccs_input",
+            "ConsensusReadSet",
+            "Unaligned .bam file",
+            "PacBio.DataSet.ConsensusReadSet"
+        },
+        {
+            "reference",
+            "Fasta reference",
+            "Fasta reference",
+            "PacBio.DataSet.ReferenceSet"
+        }
+    });
+
+    tcTask.OutputFileTypes({
+        {
+            "bam_output",
+            "Aligned BAM",
+            "Coordinate sorted BAM alignment generated by minorseq align",
+            "PacBio.FileTypes.BAM",
+            "align"
+        }
+    });
+
+    CLI::ToolContract::Config tcConfig(tcTask);
+    i.EnableToolContract(tcConfig);
+
+    // clang-format on
+
+    return i;
+}
+}
+}  // ::PacBio::Align
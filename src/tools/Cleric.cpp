@@ -46,11 +46,23 @@
 
 #include <pacbio/align/SimdAlignment.h>
 #include <pacbio/io/BamParser.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/cleric/ReferenceAlignmentCache.h>
 
 #include <pacbio/cleric/Cleric.h>
 
 namespace PacBio {
 namespace Cleric {
+namespace {
+std::string RemoveGaps(const std::string& input)
+{
+    std::string seq = input;
+    seq.erase(std::remove(seq.begin(), seq.end(), '-'), seq.end());
+    return seq;
+}
+}
+
 void Cleric::Align(const std::string& fromReference, const std::string& toReference,
                    std::string* fromReferenceAligned, std::string* toReferenceAligned)
 {
@@ -60,704 +72,738 @@ void Cleric::Align(const std::string& fromReference, const std::string& toRefere
     *toReferenceAligned = align.Query;
 }
 
-void Cleric::Convert(std::string outputFile)
+void Cleric::Liftover()
 {
-    using BAM::Cigar;
-    using BAM::CigarOperation;
-    using BAM::CigarOperationType;
-
-    // Get data source
-    auto query = IO::BamQuery(alignmentPath_);
-    std::unique_ptr<BAM::BamWriter> out;
-
-    auto ProcessHeaderAndCreateBamWriter = [this, &outputFile, &out](const BAM::BamRecord& read) {
-        BAM::BamHeader h = read.Header().DeepCopy();
-
-        if (h.Sequences().empty())
-            throw std::runtime_error("Could not find reference sequence name");
-
-        const auto localFromReferenceName = h.Sequences().begin()->Name();
-        if (localFromReferenceName != fromReferenceName_)
-            throw std::runtime_error("Internal error. Reference name mismatches");
-
-        const auto RemoveGaps = [](const std::string& input) {
-            std::string seq = input;
-            seq.erase(std::remove(seq.begin(), seq.end(), '-'), seq.end());
-            return seq;
-        };
-        toReferenceGapless_ = RemoveGaps(toReferenceSequence_);
-        fromReferenceGapless_ = RemoveGaps(fromReferenceSequence_);
+    toReferenceGapless_ = RemoveGaps(toReferenceSequence_);
+    fromReferenceGapless_ = RemoveGaps(fromReferenceSequence_);
 
-        for (size_t pos = 0, i = 0; i < fromReferenceSequence_.size(); ++i) {
-            if (fromReferenceSequence_.at(i) != '-') {
-                if (sam_pos_to_fasta_pos.find(i) == sam_pos_to_fasta_pos.cend()) {
-                    sam_pos_to_fasta_pos.emplace(pos, i);
-                }
-                ++pos;
+    for (size_t pos = 0, i = 0; i < fromReferenceSequence_.size(); ++i) {
+        if (fromReferenceSequence_.at(i) != '-') {
+            if (sam_pos_to_fasta_pos.find(i) == sam_pos_to_fasta_pos.cend()) {
+                sam_pos_to_fasta_pos.emplace(pos, i);
             }
+            ++pos;
         }
+    }
 
-        for (size_t pos = 0, i = 0; i < toReferenceSequence_.size(); ++i) {
-            if (toReferenceSequence_.at(i) != '-') {
-                if (fasta_pos_to_sam_pos.find(i) == fasta_pos_to_sam_pos.cend()) {
-                    fasta_pos_to_sam_pos.emplace(i, pos);
-                }
-                ++pos;
+    for (size_t pos = 0, i = 0; i < toReferenceSequence_.size(); ++i) {
+        if (toReferenceSequence_.at(i) != '-') {
+            if (fasta_pos_to_sam_pos.find(i) == fasta_pos_to_sam_pos.cend()) {
+                fasta_pos_to_sam_pos.emplace(i, pos);
             }
+            ++pos;
         }
+    }
+}
 
-        h.ClearSequences();
-        auto bamRefSequence =
-            BAM::SequenceInfo(toReferenceName_, std::to_string(toReferenceGapless_.size()));
-        bamRefSequence.Checksum(BAM::MD5Hash(toReferenceSequence_));
-        h.AddSequence(bamRefSequence);
-
-        const bool isXml = Utility::FileExtension(outputFile) == "xml";
-        if (isXml) boost::replace_last(outputFile, ".consensusalignmentset.xml", ".bam");
+void Cleric::AlignCached(const std::string& fromReference, const std::string& toReference,
+                         const std::string& cacheDir)
+{
+    ReferenceAlignmentCache cache(cacheDir);
+    const auto fromMD5 = BAM::MD5Hash(fromReference);
+    const auto toMD5 = BAM::MD5Hash(toReference);
+
+    ReferenceAlignment entry;
+    if (cache.Load(fromMD5, toMD5, &entry)) {
+        fromReferenceSequence_ = std::move(entry.FromReferenceAligned);
+        toReferenceSequence_ = std::move(entry.ToReferenceAligned);
+        sam_pos_to_fasta_pos = std::move(entry.SamPosToFastaPos);
+        fasta_pos_to_sam_pos = std::move(entry.FastaPosToSamPos);
+        toReferenceGapless_ = RemoveGaps(toReferenceSequence_);
+        fromReferenceGapless_ = RemoveGaps(fromReferenceSequence_);
+        return;
+    }
 
-        // Write Dataset
-        using BAM::DataSet;
-        const std::string metatype = "PacBio.AlignmentFile.AlignmentBamFile";
-        DataSet clericSet(DataSet::TypeEnum::ALIGNMENT);
-        BAM::ExternalResource resource(metatype, outputFile);
+    Align(fromReference, toReference, &fromReferenceSequence_, &toReferenceSequence_);
+    Liftover();
 
-        BAM::FileIndex pbi("PacBio.Index.PacBioIndex", outputFile + ".pbi");
-        resource.FileIndices().Add(pbi);
+    entry.FromReferenceAligned = fromReferenceSequence_;
+    entry.ToReferenceAligned = toReferenceSequence_;
+    entry.SamPosToFastaPos = sam_pos_to_fasta_pos;
+    entry.FastaPosToSamPos = fasta_pos_to_sam_pos;
+    cache.Store(fromMD5, toMD5, entry);
+}
 
-        clericSet.ExternalResources().Add(resource);
-        clericSet.Name(clericSet.TimeStampedName());
+BAM::BamHeader Cleric::ConvertHeader(const BAM::BamHeader& header) const
+{
+    BAM::BamHeader h = header.DeepCopy();
 
-        const auto outputPrefix = outputFile.substr(0, outputFile.size() - 4);
-        std::ofstream clericDSout(outputPrefix + ".consensusalignmentset.xml");
-        clericSet.SaveToStream(clericDSout);
+    if (h.Sequences().empty()) throw std::runtime_error("Could not find reference sequence name");
 
-        out.reset(new BAM::BamWriter(outputFile, h));
-    };
+    const auto localFromReferenceName = h.Sequences().begin()->Name();
+    if (localFromReferenceName != fromReferenceName_)
+        throw std::runtime_error("Internal error. Reference name mismatches");
 
-    // Convert and write to BAM
-    for (auto read : *query) {
-        if (!out) ProcessHeaderAndCreateBamWriter(read);
-        std::string source_str = fromReferenceSequence_;
-        std::string dest_str = toReferenceSequence_;
+    h.ClearSequences();
+    auto bamRefSequence =
+        BAM::SequenceInfo(toReferenceName_, std::to_string(toReferenceGapless_.size()));
+    bamRefSequence.Checksum(BAM::MD5Hash(toReferenceSequence_));
+    h.AddSequence(bamRefSequence);
+    return h;
+}
 
-        // Expand RLE cigar to flat vector
-        std::string expanded_cigar_ops;
-        for (const auto& c : read.CigarData(false))
-            for (size_t i = 0; i < c.Length(); ++i)
-                expanded_cigar_ops += c.Char();
-        expanded_cigar_ops += "YZ";
+void Cleric::Convert(BAM::BamRecord* read) const
+{
+    using BAM::Cigar;
+    using BAM::CigarOperation;
+    using BAM::CigarOperationType;
 
-        CigarOperation old_cigar_state;  // UNKNOW_OP
-        CigarOperation new_cigar_state;  // UNKNOW_OP
+    std::string source_str = fromReferenceSequence_;
+    std::string dest_str = toReferenceSequence_;
 
-        bool found_start = false;
-        int pos_in_read = 0;
-        int pos_in_cigar = 0;
-        int pos_in_source_ref = sam_pos_to_fasta_pos.at(read.ReferenceStart());
+    // Expand RLE cigar to flat vector
+    std::string expanded_cigar_ops;
+    for (const auto& c : read->CigarData(false))
+        for (size_t i = 0; i < c.Length(); ++i)
+            expanded_cigar_ops += c.Char();
+    expanded_cigar_ops += "YZ";
 
-        Cigar new_cigar_tuple;
+    CigarOperation old_cigar_state;  // UNKNOW_OP
+    CigarOperation new_cigar_state;  // UNKNOW_OP
 
-        int new_sam_start = 0;
-        int pos_in_dest_ref = 0;
+    bool found_start = false;
+    int pos_in_read = 0;
+    int pos_in_cigar = 0;
+    int pos_in_source_ref = sam_pos_to_fasta_pos.at(read->ReferenceStart());
 
-        while (pos_in_cigar < static_cast<int>(expanded_cigar_ops.size())) {
-            char op = expanded_cigar_ops.at(pos_in_cigar);
+    Cigar new_cigar_tuple;
 
-            CigarOperation new_state;  // UNKNOWN_OP
+    int new_sam_start = 0;
+    int pos_in_dest_ref = 0;
 
-            bool isFirstCigarAfterEnd = false;
-            bool isSecondCigarAfterEnd = false;
+    while (pos_in_cigar < static_cast<int>(expanded_cigar_ops.size())) {
+        char op = expanded_cigar_ops.at(pos_in_cigar);
 
-            switch (op) {
-                case 'M':
-                case '=':
-                case 'X':
-                    if (!found_start) {
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            // Dest:   A---AAA
-                            // Source: AAA-AAA
-                            // Read:     A-AAA
-                            //            ^
+        CigarOperation new_state;  // UNKNOWN_OP
 
-                            ++pos_in_source_ref;
-                            continue;
-                        }
+        bool isFirstCigarAfterEnd = false;
+        bool isSecondCigarAfterEnd = false;
 
-                        // don't have a start POS yet
-                        if (fasta_pos_to_sam_pos.find(pos_in_source_ref) !=
-                            fasta_pos_to_sam_pos.cend()) {
-                            new_sam_start = fasta_pos_to_sam_pos.at(pos_in_source_ref);
-                            // Dest:   ---AAA
-                            // Source: AAAAAA
-                            // Read:      AAA
-                            //            ^
+        switch (op) {
+            case 'M':
+            case '=':
+            case 'X':
+                if (!found_start) {
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        // Dest:   A---AAA
+                        // Source: AAA-AAA
+                        // Read:     A-AAA
+                        //            ^
 
-                            new_state = newMatch_;
-                            pos_in_dest_ref = pos_in_source_ref;
-                            found_start = true;
-                            ++pos_in_dest_ref;
-                        } else {
-                            // Dest:   ----AA
-                            // Source: AAAAAA
-                            // Read:      AAA
-                            //            ^
+                        ++pos_in_source_ref;
+                        continue;
+                    }
 
-                            // left Clip
-                            new_state = newSoft_;
-                        }
+                    // don't have a start POS yet
+                    if (fasta_pos_to_sam_pos.find(pos_in_source_ref) !=
+                        fasta_pos_to_sam_pos.cend()) {
+                        new_sam_start = fasta_pos_to_sam_pos.at(pos_in_source_ref);
+                        // Dest:   ---AAA
+                        // Source: AAAAAA
+                        // Read:      AAA
+                        //            ^
 
-                        ++pos_in_cigar;
-                        ++pos_in_read;
-                        ++pos_in_source_ref;
+                        new_state = newMatch_;
+                        pos_in_dest_ref = pos_in_source_ref;
+                        found_start = true;
+                        ++pos_in_dest_ref;
                     } else {
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA-AAA
-                                // Source: AAA-AAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                continue;
-                            } else {
-                                // Dest:   AAAAAAA
-                                // Source: AAA-AAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                // Deletion
-                                new_state = newDel_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                            }
-                        } else {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA-AAA
-                                // Source: AAAAAAA
-                                // Read:   AAAAAAA
-                                //            ^
-
-                                // Insertion
-                                new_state = newIns_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                ++pos_in_cigar;
-                                ++pos_in_read;
-                            } else {
-                                // Dest:   AAAAAAA
-                                // Source: AAAAAAA
-                                // Read:   AAAAAAA
-                                //            ^
-
-                                new_state = newMatch_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                ++pos_in_cigar;
-                                ++pos_in_read;
-                            }
-                        }
+                        // Dest:   ----AA
+                        // Source: AAAAAA
+                        // Read:      AAA
+                        //            ^
+
+                        // left Clip
+                        new_state = newSoft_;
                     }
-                    break;
-                case 'I':
-                    if (!found_start) {
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            // Dest:   A---AAA
+
+                    ++pos_in_cigar;
+                    ++pos_in_read;
+                    ++pos_in_source_ref;
+                } else {
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA-AAA
                             // Source: AAA-AAA
-                            // Read:     AAAAA
+                            // Read:   AAA-AAA
                             //            ^
 
                             ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
                             continue;
-                        }
-
-                        // Dest:   -- AAA
-                        // Source: AA AAA
-                        // Read:    AGAAA
-                        //           ^
+                        } else {
+                            // Dest:   AAAAAAA
+                            // Source: AAA-AAA
+                            // Read:   AAA-AAA
+                            //            ^
 
-                        // left Clip
-                        new_state = newSoft_;
+                            // Deletion
+                            new_state = newDel_;
 
-                        ++pos_in_cigar;
-                        ++pos_in_read;
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                        }
                     } else {
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA -AAA
-                                // Source: AAA -AAA
-                                // Read:   AAAA AAA
-                                //            ^
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                continue;
-                            } else {
-                                // Dest:   AAA AAAA
-                                // Source: AAA -AAA
-                                // Read:   AAAA AAA
-                                //            ^
-
-                                new_state = newMatch_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                ++pos_in_cigar;
-                                ++pos_in_read;
-                            }
-                        } else {
-                            // Dest:   AAA -AAA
-                            // Source: AAA AAAA
-                            // Read:   AAAA AAA
-                            //            ^
-                            // OR
-                            // Dest:   AAA AAA
-                            // Source: AAA AAA
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA-AAA
+                            // Source: AAAAAAA
                             // Read:   AAAAAAA
                             //            ^
 
                             // Insertion
                             new_state = newIns_;
 
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
                             ++pos_in_cigar;
                             ++pos_in_read;
-                        }
-                    }
-                    break;
-                case 'N':
-                case 'D':
-                    if (!found_start) {
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            // Dest:   A---AAA
-                            // Source: AAA-AAA
-                            // Read:     A--AA
+                        } else {
+                            // Dest:   AAAAAAA
+                            // Source: AAAAAAA
+                            // Read:   AAAAAAA
                             //            ^
 
+                            new_state = newMatch_;
+
                             ++pos_in_source_ref;
-                            continue;
+                            ++pos_in_dest_ref;
+                            ++pos_in_cigar;
+                            ++pos_in_read;
                         }
+                    }
+                }
+                break;
+            case 'I':
+                if (!found_start) {
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        // Dest:   A---AAA
+                        // Source: AAA-AAA
+                        // Read:     AAAAA
+                        //            ^
 
-                        // Dest:   ---AAA
-                        // Source: AAAAAA
-                        // Read:    A-AAA
-                        //           ^
-
-                        ++pos_in_cigar;
                         ++pos_in_source_ref;
                         continue;
-                    } else {
-                        // have start POS
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA-AAA
-                                // Source: AAA-AAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                continue;
-                            } else {
-                                // Dest:   AAAAAAA
-                                // Source: AAA-AAA
-                                // Read:   AAA--AA
-                                //            ^
-
-                                // Deletion
-                                new_state = newDel_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                            }
-                        } else {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA-AAA
-                                // Source: AAAAAAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                // Padded deletion
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                ++pos_in_cigar;
-
-                                new_state = newPad_;
-                            } else {
-                                // Dest:   AAAAAAA
-                                // Source: AAAAAAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                // Deletion
-                                new_state = newDel_;
-
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                                ++pos_in_cigar;
-                            }
-                        }
                     }
-                    break;
-                case 'S':
+
+                    // Dest:   -- AAA
+                    // Source: AA AAA
+                    // Read:    AGAAA
+                    //           ^
+
+                    // left Clip
                     new_state = newSoft_;
 
                     ++pos_in_cigar;
                     ++pos_in_read;
-                    break;
-                case 'H':
-                    new_state = CigarOperation(CigarOperationType::HARD_CLIP, 1);
+                } else {
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA -AAA
+                            // Source: AAA -AAA
+                            // Read:   AAAA AAA
+                            //            ^
 
-                    ++pos_in_cigar;
-                    break;
-                case 'P':
-                    if (found_start) {
-                        // Dest:   ---AAA
-                        // Source: AAAAAA
-                        // Read:    A-AAA
-                        //           ^
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                            continue;
+                        } else {
+                            // Dest:   AAA AAAA
+                            // Source: AAA -AAA
+                            // Read:   AAAA AAA
+                            //            ^
+
+                            new_state = newMatch_;
+
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                            ++pos_in_cigar;
+                            ++pos_in_read;
+                        }
+                    } else {
+                        // Dest:   AAA -AAA
+                        // Source: AAA AAAA
+                        // Read:   AAAA AAA
+                        //            ^
+                        // OR
+                        // Dest:   AAA AAA
+                        // Source: AAA AAA
+                        // Read:   AAAAAAA
+                        //            ^
+
+                        // Insertion
+                        new_state = newIns_;
 
                         ++pos_in_cigar;
+                        ++pos_in_read;
+                    }
+                }
+                break;
+            case 'N':
+            case 'D':
+                if (!found_start) {
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        // Dest:   A---AAA
+                        // Source: AAA-AAA
+                        // Read:     A--AA
+                        //            ^
+
                         ++pos_in_source_ref;
                         continue;
+                    }
 
-                    } else {
-                        // have start POS
-                        if (source_str.at(pos_in_source_ref) == '-') {
-                            if (dest_str.at(pos_in_dest_ref) == '-') {
-                                // Dest:   AAA-AAA
-                                // Source: AAA-AAA
-                                // Read:   AAA-AAA
-                                //            ^
-
-                                // Padded deletion
-                                ++pos_in_cigar;
-
-                                new_state = newPad_;
-                            } else {
-                                // Dest:   AAAAAAA
-                                // Source: AAA-AAA
-                                // Read:   AAA--AA
-                                //            ^
-
-                                // Deletion
-                                new_state = newDel_;
-
-                                ++pos_in_cigar;
-                                ++pos_in_source_ref;
-                                ++pos_in_dest_ref;
-                            }
+                    // Dest:   ---AAA
+                    // Source: AAAAAA
+                    // Read:    A-AAA
+                    //           ^
+
+                    ++pos_in_cigar;
+                    ++pos_in_source_ref;
+                    continue;
+                } else {
+                    // have start POS
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA-AAA
+                            // Source: AAA-AAA
+                            // Read:   AAA-AAA
+                            //            ^
+
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                            continue;
                         } else {
-                            // Dest:   AAA--AAA
-                            // Source: AAAAAAAA
-                            // Read:   AAA-AAAA
+                            // Dest:   AAAAAAA
+                            // Source: AAA-AAA
+                            // Read:   AAA--AA
                             //            ^
-                            // OR
-                            // Dest:   AAA AAAA
-                            // Source: AAA AAAA
-                            // Read:   AAA-AAAA
+
+                            // Deletion
+                            new_state = newDel_;
+
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                        }
+                    } else {
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA-AAA
+                            // Source: AAAAAAA
+                            // Read:   AAA-AAA
                             //            ^
 
                             // Padded deletion
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
                             ++pos_in_cigar;
 
                             new_state = newPad_;
+                        } else {
+                            // Dest:   AAAAAAA
+                            // Source: AAAAAAA
+                            // Read:   AAA-AAA
+                            //            ^
+
+                            // Deletion
+                            new_state = newDel_;
+
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                            ++pos_in_cigar;
                         }
                     }
-                    break;
-                case 'Y':
-                    ++pos_in_cigar;
-                    isFirstCigarAfterEnd = true;
-                    break;
-                case 'Z':
+                }
+                break;
+            case 'S':
+                new_state = newSoft_;
+
+                ++pos_in_cigar;
+                ++pos_in_read;
+                break;
+            case 'H':
+                new_state = CigarOperation(CigarOperationType::HARD_CLIP, 1);
+
+                ++pos_in_cigar;
+                break;
+            case 'P':
+                if (found_start) {
+                    // Dest:   ---AAA
+                    // Source: AAAAAA
+                    // Read:    A-AAA
+                    //           ^
+
                     ++pos_in_cigar;
-                    isSecondCigarAfterEnd = true;
-                    break;
-                default:
-                    throw std::runtime_error("UNKNOWN CIGAR");
-            }
+                    ++pos_in_source_ref;
+                    continue;
+
+                } else {
+                    // have start POS
+                    if (source_str.at(pos_in_source_ref) == '-') {
+                        if (dest_str.at(pos_in_dest_ref) == '-') {
+                            // Dest:   AAA-AAA
+                            // Source: AAA-AAA
+                            // Read:   AAA-AAA
+                            //            ^
 
-            // If we reached Z, we have processed the CIGAR and can push the
-            // lastest cigar operation.
-            if (isSecondCigarAfterEnd) new_cigar_tuple.push_back(old_cigar_state);
+                            // Padded deletion
+                            ++pos_in_cigar;
 
-            if (new_state.Type() != new_cigar_state.Type()) {
-                // I ...... Y (end)
-                if (new_state.Type() == CigarOperationType::UNKNOWN_OP && isFirstCigarAfterEnd &&
-                    new_cigar_state.Type() == CigarOperationType::INSERTION) {
-                    new_cigar_state.Type(CigarOperationType::SOFT_CLIP);
-                }
+                            new_state = newPad_;
+                        } else {
+                            // Dest:   AAAAAAA
+                            // Source: AAA-AAA
+                            // Read:   AAA--AA
+                            //            ^
 
-                // have to rewrite CIGAR tuples if, a D and I operations are adjacent
-                // D + I
-                if (old_cigar_state.Type() == CigarOperationType::DELETION &&
-                    new_cigar_state.Type() == CigarOperationType::INSERTION) {
-                    const int num_del = old_cigar_state.Length();
-                    const int num_insert = new_cigar_state.Length();
-                    const int num_match = std::min(num_del, num_insert);
-
-                    if (num_del == num_insert) {
-                        // Dest:   GC AA-- TC      GC AA TC
-                        // Read:   GC --AA TC  ->  GC AA TC
-                        //            DDII            MM
-                        old_cigar_state = CigarOperation();
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
-
-                    } else if (num_del > num_insert) {
-                        // Dest:   GC AAA-- TC      GC AAA TC
-                        // Read:   GC ---AA TC  ->  GC -AA TC
-                        //            DDDII            DMM
-                        old_cigar_state =
-                            CigarOperation(CigarOperationType::DELETION, num_del - num_match);
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+                            // Deletion
+                            new_state = newDel_;
 
+                            ++pos_in_cigar;
+                            ++pos_in_source_ref;
+                            ++pos_in_dest_ref;
+                        }
                     } else {
-                        // Dest:   GC AA--- TC      GC AA- TC
-                        // Read:   GC --AAA TC  ->  GC AAA TC
-                        //            DDIII            MMI
-                        old_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::INSERTION, num_insert - num_match);
+                        // Dest:   AAA--AAA
+                        // Source: AAAAAAAA
+                        // Read:   AAA-AAAA
+                        //            ^
+                        // OR
+                        // Dest:   AAA AAAA
+                        // Source: AAA AAAA
+                        // Read:   AAA-AAAA
+                        //            ^
+
+                        // Padded deletion
+                        ++pos_in_cigar;
+
+                        new_state = newPad_;
                     }
                 }
+                break;
+            case 'Y':
+                ++pos_in_cigar;
+                isFirstCigarAfterEnd = true;
+                break;
+            case 'Z':
+                ++pos_in_cigar;
+                isSecondCigarAfterEnd = true;
+                break;
+            default:
+                throw std::runtime_error("UNKNOWN CIGAR");
+        }
 
-                // I + D
-                if (old_cigar_state.Type() == CigarOperationType::INSERTION &&
-                    new_cigar_state.Type() == CigarOperationType::DELETION) {
-                    const int num_insert = old_cigar_state.Length();
-                    const int num_del = new_cigar_state.Length();
-                    const int num_match = std::min(num_del, num_insert);
-
-                    if (num_del == num_insert) {
-                        // Dest:   GC --AA TC  ->  GC AA TC
-                        // Read:   GC AA-- TC      GC AA TC
-                        //            IIDD            MM
-                        old_cigar_state = CigarOperation();
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
-
-                    } else if (num_del > num_insert) {
-                        // Dest:   GC --AAA TC  ->  GC AAA TC
-                        // Read:   GC AA--- TC      GC AA- TC
-                        //            IIDDD            MMD
-                        old_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::DELETION, num_del - num_match);
+        // If we reached Z, we have processed the CIGAR and can push the
+        // lastest cigar operation.
+        if (isSecondCigarAfterEnd) new_cigar_tuple.push_back(old_cigar_state);
 
-                    } else {
-                        // Dest:   GC ---AA TC  ->  GC -AA TC
-                        // Read:   GC AAA-- TC      GC AAA TC
-                        //            IIIDD            IMM
-                        old_cigar_state =
-                            CigarOperation(CigarOperationType::INSERTION, num_insert - num_match);
-                        new_cigar_state =
-                            CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
-                    }
-                }
+        if (new_state.Type() != new_cigar_state.Type()) {
+            // I ...... Y (end)
+            if (new_state.Type() == CigarOperationType::UNKNOWN_OP && isFirstCigarAfterEnd &&
+                new_cigar_state.Type() == CigarOperationType::INSERTION) {
+                new_cigar_state.Type(CigarOperationType::SOFT_CLIP);
+            }
 
-                if ((old_cigar_state.Type() != CigarOperationType::UNKNOWN_OP)) {
-                    new_cigar_tuple.push_back(old_cigar_state);
+            // have to rewrite CIGAR tuples if, a D and I operations are adjacent
+            // D + I
+            if (old_cigar_state.Type() == CigarOperationType::DELETION &&
+                new_cigar_state.Type() == CigarOperationType::INSERTION) {
+                const int num_del = old_cigar_state.Length();
+                const int num_insert = new_cigar_state.Length();
+                const int num_match = std::min(num_del, num_insert);
+
+                if (num_del == num_insert) {
+                    // Dest:   GC AA-- TC      GC AA TC
+                    // Read:   GC --AA TC  ->  GC AA TC
+                    //            DDII            MM
+                    old_cigar_state = CigarOperation();
+                    new_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+
+                } else if (num_del > num_insert) {
+                    // Dest:   GC AAA-- TC      GC AAA TC
+                    // Read:   GC ---AA TC  ->  GC -AA TC
+                    //            DDDII            DMM
+                    old_cigar_state =
+                        CigarOperation(CigarOperationType::DELETION, num_del - num_match);
+                    new_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+
+                } else {
+                    // Dest:   GC AA--- TC      GC AA- TC
+                    // Read:   GC --AAA TC  ->  GC AAA TC
+                    //            DDIII            MMI
+                    old_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+                    new_cigar_state =
+                        CigarOperation(CigarOperationType::INSERTION, num_insert - num_match);
                 }
-                // swap old and new state
-                old_cigar_state = new_cigar_state;
-                new_cigar_state = CigarOperation(new_state.Type(), 1);
-            } else {
-                new_cigar_state.Length(new_cigar_state.Length() + 1);
             }
-        }
 
-        //////////////////////////////////////
-        // POST-PROCESSING                  //
-        //////////////////////////////////////
-        // check left flanking region + merge M-M pairs
-        int i = 0;
-        while (i < static_cast<int>(new_cigar_tuple.size()) - 1) {
-            CigarOperation left_op = new_cigar_tuple.at(i);
-            CigarOperation right_op = new_cigar_tuple.at(i + 1);
-
-            // clang-format off
-            // M + M:
-            if (left_op.Type() == CigarOperationType::SEQUENCE_MATCH && right_op.Type() == CigarOperationType::SEQUENCE_MATCH) {
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::SEQUENCE_MATCH, left_op.Length() + right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // S + I:
-            else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::INSERTION) {
-                new_cigar_tuple[i] = CigarOperation(
-                    CigarOperationType::SOFT_CLIP, left_op.Length() + right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // S + D:
-            else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::DELETION) {
-                new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // S + P:
-            else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::PADDING) {
-                new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // H + I:
-            else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::INSERTION) {
-                new_cigar_tuple[i + 1] = CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
-                ++i;
-            }
-            // H + D:
-            else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::DELETION) {
-                new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, left_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+            // I + D
+            if (old_cigar_state.Type() == CigarOperationType::INSERTION &&
+                new_cigar_state.Type() == CigarOperationType::DELETION) {
+                const int num_insert = old_cigar_state.Length();
+                const int num_del = new_cigar_state.Length();
+                const int num_match = std::min(num_del, num_insert);
+
+                if (num_del == num_insert) {
+                    // Dest:   GC --AA TC  ->  GC AA TC
+                    // Read:   GC AA-- TC      GC AA TC
+                    //            IIDD            MM
+                    old_cigar_state = CigarOperation();
+                    new_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+
+                } else if (num_del > num_insert) {
+                    // Dest:   GC --AAA TC  ->  GC AAA TC
+                    // Read:   GC AA--- TC      GC AA- TC
+                    //            IIDDD            MMD
+                    old_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+                    new_cigar_state =
+                        CigarOperation(CigarOperationType::DELETION, num_del - num_match);
+
+                } else {
+                    // Dest:   GC ---AA TC  ->  GC -AA TC
+                    // Read:   GC AAA-- TC      GC AAA TC
+                    //            IIIDD            IMM
+                    old_cigar_state =
+                        CigarOperation(CigarOperationType::INSERTION, num_insert - num_match);
+                    new_cigar_state = CigarOperation(CigarOperationType::SEQUENCE_MATCH, num_match);
+                }
             }
-            // H + P:
-            else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::PADDING) {
-                new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, left_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            // H + S:
-            } else {
-                ++i;
+
+            if ((old_cigar_state.Type() != CigarOperationType::UNKNOWN_OP)) {
+                new_cigar_tuple.push_back(old_cigar_state);
             }
-            // clang-format on
+            // swap old and new state
+            old_cigar_state = new_cigar_state;
+            new_cigar_state = CigarOperation(new_state.Type(), 1);
+        } else {
+            new_cigar_state.Length(new_cigar_state.Length() + 1);
         }
+    }
 
-        // check right flanking region
-        i = new_cigar_tuple.size() - 2;
-        // cant_stop = True
-        while (i >= 0) {
-            // cant_stop = False
+    //////////////////////////////////////
+    // POST-PROCESSING                  //
+    //////////////////////////////////////
+    // check left flanking region + merge M-M pairs
+    int i = 0;
+    while (i < static_cast<int>(new_cigar_tuple.size()) - 1) {
+        CigarOperation left_op = new_cigar_tuple.at(i);
+        CigarOperation right_op = new_cigar_tuple.at(i + 1);
+
+        // clang-format off
+        // M + M:
+        if (left_op.Type() == CigarOperationType::SEQUENCE_MATCH && right_op.Type() == CigarOperationType::SEQUENCE_MATCH) {
+            new_cigar_tuple[i] =
+                CigarOperation(CigarOperationType::SEQUENCE_MATCH, left_op.Length() + right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // S + I:
+        else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::INSERTION) {
+            new_cigar_tuple[i] = CigarOperation(
+                CigarOperationType::SOFT_CLIP, left_op.Length() + right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // S + D:
+        else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::DELETION) {
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // S + P:
+        else if (left_op.Type() == CigarOperationType::SOFT_CLIP && right_op.Type() == CigarOperationType::PADDING) {
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // H + I:
+        else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::INSERTION) {
+            new_cigar_tuple[i + 1] = CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
+            ++i;
+        }
+        // H + D:
+        else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::DELETION) {
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, left_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // H + P:
+        else if (left_op.Type() == CigarOperationType::HARD_CLIP && right_op.Type() == CigarOperationType::PADDING) {
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, left_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        // H + S:
+        } else {
+            ++i;
+        }
+        // clang-format on
+    }
 
-            CigarOperation left_op = new_cigar_tuple.at(i);
-            CigarOperation right_op = new_cigar_tuple.at(i + 1);
+    // check right flanking region
+    i = new_cigar_tuple.size() - 2;
+    // cant_stop = True
+    while (i >= 0) {
+        // cant_stop = False
 
-            if (left_op.Type() == CigarOperationType::SEQUENCE_MATCH) {
-                // reached a match state, hence everything
-                // before will be compliant
-                break;
-            }
-            // I + S:
-            if (left_op.Type() == CigarOperationType::INSERTION &&
-                right_op.Type() == CigarOperationType::SOFT_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP,
-                                                    left_op.Length() + right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // D + S:
-            else if (left_op.Type() == CigarOperationType::DELETION &&
-                     right_op.Type() == CigarOperationType::SOFT_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // P + S:
-            else if (left_op.Type() == CigarOperationType::PADDING &&
-                     right_op.Type() == CigarOperationType::SOFT_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // I + H:
-            else if (left_op.Type() == CigarOperationType::INSERTION &&
-                     right_op.Type() == CigarOperationType::HARD_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
-            }
-            // D + H:
-            else if (left_op.Type() == CigarOperationType::DELETION &&
-                     right_op.Type() == CigarOperationType::HARD_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::HARD_CLIP, right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            // P + H:
-            else if (left_op.Type() == CigarOperationType::PADDING &&
-                     right_op.Type() == CigarOperationType::HARD_CLIP) {
-                // cant_stop = True
-                new_cigar_tuple[i] =
-                    CigarOperation(CigarOperationType::HARD_CLIP, right_op.Length());
-                new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
-            }
-            --i;
+        CigarOperation left_op = new_cigar_tuple.at(i);
+        CigarOperation right_op = new_cigar_tuple.at(i + 1);
+
+        if (left_op.Type() == CigarOperationType::SEQUENCE_MATCH) {
+            // reached a match state, hence everything
+            // before will be compliant
+            break;
+        }
+        // I + S:
+        if (left_op.Type() == CigarOperationType::INSERTION &&
+            right_op.Type() == CigarOperationType::SOFT_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] =
+                CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length() + right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // D + S:
+        else if (left_op.Type() == CigarOperationType::DELETION &&
+                 right_op.Type() == CigarOperationType::SOFT_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // P + S:
+        else if (left_op.Type() == CigarOperationType::PADDING &&
+                 right_op.Type() == CigarOperationType::SOFT_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
         }
+        // I + H:
+        else if (left_op.Type() == CigarOperationType::INSERTION &&
+                 right_op.Type() == CigarOperationType::HARD_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::SOFT_CLIP, left_op.Length());
+        }
+        // D + H:
+        else if (left_op.Type() == CigarOperationType::DELETION &&
+                 right_op.Type() == CigarOperationType::HARD_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        // P + H:
+        else if (left_op.Type() == CigarOperationType::PADDING &&
+                 right_op.Type() == CigarOperationType::HARD_CLIP) {
+            // cant_stop = True
+            new_cigar_tuple[i] = CigarOperation(CigarOperationType::HARD_CLIP, right_op.Length());
+            new_cigar_tuple.erase(new_cigar_tuple.begin() + i + 1);
+        }
+        --i;
+    }
 
-        std::string new_seq = read.Sequence(BAM::Orientation::GENOMIC);
-
-        // calculate edit distance (and possibly replace match states)
-        pos_in_read = 0;
-        pos_in_dest_ref = new_sam_start;
-        int new_edit_distance = 0;
-        Cigar replace_cigar_tuple;
-
-        const auto match_state_det = [](char read_base, char genome_base) {
-            if (read_base == genome_base)
-                return CigarOperationType::SEQUENCE_MATCH;
-            else
-                return CigarOperationType::SEQUENCE_MISMATCH;
-        };
-
-        for (const auto& op : new_cigar_tuple) {
-            const CigarOperationType cigar_op = op.Type();
-            const int cigar_op_count = op.Length();
-
-            if (cigar_op == CigarOperationType::SEQUENCE_MATCH) {
-                auto old_state = match_state_det(new_seq.at(pos_in_read),
-                                                 toReferenceGapless_.at(pos_in_dest_ref));
-                int count = 1;
-                for (int i = 1; i < cigar_op_count; ++i) {
-                    const auto next_state = match_state_det(
-                        new_seq.at(pos_in_read + i), toReferenceGapless_.at(pos_in_dest_ref + i));
-                    if (old_state != next_state) {
-                        if (old_state == CigarOperationType::SEQUENCE_MISMATCH)
-                            new_edit_distance += count;
-                        replace_cigar_tuple.emplace_back(old_state, count);
-                        old_state = next_state;
-                        count = 1;
-                    } else {
-                        ++count;
-                    }
-                }
+    std::string new_seq = read->Sequence(BAM::Orientation::GENOMIC);
 
-                if (old_state == CigarOperationType::SEQUENCE_MISMATCH) new_edit_distance += count;
-                replace_cigar_tuple.emplace_back(old_state, count);
-
-                pos_in_read += cigar_op_count;
-                pos_in_dest_ref += cigar_op_count;
-            } else if (cigar_op == CigarOperationType::INSERTION) {
-                new_edit_distance += cigar_op_count;
-                replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
-                pos_in_read += cigar_op_count;
-            } else if (cigar_op == CigarOperationType::DELETION) {
-                new_edit_distance += cigar_op_count;
-                replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
-                pos_in_dest_ref += cigar_op_count;
-            } else if (cigar_op == CigarOperationType::SOFT_CLIP) {
-                replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
-                pos_in_read += cigar_op_count;
-            } else if (cigar_op == CigarOperationType::HARD_CLIP ||
-                       cigar_op == CigarOperationType::PADDING) {
-                replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
-            } else {
-                throw std::runtime_error("STATE should not occur " +
-                                         std::to_string(static_cast<int>(cigar_op)));
+    // calculate edit distance (and possibly replace match states)
+    pos_in_read = 0;
+    pos_in_dest_ref = new_sam_start;
+    int new_edit_distance = 0;
+    Cigar replace_cigar_tuple;
+
+    const auto match_state_det = [](char read_base, char genome_base) {
+        if (read_base == genome_base)
+            return CigarOperationType::SEQUENCE_MATCH;
+        else
+            return CigarOperationType::SEQUENCE_MISMATCH;
+    };
+
+    for (const auto& op : new_cigar_tuple) {
+        const CigarOperationType cigar_op = op.Type();
+        const int cigar_op_count = op.Length();
+
+        if (cigar_op == CigarOperationType::SEQUENCE_MATCH) {
+            auto old_state =
+                match_state_det(new_seq.at(pos_in_read), toReferenceGapless_.at(pos_in_dest_ref));
+            int count = 1;
+            for (int i = 1; i < cigar_op_count; ++i) {
+                const auto next_state = match_state_det(
+                    new_seq.at(pos_in_read + i), toReferenceGapless_.at(pos_in_dest_ref + i));
+                if (old_state != next_state) {
+                    if (old_state == CigarOperationType::SEQUENCE_MISMATCH)
+                        new_edit_distance += count;
+                    replace_cigar_tuple.emplace_back(old_state, count);
+                    old_state = next_state;
+                    count = 1;
+                } else {
+                    ++count;
+                }
             }
+
+            if (old_state == CigarOperationType::SEQUENCE_MISMATCH) new_edit_distance += count;
+            replace_cigar_tuple.emplace_back(old_state, count);
+
+            pos_in_read += cigar_op_count;
+            pos_in_dest_ref += cigar_op_count;
+        } else if (cigar_op == CigarOperationType::INSERTION) {
+            new_edit_distance += cigar_op_count;
+            replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
+            pos_in_read += cigar_op_count;
+        } else if (cigar_op == CigarOperationType::DELETION) {
+            new_edit_distance += cigar_op_count;
+            replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
+            pos_in_dest_ref += cigar_op_count;
+        } else if (cigar_op == CigarOperationType::SOFT_CLIP) {
+            replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
+            pos_in_read += cigar_op_count;
+        } else if (cigar_op == CigarOperationType::HARD_CLIP ||
+                   cigar_op == CigarOperationType::PADDING) {
+            replace_cigar_tuple.emplace_back(cigar_op, cigar_op_count);
+        } else {
+            throw std::runtime_error("STATE should not occur " +
+                                     std::to_string(static_cast<int>(cigar_op)));
         }
-        read.Impl().CigarData(replace_cigar_tuple);
-        read.Impl().Position(new_sam_start);
-        if (read.Impl().HasTag("NM"))
-            read.Impl().EditTag("NM", new_edit_distance);
-        else
-            read.Impl().AddTag("NM", new_edit_distance);
-        out->Write(read);
     }
+    read->Impl().CigarData(replace_cigar_tuple);
+    read->Impl().Position(new_sam_start);
+    if (read->Impl().HasTag("NM"))
+        read->Impl().EditTag("NM", new_edit_distance);
+    else
+        read->Impl().AddTag("NM", new_edit_distance);
+}
+
+void Cleric::Convert(std::string outputFile)
+{
+    // Get data source
+    auto query = IO::BamQuery(alignmentPath_);
+    std::unique_ptr<BAM::BamWriter> out;
+
+    auto ProcessHeaderAndCreateBamWriter = [this, &outputFile, &out](const BAM::BamRecord& read) {
+        const BAM::BamHeader h = ConvertHeader(read.Header());
+
+        const bool isXml = Utility::FileExtension(outputFile) == "xml";
+        if (isXml) boost::replace_last(outputFile, ".consensusalignmentset.xml", ".bam");
+
+        // Write Dataset
+        using BAM::DataSet;
+        const std::string metatype = "PacBio.AlignmentFile.AlignmentBamFile";
+        DataSet clericSet(DataSet::TypeEnum::ALIGNMENT);
+        BAM::ExternalResource resource(metatype, outputFile);
+
+        BAM::FileIndex pbi("PacBio.Index.PacBioIndex", outputFile + ".pbi");
+        resource.FileIndices().Add(pbi);
+
+        clericSet.ExternalResources().Add(resource);
+        clericSet.Name(clericSet.TimeStampedName());
+
+        const auto outputPrefix = outputFile.substr(0, outputFile.size() - 4);
+        std::ofstream clericDSout(outputPrefix + ".consensusalignmentset.xml");
+        clericSet.SaveToStream(clericDSout);
+
+        out.reset(new BAM::BamWriter(outputFile, h));
+    };
+
+    // Convert batches in parallel and write them in input order
+    static constexpr size_t batchSize = 10000;
+    std::vector<BAM::BamRecord> batch;
+    const auto ConvertAndWriteBatch = [this, &batch, &out]() {
+        Util::ParallelFor(0, batch.size(), [this, &batch](size_t i) { Convert(&batch[i]); });
+        for (const auto& read : batch)
+            out->Write(read);
+        batch.clear();
+    };
+    for (const auto& read : *query) {
+        if (!out) ProcessHeaderAndCreateBamWriter(read);
+        batch.emplace_back(read);
+        if (batch.size() == batchSize) ConvertAndWriteBatch();
+    }
+    if (out) ConvertAndWriteBatch();
     out.reset(nullptr);
     BAM::PbiFile::CreateFrom(outputFile);
 }
@@ -35,21 +35,42 @@
 
 // Author: Armin Töpfer
 
-#include <thread>
-
 #include <pacbio/Version.h>
 #include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
 #include <boost/algorithm/string.hpp>
 
 #include <pacbio/cleric/ClericSettings.h>
 
 namespace PacBio {
 namespace Cleric {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption CacheDir{
+    "cache_dir",
+    { "cache-dir" },
+    "Cache Directory",
+    "Directory to cache reference alignments in. Empty means no caching.",
+    CLI::Option::StringType("")
+};
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+// clang-format on
+}  // namespace OptionNames
 
 ClericSettings::ClericSettings(const PacBio::CLI::Results& options)
     : InputFiles(options.PositionalArguments())
+    , CacheDir(options[OptionNames::CacheDir])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
 {
 }
+
 PacBio::CLI::Interface ClericSettings::CreateCLI()
 {
     using Option = PacBio::CLI::Option;
@@ -72,10 +93,13 @@ PacBio::CLI::Interface ClericSettings::CreateCLI()
 
     i.AddOptions(
     {
+        OptionNames::CacheDir,
+        OptionNames::NumThreads
     });
 
     const std::string id = "minorseq.tasks.cleric";
     Task tcTask(id);
+    tcTask.NumProcessors(Task::MAX_NPROC);
 
     tcTask.InputFileTypes({
         {
@@ -143,13 +143,11 @@ std::vector<Data::ArrayRead> Fuse::FetchAlignedReads(const std::string& ccsInput
 {
     auto query = IO::BamQuery(ccsInput);
 
-    std::vector<Data::ArrayRead> reads;
-    int idx = 0;
-    for (const auto& read : *query) {
-        reads.emplace_back(Data::BAMArrayRead(read, idx++));
-    }
+    std::vector<BAM::BamRecord> records;
+    for (const auto& read : *query)
+        records.emplace_back(read);
 
-    return reads;
+    return IO::RecordsToArrayReads(records);
 }
 }
 }  // ::PacBio::Realign
\ No newline at end of file
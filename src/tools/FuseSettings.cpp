@@ -35,10 +35,9 @@
 
 // Author: Armin Töpfer
 
-#include <thread>
-
 #include <pacbio/Version.h>
 #include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
 #include <boost/algorithm/string.hpp>
 
 #include <pacbio/fuse/FuseSettings.h>
@@ -55,10 +54,19 @@ const PlainOption MinCoverage{
     "Minimal coverage to call a position.",
     CLI::Option::IntType(50)
 };
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+// clang-format on
 }
 
 FuseSettings::FuseSettings(const PacBio::CLI::Results& options)
     : MinCoverage(options[OptionNames::MinCoverage])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
 {
     const size_t numArgs = options.PositionalArguments().size();
     if (numArgs != 2) throw std::runtime_error("Fuse needs one input and one output argument!");
@@ -66,15 +74,6 @@ FuseSettings::FuseSettings(const PacBio::CLI::Results& options)
     OutputFile = options.PositionalArguments().back();
 }
 
-size_t FuseSettings::ThreadCount(int n)
-{
-    const int m = std::thread::hardware_concurrency();
-
-    if (n < 1) return std::max(1, m + n);
-
-    return std::min(m, n);
-}
-
 void FuseSettings::SplitRegion(const std::string& region, int* start, int* end)
 {
     if (region.compare("") != 0) {
@@ -106,11 +105,13 @@ PacBio::CLI::Interface FuseSettings::CreateCLI()
 
     i.AddOptions(
     {
-        OptionNames::MinCoverage
+        OptionNames::MinCoverage,
+        OptionNames::NumThreads
     });
 
     const std::string id = "minorseq.tasks.fuse";
     Task tcTask(id);
+    tcTask.NumProcessors(Task::MAX_NPROC);
 
     tcTask.InputFileTypes({
         {
@@ -0,0 +1,313 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <pbcopper/utility/FileUtils.h>
+
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/AnalysisMode.h>
+#include <pacbio/juliet/JulietWorkflow.h>
+
+#include <pacbio/juliet/JulietServer.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace {
+// Requests are small, a bound protects the daemon from runaway clients
+const size_t maxRequestSize = 1 << 20;
+// Distinct target configs kept parsed, beyond that the least recently used goes
+const size_t maxConfigs = 64;
+
+sockaddr_un SocketAddress(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Invalid socket path: " + socketPath);
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+/// Connects to socketPath, returns -1 if nobody is listening.
+int Connect(const std::string& socketPath)
+{
+    const auto address = SocketAddress(socketPath);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("Could not create socket");
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// Reads up to and excluding the first newline, or until EOF.
+std::string ReadLine(const int fd, const size_t maxSize)
+{
+    std::string line;
+    char buffer[4096];
+    while (true) {
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) throw std::runtime_error("Could not read from socket");
+        if (n == 0) break;
+        const char* end = static_cast<const char*>(std::memchr(buffer, '\n', n));
+        line.append(buffer, end ? end - buffer : n);
+        if (end) break;
+        if (line.size() > maxSize) throw std::runtime_error("Request too large");
+    }
+    return line;
+}
+
+void WriteLine(const int fd, std::string data)
+{
+    data += '\n';
+    size_t written = 0;
+    while (written < data.size()) {
+        // No SIGPIPE if the peer hung up, the error is reported instead
+        const ssize_t n = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) throw std::runtime_error("Could not write to socket");
+        written += n;
+    }
+}
+}
+
+JulietServer::JulietServer(const std::string& socketPath, const size_t maxJobs)
+    : socketPath_(socketPath), maxJobs_(std::max<size_t>(1, maxJobs)), shutdown_(false)
+{
+    // Replace the socket file of a crashed daemon, but never a live one
+    const int probe = Connect(socketPath_);
+    if (probe >= 0) {
+        close(probe);
+        throw std::runtime_error("A daemon is already listening on " + socketPath_);
+    }
+    unlink(socketPath_.c_str());
+
+    const auto address = SocketAddress(socketPath_);
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) throw std::runtime_error("Could not create socket");
+    // Clients read and write files as the daemon, only its user may connect.
+    // The socket is created 0600, there is no window with wider permissions.
+    const mode_t mask = umask(0177);
+    const bool bound =
+        bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    const int bindErrno = errno;
+    umask(mask);
+    if (!bound || listen(listenFd_, SOMAXCONN) != 0) {
+        const int error = bound ? errno : bindErrno;
+        close(listenFd_);
+        throw std::runtime_error("Could not listen on " + socketPath_ + ": " +
+                                 std::strerror(error));
+    }
+}
+
+JulietServer::~JulietServer()
+{
+    close(listenFd_);
+    unlink(socketPath_.c_str());
+}
+
+void JulietServer::Serve()
+{
+    while (!shutdown_) {
+        const int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (shutdown_) break;
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            throw std::runtime_error("Could not accept connection on " + socketPath_);
+        }
+
+        // Back-pressure, further clients queue in the listen backlog
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex_);
+            jobsDone_.wait(lock, [this]() { return activeJobs_ < maxJobs_; });
+            ++activeJobs_;
+        }
+        std::thread(&JulietServer::Connection, this, fd).detach();
+    }
+
+    std::unique_lock<std::mutex> lock(jobsMutex_);
+    jobsDone_.wait(lock, [this]() { return activeJobs_ == 0; });
+}
+
+void JulietServer::Connection(const int fd)
+{
+    std::string response;
+    try {
+        response = Handle(JSON::Json::parse(ReadLine(fd, maxRequestSize)));
+    } catch (const std::exception& e) {
+        JSON::Json error = JSON::Json::object();
+        error["status"] = "error";
+        error["message"] = e.what();
+        response = error.dump();
+    }
+
+    try {
+        WriteLine(fd, response);
+    } catch (const std::exception&) {
+        // Client is gone, nothing left to report to
+    }
+    close(fd);
+
+    // Notify under the lock, Serve may return and destroy this right after
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    --activeJobs_;
+    jobsDone_.notify_all();
+}
+
+std::string JulietServer::Handle(const JSON::Json& request)
+{
+    const std::string command = request.value("command", std::string("analyze"));
+    // The report is streamed into the response, never held as a DOM
+    if (command == "analyze") return "{\"result\":" + Analyze(request) + ",\"status\":\"ok\"}";
+    if (command == "shutdown") {
+        shutdown_ = true;
+        // Wakes up the blocking accept in Serve
+        shutdown(listenFd_, SHUT_RDWR);
+    } else if (command != "ping") {
+        throw std::runtime_error("Unknown command: " + command);
+    }
+    return "{\"status\":\"ok\"}";
+}
+
+std::string JulietServer::Analyze(const JSON::Json& request)
+{
+    if (request.find("input") == request.cend())
+        throw std::runtime_error("Missing input in request");
+    const std::string input = request.at("input");
+
+    JulietSettings settings;
+    settings.CLI = request.dump();
+    settings.InputFiles = {input};
+    JulietSettings::SplitRegion(request.value("region", std::string()), &settings.RegionStart,
+                                &settings.RegionEnd);
+    settings.TargetConfigUser = *Config(request.value("config", std::string()));
+    settings.DRMOnly = request.value("drmOnly", false);
+    settings.MergeOutliers = request.value("mergeOutliers", false);
+    settings.Debug = request.value("debug", false);
+    if (request.value("phasing", false)) settings.Mode = AnalysisMode::PHASING;
+    settings.SubstitutionRate = request.value("substitutionRate", 0.0);
+    settings.DeletionRate = request.value("deletionRate", 0.0);
+    settings.MinimalPerc = request.value("minPerc", 0.0);
+    settings.MaximalPerc = request.value("maxPerc", 100.0);
+    settings.HtmlPageSize = request.value("htmlPageSize", 0);
+
+    const auto reads = IO::BamToArrayReads(input, settings.RegionStart, settings.RegionEnd);
+    if (reads.empty()) throw std::runtime_error("Empty input: " + input);
+
+    std::ostringstream result;
+    JulietWorkflow workflow;
+    workflow.CallVariants(reads, settings, input, request.value("html", std::string()),
+                          request.value("json", std::string()), "", &result,
+                          request.value("vcf", std::string()));
+    return result.str();
+}
+
+std::shared_ptr<const TargetConfig> JulietServer::Config(const std::string& input)
+{
+    // Config files are keyed by content, edits apply without a restart
+    std::string key = input;
+    if (!input.empty() && Utility::FileExists(input)) {
+        std::ifstream in(input);
+        std::ostringstream content;
+        content << in.rdbuf();
+        key = "file:" + content.str();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        const auto it = configs_.find(key);
+        if (it != configs_.end()) {
+            it->second.LastUse = ++configUses_;
+            return it->second.Config;
+        }
+    }
+
+    // Parsed without the lock, such that a slow config does not hold up other
+    // jobs, and cached only if parsing succeeds
+    auto config = std::make_shared<const TargetConfig>(input);
+
+    std::lock_guard<std::mutex> lock(configMutex_);
+    auto& entry = configs_[key];
+    entry.LastUse = ++configUses_;
+    // Another job may have parsed the same config meanwhile
+    if (!entry.Config) {
+        entry.Config = std::move(config);
+        // Evict the least recently used config, running jobs keep their copy
+        if (configs_.size() > maxConfigs) {
+            auto lru = configs_.begin();
+            for (auto it = configs_.begin(); it != configs_.end(); ++it)
+                if (it->second.LastUse < lru->second.LastUse) lru = it;
+            configs_.erase(lru);
+        }
+    }
+    return entry.Config;
+}
+
+JSON::Json JulietServer::Submit(const std::string& socketPath, const JSON::Json& request)
+{
+    const int fd = Connect(socketPath);
+    if (fd < 0) throw std::runtime_error("No juliet daemon listening on " + socketPath);
+
+    std::string line;
+    try {
+        WriteLine(fd, request.dump());
+        line = ReadLine(fd, std::string::npos);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return JSON::Json::parse(line);
+}
+}
+}  // ::PacBio::Juliet
@@ -35,10 +35,9 @@
 
 // Author: Armin Töpfer
 
-#include <thread>
-
 #include <pacbio/Version.h>
 #include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
 #include <boost/algorithm/string.hpp>
 
 #include <pacbio/juliet/JulietSettings.h>
@@ -74,7 +73,7 @@ const PlainOption Error{
     "mode_error",
     { "mode-error" },
     "Alignment Error Rates",
-    "Compute alignment error rates.",
+    "Compute alignment error rates per position and sequence context, writes <prefix>.errormodel.json.",
     CLI::Option::BoolType(),
     JSON::Json(nullptr),
     CLI::OptionFlags::HIDE_FROM_HELP
@@ -93,6 +92,13 @@ const PlainOption DeletionRate{
     "Deletion Rate, specify to override the learned rate.",
     CLI::Option::FloatType(0)
 };
+const PlainOption ErrorModel{
+    "error_model",
+    { "error-model" },
+    "Error Model",
+    "Error model written by --mode-error, replaces the learned rates of the chemistry.",
+    CLI::Option::StringType("")
+};
 const PlainOption MinimalPerc{
     "minimal_percentage",
     { "min-perc", "m" },
@@ -146,6 +152,78 @@ const PlainOption Debug{
     "Debug returns all amino acids, irrelevant of their significance.",
     CLI::Option::BoolType()
 };
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+const PlainOption HtmlPageSize{
+    "html_page_size",
+    { "html-page-size" },
+    "HTML Page Size",
+    "Variant positions per page of the HTML report. The tables are stored as compact data and rendered on demand, 0 writes all tables statically.",
+    CLI::Option::IntType(0)
+};
+const PlainOption Vcf{
+    "vcf",
+    { "vcf" },
+    "VCF Output",
+    "Also write a BGZF-compressed, tabix-indexed VCF per sample to <prefix>.vcf.gz. A single sample accepts an explicit .vcf or .vcf.gz output file instead.",
+    CLI::Option::BoolType()
+};
+const PlainOption SampleSheet{
+    "sample_sheet",
+    { "sample-sheet" },
+    "Sample Sheet",
+    "File with one sample per line, \"<bam>\" or \"<name> <bam>\". The name is used as output prefix.",
+    CLI::Option::StringType("")
+};
+const PlainOption SplitByReadGroup{
+    "split_by_read_group",
+    { "split-by-read-group" },
+    "Split by Read Group",
+    "Analyze each read group as its own sample, output prefixes are suffixed with the read group id.",
+    CLI::Option::BoolType()
+};
+const PlainOption Summary{
+    "summary",
+    { "summary" },
+    "Plate Summary",
+    "Plate-level JSON summary of a multi-sample run.",
+    CLI::Option::StringType("juliet_summary.json")
+};
+const PlainOption MaxMemory{
+    "max_memory",
+    { "max-memory" },
+    "Memory Budget",
+    "Memory budget in MiB for concurrently analyzed samples, 0 means unlimited.",
+    CLI::Option::IntType(0)
+};
+const PlainOption Profile{
+    "profile",
+    { "profile" },
+    "Profile",
+    "Write calls, wall time, and CPU time of every analysis stage as JSON to this file.",
+    CLI::Option::StringType("")
+};
+const PlainOption Stats{
+    "stats",
+    { "stats" },
+    "Stats",
+    "Write counts of decoded and skipped reads, codons, tests, and comparisons as JSON to this "
+    "file, \"-\" prints them to stderr.",
+    CLI::Option::StringType("")
+};
+const PlainOption Trace{
+    "trace",
+    { "trace" },
+    "Trace",
+    "Write begin and end of every stage, sample, and task per thread as Chrome trace events to "
+    "this file, for Perfetto or chrome://tracing.",
+    CLI::Option::StringType("")
+};
 // clang-format on
 }  // namespace OptionNames
 
@@ -159,8 +237,18 @@ JulietSettings::JulietSettings(const PacBio::CLI::Results& options)
     , Mode(AnalysisModeFromOptions(options))
     , SubstitutionRate(options[OptionNames::SubstitutionRate])
     , DeletionRate(options[OptionNames::DeletionRate])
+    , ErrorModelFile(options[OptionNames::ErrorModel])
     , MinimalPerc(options[OptionNames::MinimalPerc])
     , MaximalPerc(options[OptionNames::MaximalPerc])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
+    , HtmlPageSize(options[OptionNames::HtmlPageSize])
+    , Vcf(options[OptionNames::Vcf])
+    , SampleSheet(options[OptionNames::SampleSheet])
+    , SummaryFile(options[OptionNames::Summary])
+    , SplitByReadGroup(options[OptionNames::SplitByReadGroup])
+    , ProfileFile(options[OptionNames::Profile])
+    , StatsFile(options[OptionNames::Stats])
+    , TraceFile(options[OptionNames::Trace])
 {
     const std::string targetConfigTC = options[OptionNames::TargetConfigTC];
     const std::string targetConfigCLI = options[OptionNames::TargetConfigCLI];
@@ -171,15 +259,12 @@ JulietSettings::JulietSettings(const PacBio::CLI::Results& options)
         TargetConfigUser = targetConfigCLI;
 
     SplitRegion(options[OptionNames::Region], &RegionStart, &RegionEnd);
-}
-
-size_t JulietSettings::ThreadCount(int n)
-{
-    const int m = std::thread::hardware_concurrency();
 
-    if (n < 1) return std::max(1, m + n);
+    const int maxMemory = options[OptionNames::MaxMemory];
+    if (maxMemory < 0) throw std::runtime_error("Memory budget must not be negative");
+    MaxMemory = static_cast<size_t>(maxMemory) << 20;
 
-    return std::min(m, n);
+    if (HtmlPageSize < 0) throw std::runtime_error("HTML page size must not be negative");
 }
 
 void JulietSettings::SplitRegion(const std::string& region, int* start, int* end)
@@ -227,7 +312,7 @@ PacBio::CLI::Interface JulietSettings::CreateCLI()
 
     // clang-format off
     i.AddPositionalArguments({
-        {"source", "Source BAM or DataSet XML file.", "FILE"}
+        {"source", "Source BAM or DataSet XML files, more than one runs a batch.", "FILES"}
     });
 
     i.AddOptions(
@@ -236,13 +321,27 @@ PacBio::CLI::Interface JulietSettings::CreateCLI()
         OptionNames::Debug,
         OptionNames::MergeOutliers,
         OptionNames::TargetConfigTC,
-        OptionNames::Error
+        OptionNames::Error,
+        OptionNames::Profile,
+        OptionNames::Stats,
+        OptionNames::Trace
     });
 
     i.AddGroup("Configuration",
     {
         OptionNames::TargetConfigCLI,
-        OptionNames::Phasing
+        OptionNames::Phasing,
+        OptionNames::NumThreads,
+        OptionNames::HtmlPageSize,
+        OptionNames::Vcf
+    });
+
+    i.AddGroup("Multiple samples",
+    {
+        OptionNames::SampleSheet,
+        OptionNames::SplitByReadGroup,
+        OptionNames::Summary,
+        OptionNames::MaxMemory
     });
 
     i.AddGroup("Restrictions",
@@ -259,6 +358,11 @@ PacBio::CLI::Interface JulietSettings::CreateCLI()
         OptionNames::DeletionRate
     });
 
+    i.AddGroup("Error model",
+    {
+        OptionNames::ErrorModel
+    });
+
     const std::string id = "minorseq.tasks.juliet";
     Task tcTask(id);
     tcTask.AddOption(OptionNames::Phasing);
@@ -270,6 +374,7 @@ PacBio::CLI::Interface JulietSettings::CreateCLI()
     tcTask.AddOption(OptionNames::SubstitutionRate);
     tcTask.AddOption(OptionNames::DeletionRate);
     tcTask.AddOption(OptionNames::Debug);
+    tcTask.NumProcessors(Task::MAX_NPROC);
 
     tcTask.InputFileTypes({
         {
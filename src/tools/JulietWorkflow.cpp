@@ -36,6 +36,7 @@
 // Author: Armin Töpfer
 
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <exception>
 #include <fstream>
@@ -44,8 +45,15 @@
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <set>
+#include <sstream>
 #include <vector>
 
+#include <sys/stat.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <pbbam/BamFile.h>
 #include <pbbam/BamReader.h>
 #include <pbbam/BamRecord.h>
 #include <pbbam/DataSet.h>
@@ -57,10 +65,13 @@
 #include <pacbio/data/MSAByColumn.h>
 #include <pacbio/io/BamParser.h>
 #include <pacbio/juliet/AminoAcidCaller.h>
-#include <pacbio/juliet/JsonToHtml.h>
+#include <pacbio/juliet/ErrorModel.h>
 #include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/SampleReader.h>
 #include <pacbio/statistics/Fisher.h>
 #include <pacbio/statistics/Tests.h>
+#include <pacbio/util/ThreadPool.h>
+#include <pacbio/util/Tracer.h>
 
 #include <pacbio/juliet/JulietWorkflow.h>
 
@@ -89,9 +100,15 @@ void JulietWorkflow::AminoPhasing(const JulietSettings& settings)
     std::string outputHtml;
     std::string outputJson;
     std::string outputMsa;
-    std::string bamInput;
+    std::string outputVcf;
+    std::vector<std::string> bamInputs;
     for (const auto& i : settings.InputFiles) {
         const auto fileExt = PacBio::Utility::FileExtension(i);
+        if (fileExt == "vcf" || boost::algorithm::ends_with(i, ".vcf.gz")) {
+            if (!outputVcf.empty()) throw std::runtime_error("Only one vcf output file allowed");
+            outputVcf = i;
+            continue;
+        }
         if (fileExt == "json") {
             if (!outputJson.empty()) throw std::runtime_error("Only one json output file allowed");
             outputJson = i;
@@ -112,7 +129,7 @@ void JulietWorkflow::AminoPhasing(const JulietSettings& settings)
             case DataSet::TypeEnum::SUBREAD:
             case DataSet::TypeEnum::ALIGNMENT:
             case DataSet::TypeEnum::CONSENSUS_ALIGNMENT:
-                bamInput = i;
+                bamInputs.emplace_back(i);
                 break;
             default:
                 throw std::runtime_error("Unsupported input file: " + i + " of type " +
@@ -120,11 +137,24 @@ void JulietWorkflow::AminoPhasing(const JulietSettings& settings)
         }
     }
 
-    if (bamInput.empty()) throw std::runtime_error("Missing input file!");
-    if (outputHtml.empty() && outputJson.empty() && outputMsa.empty()) {
+    if (bamInputs.size() > 1 || !settings.SampleSheet.empty() || settings.SplitByReadGroup) {
+        if (!outputHtml.empty() || !outputJson.empty() || !outputMsa.empty() || !outputVcf.empty())
+            throw std::runtime_error(
+                "Output files cannot be named for multiple samples, use a sample sheet");
+        auto samples = ReadSampleSheet(settings.SampleSheet);
+        for (const auto& bamInput : bamInputs)
+            samples.emplace_back(Sample{"", bamInput, PacBio::Utility::FilePrefix(bamInput)});
+        Batch(samples, settings);
+        return;
+    }
+
+    if (bamInputs.empty()) throw std::runtime_error("Missing input file!");
+    const auto& bamInput = bamInputs.front();
+    if (outputHtml.empty() && outputJson.empty() && outputMsa.empty() && outputVcf.empty()) {
         const auto prefix = PacBio::Utility::FilePrefix(bamInput);
         outputHtml = prefix + ".html";
         outputJson = prefix + ".json";
+        if (settings.Vcf) outputVcf = prefix + ".vcf.gz";
     }
 
     auto sharedReads = IO::BamToArrayReads(bamInput, settings.RegionStart, settings.RegionEnd);
@@ -134,41 +164,226 @@ void JulietWorkflow::AminoPhasing(const JulietSettings& settings)
         exit(1);
     }
 
-    std::string chemistry = sharedReads.front()->SequencingChemistry();
-    for (size_t i = 1; i < sharedReads.size(); ++i)
-        if (chemistry != sharedReads.at(i)->SequencingChemistry())
-            throw std::runtime_error("Mixed chemistries are not allowed");
+    CallVariants(sharedReads, settings, bamInput, outputHtml, outputJson, outputMsa, nullptr,
+                 outputVcf);
+}
 
-    ErrorEstimates error;
-    if (settings.SubstitutionRate != 0.0 && settings.DeletionRate != 0.0) {
-        error = ErrorEstimates(settings.SubstitutionRate, settings.DeletionRate);
-    } else {
-        error = ErrorEstimates(chemistry);
+std::vector<JulietWorkflow::Sample> JulietWorkflow::ReadSampleSheet(const std::string& sampleSheet)
+{
+    std::vector<Sample> samples;
+    if (sampleSheet.empty()) return samples;
+
+    std::ifstream in(sampleSheet);
+    if (!in) throw std::runtime_error("Could not open sample sheet " + sampleSheet);
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        std::istringstream fields(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (fields >> token && token.front() != '#')
+            tokens.emplace_back(token);
+        if (tokens.empty()) continue;
+        if (tokens.size() == 1)
+            samples.emplace_back(Sample{"", tokens[0], PacBio::Utility::FilePrefix(tokens[0])});
+        else if (tokens.size() == 2)
+            samples.emplace_back(Sample{tokens[0], tokens[1], tokens[0]});
+        else
+            throw std::runtime_error("Expected \"<bam>\" or \"<name> <bam>\" in line " +
+                                     std::to_string(lineNumber) + " of " + sampleSheet);
     }
+    return samples;
+}
 
-    // Call variants
-    AminoAcidCaller aac(sharedReads, error, settings);
-    if (settings.Mode == AnalysisMode::PHASING) aac.PhaseVariants();
+namespace {
+// Peak footprint of a sample, decoded reads, MSAs, and codon counts all
+// grow linearly with the compressed BAM size
+const size_t bytesPerBamByte = 64;
 
-    const auto json = aac.JSON();
+size_t EstimateMemory(const std::string& input)
+{
+    size_t bamBytes = 0;
+    for (const auto& bamFile : BAM::DataSet(input).BamFiles()) {
+        struct stat st;
+        if (stat(bamFile.Filename().c_str(), &st) == 0) bamBytes += st.st_size;
+    }
+    return bamBytes * bytesPerBamByte;
+}
+}
+
+void JulietWorkflow::Batch(const std::vector<Sample>& samples, const JulietSettings& settings)
+{
+    std::set<std::string> prefixes;
+    for (const auto& s : samples)
+        if (!prefixes.insert(s.OutputPrefix).second)
+            throw std::runtime_error("Duplicate sample output prefix: " + s.OutputPrefix);
+
+    // Samples run concurrently on the shared pool, each spawning its own
+    // parallel stages. A sample is only started once its estimated memory
+    // fits the budget, a sample above the budget runs alone.
+    std::vector<std::vector<JSON::Json>> results(samples.size());
+    std::atomic<size_t> reserved(0);
+    Util::TaskGroup group;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const size_t need = settings.MaxMemory ? EstimateMemory(samples[i].Input) : 0;
+        group.WaitUntil([&reserved, need, &settings]() {
+            return reserved == 0 || reserved + need <= settings.MaxMemory;
+        });
+        reserved += need;
+        group.Run([this, i, need, &samples, &settings, &results, &reserved]() {
+            results[i] = AnalyzeSample(samples[i], settings);
+            reserved -= need;
+        });
+    }
+    group.Wait();
+
+    std::vector<JSON::Json> sampleSummaries;
+    int numFailed = 0;
+    for (const auto& sampleResults : results) {
+        for (const auto& r : sampleResults) {
+            if (r["status"] != "ok") ++numFailed;
+            sampleSummaries.emplace_back(r);
+        }
+    }
+    JSON::Json summary;
+    summary["num_samples"] = sampleSummaries.size();
+    summary["num_failed"] = numFailed;
+    summary["samples"] = sampleSummaries;
+    std::ofstream summaryStream(settings.SummaryFile);
+    summaryStream << summary.dump(2) << std::endl;
+
+    if (numFailed > 0)
+        throw std::runtime_error(std::to_string(numFailed) + " of " +
+                                 std::to_string(sampleSummaries.size()) + " samples failed, see " +
+                                 settings.SummaryFile);
+}
 
+std::vector<JSON::Json> JulietWorkflow::AnalyzeSample(const Sample& sample,
+                                                      const JulietSettings& settings)
+{
+    const auto name = sample.Name.empty() ? sample.OutputPrefix : sample.Name;
+    std::vector<JSON::Json> summaries;
+    try {
+        if (!settings.SplitByReadGroup) {
+            const auto sharedReads =
+                IO::BamToArrayReads(sample.Input, settings.RegionStart, settings.RegionEnd);
+            summaries.emplace_back(
+                AnalyzeReads(sharedReads, name, sample.Input, sample.OutputPrefix, settings));
+            return summaries;
+        }
+
+        // Groups are analyzed in parallel, each with the error estimates of
+        // its own chemistry
+        const auto readGroups =
+            IO::BamToArrayReadsByReadGroup(sample.Input, settings.RegionStart, settings.RegionEnd);
+        summaries.resize(readGroups.size());
+        Util::TaskGroup group;
+        size_t i = 0;
+        for (const auto& readGroup : readGroups) {
+            const auto* rg = &readGroup;
+            group.Run([this, rg, i, &name, &sample, &settings, &summaries]() {
+                summaries[i] = AnalyzeReads(rg->second, name + "_" + rg->first, sample.Input,
+                                            sample.OutputPrefix + "_" + rg->first, settings);
+                summaries[i]["read_group"] = rg->first;
+            });
+            ++i;
+        }
+        group.Wait();
+    } catch (const std::exception& e) {
+        summaries.clear();
+        summaries.emplace_back(ErrorSummary(name, sample.Input, e.what()));
+    }
+    return summaries;
+}
+
+JSON::Json JulietWorkflow::AnalyzeReads(
+    const std::vector<std::shared_ptr<Data::ArrayRead>>& sharedReads, const std::string& name,
+    const std::string& input, const std::string& outputPrefix, const JulietSettings& settings)
+{
+    Util::TraceScope trace(name, "sample");
+    try {
+        if (sharedReads.empty()) throw std::runtime_error("Empty input.");
+
+        const std::string outputVcf = settings.Vcf ? outputPrefix + ".vcf.gz" : "";
+        const auto report = CallVariants(sharedReads, settings, input, outputPrefix + ".html",
+                                         outputPrefix + ".json", "", nullptr, outputVcf);
+
+        JSON::Json summary;
+        summary["name"] = name;
+        summary["input"] = input;
+        summary["status"] = "ok";
+        summary["html"] = outputPrefix + ".html";
+        summary["json"] = outputPrefix + ".json";
+        if (!outputVcf.empty()) summary["vcf"] = outputVcf;
+        summary["chemistry"] = sharedReads.front()->SequencingChemistry();
+        summary["num_reads"] = sharedReads.size();
+        summary["num_variant_positions"] = report.NumVariantPositions;
+        summary["num_haplotypes"] = report.NumHaplotypes;
+        summary["known_drms"] =
+            std::vector<std::string>(report.KnownDRMs.cbegin(), report.KnownDRMs.cend());
+        return summary;
+    } catch (const std::exception& e) {
+        // One broken sample must not take down the plate
+        return ErrorSummary(name, input, e.what());
+    }
+}
+
+JSON::Json JulietWorkflow::ErrorSummary(const std::string& name, const std::string& input,
+                                        const std::string& message)
+{
+    JSON::Json summary;
+    summary["name"] = name;
+    summary["input"] = input;
+    summary["status"] = "error";
+    summary["message"] = message;
+    return summary;
+}
+
+std::string JulietWorkflow::VcfContig(const JulietSettings& settings, const std::string& input)
+{
+    if (!settings.TargetConfigUser.referenceName.empty())
+        return settings.TargetConfigUser.referenceName;
+    std::set<std::string> names;
+    for (const auto& bamFile : BAM::DataSet(input).BamFiles())
+        for (const auto& sequence : bamFile.Header().Sequences())
+            names.insert(sequence.Name());
+    if (names.size() != 1)
+        throw std::runtime_error(
+            "VCF output needs a target config reference name or a single "
+            "reference in " +
+            input);
+    return *names.cbegin();
+}
+
+AminoAcidCaller::ReportSummary JulietWorkflow::CallVariants(
+    const std::vector<std::shared_ptr<Data::ArrayRead>>& sharedReads,
+    const JulietSettings& settings, const std::string& inputName, const std::string& outputHtml,
+    const std::string& outputJson, const std::string& outputMsa, std::ostream* jsonStream,
+    const std::string& outputVcf)
+{
+    // Same error rates, chemistry check, and phasing as julietd and the C API
+    const auto aac = SampleReader::Call(sharedReads, settings);
+
+    // Both reports are rendered from the typed results, no DOM is built
     if (!outputJson.empty()) {
-        std::ofstream jsonStream(outputJson);
-        jsonStream << json.dump(2) << std::endl;
+        std::ofstream jsonFile(outputJson);
+        aac->WriteJson(jsonFile);
+        jsonFile << std::endl;
     }
+    if (jsonStream) aac->WriteJson(*jsonStream, -1);
 
     if (!outputHtml.empty()) {
         std::ofstream htmlStream(outputHtml);
-        JsonToHtml::HTML(htmlStream, json, settings.TargetConfigUser, settings.DRMOnly, bamInput,
-                         settings.CLI);
+        aac->WriteHtml(htmlStream, inputName, settings.CLI, settings.HtmlPageSize);
     }
 
+    if (!outputVcf.empty()) aac->WriteVcf(outputVcf, VcfContig(settings, inputName));
+
     // Store msa + p-values
     if (!outputMsa.empty()) {
         std::ofstream msaStream(outputMsa);
         msaStream << "pos A C G T - N" << std::endl;
-        int pos = aac.msaByColumn_.beginPos;
-        for (auto& column : aac.msaByColumn_) {
+        int pos = aac->msaByColumn_.beginPos;
+        for (auto& column : aac->msaByColumn_) {
             ++pos;
             msaStream << pos;
             const std::array<int, 6>& counts = column;
@@ -178,25 +393,28 @@ void JulietWorkflow::AminoPhasing(const JulietSettings& settings)
         }
         msaStream.close();
     }
+
+    return aac->Summary();
 }
 void JulietWorkflow::Error(const JulietSettings& settings)
 {
-    for (const auto& inputFile : settings.InputFiles) {
-        auto reads = IO::BamToArrayReads(inputFile, settings.RegionStart, settings.RegionEnd);
-        Data::MSAByColumn msa(reads);
-        double sub = 0;
-        double del = 0;
-        int columnCount = 0;
-        for (const auto& column : msa) {
-            if (column.Coverage() > 100) {
-                del += column.Frequency(4);
-                sub += 1.0 - column.Frequency(4) - column.Frequency(column.MaxElement());
-                ++columnCount;
-            }
-        }
-        std::cout << inputFile << std::endl;
-        std::cout << "sub: " << (sub / columnCount) << std::endl;
-        std::cout << "del: " << (del / columnCount) << std::endl;
+    // Inputs are streamed concurrently, each counting its batches in parallel
+    const auto& inputs = settings.InputFiles;
+    std::vector<ErrorModel> models(inputs.size());
+    Util::TaskGroup group;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        group.Run([i, &inputs, &models, &settings]() {
+            models[i] = ErrorModel::Estimate(inputs[i], settings.RegionStart, settings.RegionEnd);
+            models[i].WriteJson(PacBio::Utility::FilePrefix(inputs[i]) + ".errormodel.json");
+        });
+    }
+    group.Wait();
+
+    for (const auto& model : models) {
+        std::cout << model.Input << std::endl;
+        std::cout << "sub: " << model.Global.Substitution << std::endl;
+        std::cout << "del: " << model.Global.Deletion << std::endl;
+        std::cout << "ins: " << model.Global.Insertion << std::endl;
     }
 }
 }
@@ -0,0 +1,247 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <climits>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/PlainOption.h>
+
+#include <pacbio/juliet/JulietcSettings.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption Socket{
+    "socket",
+    { "socket", "s" },
+    "Socket",
+    "Path of the Unix domain socket of julietd. Required.",
+    CLI::Option::StringType("")
+};
+const PlainOption Region{
+    "region",
+    { "region", "r"},
+    "Region of Interest",
+    "Clip reads to this genomic region. Empty means all reads.",
+    CLI::Option::StringType("")
+};
+const PlainOption DRMOnly{
+    "only_known_drms",
+    { "drm-only", "k" },
+    "Only Report Variants in Target Config",
+    "Only report variants that confer drug resistance, as listed in the target configuration file.",
+    CLI::Option::BoolType()
+};
+const PlainOption Phasing{
+    "mode_phasing",
+    { "mode-phasing", "p" },
+    "Phase Variants",
+    "Phase variants and cluster haplotypes.",
+    CLI::Option::BoolType()
+};
+const PlainOption MinimalPerc{
+    "minimal_percentage",
+    { "min-perc", "m" },
+    "Minimal Variant Percentage.",
+    "Minimal variant percentage to report.",
+    CLI::Option::FloatType(0)
+};
+const PlainOption MaximalPerc{
+    "maximal_percentage",
+    { "max-perc", "n" },
+    "Maximal Variant Percentage",
+    "Maximal variant percentage to report.",
+    CLI::Option::FloatType(100)
+};
+const PlainOption TargetConfigCLI{
+    "target_config_universal",
+    { "config", "c" },
+    "Target Config",
+    "Path to the target config JSON file, predefined target config tag, or the JSON string.",
+    CLI::Option::StringType("")
+};
+const PlainOption OutputHtml{
+    "output_html",
+    { "html" },
+    "HTML Output",
+    "Let the daemon write the HTML report to this file.",
+    CLI::Option::StringType("")
+};
+const PlainOption HtmlPageSize{
+    "html_page_size",
+    { "html-page-size" },
+    "HTML Page Size",
+    "Variant positions per page of the HTML report, 0 writes all tables statically.",
+    CLI::Option::IntType(0)
+};
+const PlainOption OutputJson{
+    "output_json",
+    { "json" },
+    "JSON Output",
+    "Let the daemon write the JSON report to this file.",
+    CLI::Option::StringType("")
+};
+const PlainOption OutputVcf{
+    "output_vcf",
+    { "vcf" },
+    "VCF Output",
+    "Let the daemon write the VCF to this file, BGZF-compressed and tabix-indexed if it ends in .gz.",
+    CLI::Option::StringType("")
+};
+const PlainOption Ping{
+    "ping",
+    { "ping" },
+    "Ping",
+    "Only check that the daemon is alive.",
+    CLI::Option::BoolType()
+};
+const PlainOption Shutdown{
+    "shutdown",
+    { "shutdown" },
+    "Shutdown",
+    "Stop the daemon after all running requests finished.",
+    CLI::Option::BoolType()
+};
+// clang-format on
+}  // namespace OptionNames
+
+namespace {
+// The daemon runs in a different working directory
+std::string AbsolutePath(const std::string& path)
+{
+    if (path.empty() || path.front() == '/') return path;
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr)
+        throw std::runtime_error("Could not determine working directory");
+    return std::string(cwd) + "/" + path;
+}
+}
+
+JulietcSettings::JulietcSettings(const PacBio::CLI::Results& options)
+    : SocketPath(options[OptionNames::Socket]), Request(JSON::Json::object())
+{
+    if (SocketPath.empty()) throw std::runtime_error("Please provide the socket path via -s");
+
+    const bool ping = options[OptionNames::Ping];
+    const bool shutdown = options[OptionNames::Shutdown];
+    if (ping && shutdown) throw std::runtime_error("Options --ping and --shutdown are exclusive");
+    if (ping) {
+        Request["command"] = "ping";
+        return;
+    }
+    if (shutdown) {
+        Request["command"] = "shutdown";
+        return;
+    }
+
+    const auto& files = options.PositionalArguments();
+    if (files.size() != 1) throw std::runtime_error("Please provide one BAM input, see --help");
+
+    const std::string region = options[OptionNames::Region];
+    const std::string config = options[OptionNames::TargetConfigCLI];
+    const std::string outputHtml = options[OptionNames::OutputHtml];
+    const std::string outputJson = options[OptionNames::OutputJson];
+    const std::string outputVcf = options[OptionNames::OutputVcf];
+    const bool drmOnly = options[OptionNames::DRMOnly];
+    const bool phasing = options[OptionNames::Phasing];
+    const double minPerc = options[OptionNames::MinimalPerc];
+    const double maxPerc = options[OptionNames::MaximalPerc];
+    const int htmlPageSize = options[OptionNames::HtmlPageSize];
+
+    Request["command"] = "analyze";
+    Request["input"] = AbsolutePath(files.front());
+    Request["region"] = region;
+    Request["config"] = config;
+    Request["drmOnly"] = drmOnly;
+    Request["phasing"] = phasing;
+    Request["minPerc"] = minPerc;
+    Request["maxPerc"] = maxPerc;
+    Request["html"] = AbsolutePath(outputHtml);
+    Request["htmlPageSize"] = htmlPageSize;
+    Request["json"] = AbsolutePath(outputJson);
+    Request["vcf"] = AbsolutePath(outputVcf);
+}
+
+PacBio::CLI::Interface JulietcSettings::CreateCLI()
+{
+    PacBio::CLI::Interface i{
+        "julietc", "Juliet client, submits a request to julietd and prints the JSON response.",
+        PacBio::MinorseqVersion() + " (commit " + PacBio::MinorseqGitSha1() + ")"};
+
+    i.AddHelpOption();     // use built-in help output
+    i.AddVersionOption();  // use built-in version output
+
+    // clang-format off
+    i.AddPositionalArguments({
+        {"source", "Source BAM or DataSet XML file, resolved by the daemon.", "FILE"}
+    });
+
+    i.AddGroup("Daemon",
+    {
+        OptionNames::Socket,
+        OptionNames::Ping,
+        OptionNames::Shutdown
+    });
+
+    i.AddGroup("Configuration",
+    {
+        OptionNames::TargetConfigCLI,
+        OptionNames::Phasing,
+        OptionNames::OutputHtml,
+        OptionNames::HtmlPageSize,
+        OptionNames::OutputJson,
+        OptionNames::OutputVcf
+    });
+
+    i.AddGroup("Restrictions",
+    {
+        OptionNames::Region,
+        OptionNames::DRMOnly,
+        OptionNames::MinimalPerc,
+        OptionNames::MaximalPerc
+    });
+    // clang-format on
+
+    return i;
+}
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,108 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <stdexcept>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/juliet/JulietdSettings.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption Socket{
+    "socket",
+    { "socket", "s" },
+    "Socket",
+    "Path of the Unix domain socket to listen on. Required.",
+    CLI::Option::StringType("")
+};
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads shared by all jobs, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+const PlainOption MaxJobs{
+    "max_jobs",
+    { "max-jobs" },
+    "Maximal Concurrent Jobs",
+    "Maximal number of concurrently running requests, 0 means number of threads.",
+    CLI::Option::IntType(0)
+};
+// clang-format on
+}  // namespace OptionNames
+
+JulietdSettings::JulietdSettings(const PacBio::CLI::Results& options)
+    : SocketPath(options[OptionNames::Socket])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
+{
+    if (SocketPath.empty()) throw std::runtime_error("Please provide the socket path via -s");
+    const int maxJobs = options[OptionNames::MaxJobs];
+    if (maxJobs < 0) throw std::runtime_error("Number of jobs must not be negative");
+    MaxJobs = maxJobs == 0 ? NumThreads : maxJobs;
+}
+
+PacBio::CLI::Interface JulietdSettings::CreateCLI()
+{
+    PacBio::CLI::Interface i{
+        "julietd",
+        "Juliet daemon, keeps target configs warm and serves juliet requests over a Unix "
+        "domain socket.",
+        PacBio::MinorseqVersion() + " (commit " + PacBio::MinorseqGitSha1() + ")"};
+
+    i.AddHelpOption();     // use built-in help output
+    i.AddVersionOption();  // use built-in version output
+
+    // clang-format off
+    i.AddGroup("Configuration",
+    {
+        OptionNames::Socket,
+        OptionNames::NumThreads,
+        OptionNames::MaxJobs
+    });
+    // clang-format on
+
+    return i;
+}
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,189 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include <htslib/hts.h>
+#include <pbbam/MD5.h>
+#include <pbcopper/json/JSON.h>
+#include <pbcopper/utility/FileUtils.h>
+
+#include <pacbio/Version.h>
+
+#include <pacbio/juliet/JulietflowManifest.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace {
+// Bump version if the manifest layout changes
+const int version = 1;
+}
+
+JulietflowManifest::JulietflowManifest(const std::string& manifestPath)
+    : manifestPath_(manifestPath)
+{
+    if (Enabled()) Load();
+}
+
+void JulietflowManifest::Load()
+{
+    std::ifstream in(manifestPath_);
+    if (!in) return;
+
+    // A corrupt or foreign manifest is not fatal, all stages simply rerun
+    try {
+        const auto root = JSON::Json::parse(in);
+        if (root.at("version") != version) return;
+        const auto& stages = root.at("stages");
+        for (auto it = stages.cbegin(); it != stages.cend(); ++it) {
+            Stage stage;
+            stage.Fingerprint = it.value().at("fingerprint").get<std::string>();
+            const auto& outputs = it.value().at("outputs");
+            for (auto o = outputs.cbegin(); o != outputs.cend(); ++o)
+                stage.Outputs[o.key()] = o.value().get<std::string>();
+            stages_[it.key()] = std::move(stage);
+        }
+    } catch (const std::exception&) {
+        std::cerr << "WARNING: Ignoring unreadable manifest " << manifestPath_ << std::endl;
+        stages_.clear();
+    }
+}
+
+void JulietflowManifest::Store() const
+{
+    JSON::Json root;
+    root["version"] = version;
+    root["stages"] = JSON::Json::object();
+    for (const auto& s : stages_) {
+        JSON::Json stage;
+        stage["fingerprint"] = s.second.Fingerprint;
+        stage["outputs"] = JSON::Json::object();
+        for (const auto& o : s.second.Outputs)
+            stage["outputs"][o.first] = o.second;
+        root["stages"][s.first] = stage;
+    }
+
+    std::ostringstream tmpPath;
+    tmpPath << manifestPath_ << ".tmp." << getpid();
+    {
+        std::ofstream out(tmpPath.str());
+        out << root.dump(2) << std::endl;
+        out.close();
+        if (!out) {
+            std::remove(tmpPath.str().c_str());
+            throw std::runtime_error("Could not write manifest " + manifestPath_);
+        }
+    }
+    if (std::rename(tmpPath.str().c_str(), manifestPath_.c_str()) != 0) {
+        std::remove(tmpPath.str().c_str());
+        throw std::runtime_error("Could not write manifest " + manifestPath_);
+    }
+}
+
+bool JulietflowManifest::IsValid(const std::string& stage, const std::string& fingerprint) const
+{
+    const auto it = stages_.find(stage);
+    if (it == stages_.cend() || it->second.Fingerprint != fingerprint) return false;
+    for (const auto& o : it->second.Outputs)
+        if (!Utility::FileExists(o.first) || FileHash(o.first) != o.second) return false;
+    return true;
+}
+
+std::string JulietflowManifest::OutputHash(const std::string& stage,
+                                           const std::string& output) const
+{
+    const auto it = stages_.find(stage);
+    if (it == stages_.cend() || it->second.Outputs.find(output) == it->second.Outputs.cend())
+        throw std::runtime_error("No output " + output + " recorded for stage " + stage);
+    return it->second.Outputs.at(output);
+}
+
+void JulietflowManifest::Commit(const std::string& stage, const std::string& fingerprint,
+                                const std::vector<std::string>& outputs)
+{
+    if (!Enabled()) return;
+
+    Stage entry;
+    entry.Fingerprint = fingerprint;
+    for (const auto& o : outputs)
+        entry.Outputs[o] = FileHash(o);
+    stages_[stage] = std::move(entry);
+    Store();
+}
+
+std::string JulietflowManifest::FileHash(const std::string& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in) throw std::runtime_error("Could not read " + file);
+
+    // Outputs are BAM files, hash them in chunks instead of loading them
+    std::unique_ptr<hts_md5_context, void (*)(hts_md5_context*)> md5(hts_md5_init(),
+                                                                     hts_md5_destroy);
+    if (!md5) throw std::runtime_error("Could not initialize MD5");
+    std::vector<char> buffer(1 << 20);
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        hts_md5_update(md5.get(), buffer.data(), in.gcount());
+    }
+    if (in.bad()) throw std::runtime_error("Could not read " + file);
+
+    unsigned char digest[16];
+    char hex[33];
+    hts_md5_final(digest, md5.get());
+    hts_md5_hex(hex, digest);
+    return hex;
+}
+
+std::string JulietflowManifest::Fingerprint(const std::vector<std::string>& parts)
+{
+    // Length-prefix each part, concatenations cannot collide
+    std::ostringstream ss;
+    ss << PacBio::MinorseqVersion();
+    for (const auto& p : parts)
+        ss << '\n' << p.size() << ':' << p;
+    return BAM::MD5Hash(ss.str());
+}
+}
+}  // ::PacBio::Juliet
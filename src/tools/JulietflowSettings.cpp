@@ -0,0 +1,225 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/juliet/JulietflowSettings.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption Input{
+    "input",
+    { "input", "i" },
+    "Input",
+    "Unaligned CCS BAM or ConsensusReadSet. Required.",
+    CLI::Option::StringType("")
+};
+const PlainOption Reference{
+    "reference",
+    { "ref", "r" },
+    "Reference",
+    "Reference FASTA or ReferenceSet. Required.",
+    CLI::Option::StringType("")
+};
+const PlainOption TargetConfigCLI{
+    "target_config_universal",
+    { "config", "c" },
+    "Target Config",
+    "Path to the target config JSON file, predefined target config tag, or the JSON string.",
+    CLI::Option::StringType("")
+};
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+const PlainOption MaxIterations{
+    "max_iterations",
+    { "max-iterations", "e" },
+    "Maximal Re-align Iterations",
+    "Maximal number of re-align iterations against the consensus.",
+    CLI::Option::IntType(1)
+};
+const PlainOption Target{
+    "target",
+    { "target", "t" },
+    "Target Reference",
+    "Target reference FASTA, per default using --ref.",
+    CLI::Option::StringType("")
+};
+const PlainOption MinimalPerc{
+    "minimal_percentage",
+    { "min-perc", "m" },
+    "Minimal Variant Percentage.",
+    "Minimal variant percentage to report.",
+    CLI::Option::FloatType(0)
+};
+const PlainOption MaximalPerc{
+    "maximal_percentage",
+    { "max-perc", "n" },
+    "Maximal Variant Percentage",
+    "Maximal variant percentage to report.",
+    CLI::Option::FloatType(100)
+};
+const PlainOption Region{
+    "region",
+    { "region", "g" },
+    "Region of Interest",
+    "Genomic region of interest, reads will be clipped to that region, empty means all reads.",
+    CLI::Option::StringType("")
+};
+const PlainOption Phasing{
+    "mode_phasing",
+    { "mode-phasing", "p" },
+    "Phase Variants",
+    "Phase variants and cluster haplotypes.",
+    CLI::Option::BoolType()
+};
+const PlainOption DRMOnly{
+    "only_known_drms",
+    { "drm-only", "k" },
+    "Only Report Variants in Target Config",
+    "Only report known DRM positions.",
+    CLI::Option::BoolType()
+};
+const PlainOption KeepIntermediates{
+    "keep_intermediates",
+    { "keep-intermediates", "z" },
+    "Keep Intermediate Files",
+    "Write alignments, consensus sequences, and the cleric output to <prefix>.tmp/. Reruns resume from the last valid stage.",
+    CLI::Option::BoolType()
+};
+const PlainOption WorkDir{
+    "work_dir",
+    { "work-dir", "w" },
+    "Work Directory",
+    "Persistent directory for intermediate files, implies -z. Reruns resume from the last valid stage.",
+    CLI::Option::StringType("")
+};
+const PlainOption Trace{
+    "trace",
+    { "trace" },
+    "Trace",
+    "Write begin and end of every stage and task per thread as Chrome trace events to this file, for Perfetto or chrome://tracing.",
+    CLI::Option::StringType("")
+};
+// clang-format on
+}  // namespace OptionNames
+
+JulietflowSettings::JulietflowSettings(const PacBio::CLI::Results& options)
+    : InputFile(options[OptionNames::Input])
+    , ReferenceFile(options[OptionNames::Reference])
+    , TargetFile(options[OptionNames::Target])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
+    , MaxIterations(options[OptionNames::MaxIterations])
+    , KeepIntermediates(options[OptionNames::KeepIntermediates])
+    , WorkDir(options[OptionNames::WorkDir])
+    , TraceFile(options[OptionNames::Trace])
+{
+    if (InputFile.empty()) throw std::runtime_error("Please provide the CCS BAM file via -i");
+    if (ReferenceFile.empty())
+        throw std::runtime_error("Please provide the reference FASTA file via -r");
+    if (TargetFile.empty()) TargetFile = ReferenceFile;
+    if (!WorkDir.empty()) KeepIntermediates = true;
+    if (MaxIterations < 0) throw std::runtime_error("Number of iterations must not be negative");
+
+    const std::string targetConfig = options[OptionNames::TargetConfigCLI];
+    JulietConfig.CLI = options.InputCommandLine();
+    JulietConfig.TargetConfigUser = targetConfig;
+    JulietConfig.DRMOnly = options[OptionNames::DRMOnly];
+    JulietConfig.MinimalPerc = options[OptionNames::MinimalPerc];
+    JulietConfig.MaximalPerc = options[OptionNames::MaximalPerc];
+    JulietConfig.NumThreads = NumThreads;
+    const bool phasing = options[OptionNames::Phasing];
+    if (phasing) JulietConfig.Mode = AnalysisMode::PHASING;
+    JulietSettings::SplitRegion(options[OptionNames::Region], &JulietConfig.RegionStart,
+                                &JulietConfig.RegionEnd);
+}
+
+PacBio::CLI::Interface JulietflowSettings::CreateCLI()
+{
+    PacBio::CLI::Interface i{
+        "julietflow",
+        "Minor variant pipeline, aligns, re-aligns against the consensus, lifts over to the "
+        "target, and calls variants in a single process.",
+        PacBio::MinorseqVersion() + " (commit " + PacBio::MinorseqGitSha1() + ")"};
+
+    i.AddHelpOption();     // use built-in help output
+    i.AddVersionOption();  // use built-in version output
+
+    // clang-format off
+    i.AddGroup("Input",
+    {
+        OptionNames::Input,
+        OptionNames::Reference,
+        OptionNames::Target
+    });
+
+    i.AddGroup("Configuration",
+    {
+        OptionNames::TargetConfigCLI,
+        OptionNames::NumThreads,
+        OptionNames::MaxIterations,
+        OptionNames::Phasing,
+        OptionNames::KeepIntermediates,
+        OptionNames::WorkDir,
+        OptionNames::Trace
+    });
+
+    i.AddGroup("Restrictions",
+    {
+        OptionNames::Region,
+        OptionNames::DRMOnly,
+        OptionNames::MinimalPerc,
+        OptionNames::MaximalPerc
+    });
+    // clang-format on
+
+    return i;
+}
+}
+}  // ::PacBio::Juliet
@@ -0,0 +1,301 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <pbbam/BamFile.h>
+#include <pbbam/BamWriter.h>
+#include <pbbam/MD5.h>
+#include <pbbam/PbiFile.h>
+#include <pbcopper/utility/FileUtils.h>
+
+#include <pacbio/align/ReadAligner.h>
+#include <pacbio/cleric/Cleric.h>
+#include <pacbio/fuse/Fuse.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/JulietWorkflow.h>
+#include <pacbio/juliet/JulietflowManifest.h>
+#include <pacbio/util/ThreadPool.h>
+#include <pacbio/util/Tracer.h>
+
+#include <pacbio/juliet/JulietflowWorkflow.h>
+
+namespace PacBio {
+namespace Juliet {
+namespace {
+const std::string consensusName = "CONSENSUS";
+
+bool CoordinateLess(const BAM::BamRecord& a, const BAM::BamRecord& b)
+{
+    return std::make_pair(a.ReferenceId(), a.ReferenceStart()) <
+           std::make_pair(b.ReferenceId(), b.ReferenceStart());
+}
+
+std::vector<BAM::BamRecord> LoadAlignments(const std::string& file)
+{
+    std::vector<BAM::BamRecord> records;
+    auto query = IO::BamQuery(file);
+    for (const auto& record : *query)
+        records.emplace_back(record);
+    return records;
+}
+
+std::string AlignerParameters(const Align::ReadAlignerConfig& config)
+{
+    std::ostringstream ss;
+    ss << config.KmerSize << ' ' << config.WindowSize << ' ' << config.MaxOccurrences << ' '
+       << config.MinSeeds << ' ' << config.BandWidth << ' ' << +config.MatchScore << ' '
+       << +config.MismatchPenalty << ' ' << +config.GapOpenPenalty << ' '
+       << +config.GapExtendPenalty;
+    return ss.str();
+}
+
+std::string JulietParameters(const JulietSettings& settings)
+{
+    // The parsed target config, not the -c argument, file content counts
+    const auto& config = settings.TargetConfigUser;
+    std::ostringstream ss;
+    ss << std::setprecision(17) << TargetGene::ToJson(config.targetGenes).dump() << ' '
+       << config.referenceName << ' ' << config.referenceSequence << ' ' << config.version << ' '
+       << config.dbVersion << ' ' << settings.RegionStart << ' ' << settings.RegionEnd << ' '
+       << settings.DRMOnly << ' ' << settings.MergeOutliers << ' '
+       << static_cast<int>(settings.Mode) << ' ' << settings.SubstitutionRate << ' '
+       << settings.DeletionRate << ' ' << settings.MinimalPerc << ' ' << settings.MaximalPerc;
+    return ss.str();
+}
+}
+
+void JulietflowWorkflow::Run(const JulietflowSettings& settings)
+{
+    // Outputs are written to the working directory, named after the input
+    auto prefix = Utility::FilePrefix(settings.InputFile);
+    const auto slash = prefix.find_last_of('/');
+    if (slash != std::string::npos) prefix = prefix.substr(slash + 1);
+
+    // Intermediate files and the manifest persist in the work directory,
+    // a rerun resumes after the last stage whose outputs are still valid
+    std::string tmpPrefix;
+    std::string manifestPath;
+    if (settings.KeepIntermediates) {
+        const auto workDir = settings.WorkDir.empty() ? prefix + ".tmp" : settings.WorkDir;
+        if (mkdir(workDir.c_str(), 0777) != 0 && errno != EEXIST)
+            throw std::runtime_error("Could not create directory " + workDir);
+        tmpPrefix = workDir + "/" + prefix;
+        manifestPath = tmpPrefix + ".manifest.json";
+    }
+    const auto Intermediate = [&tmpPrefix](const std::string& suffix) {
+        return tmpPrefix.empty() ? std::string() : tmpPrefix + suffix;
+    };
+
+    JulietflowManifest manifest(manifestPath);
+    const auto IsDone = [&manifest](const std::string& stage, const std::string& fingerprint) {
+        if (!manifest.IsValid(stage, fingerprint)) return false;
+        std::cerr << "Resuming after stage " << stage << ", outputs are up to date" << std::endl;
+        return true;
+    };
+    const auto Hash = [&manifest](const std::string& file) {
+        return manifest.Enabled() ? JulietflowManifest::FileHash(file) : std::string();
+    };
+
+    // Unaligned reads are loaded once and re-used by every alignment round,
+    // but only if a round has to run
+    std::vector<BAM::BamRecord> reads;
+    const auto Reads = [&reads, &settings]() -> const std::vector<BAM::BamRecord>& {
+        if (reads.empty()) {
+            auto query = IO::BamQuery(settings.InputFile);
+            for (const auto& record : *query)
+                reads.emplace_back(record);
+        }
+        return reads;
+    };
+    const auto inputHash = Hash(settings.InputFile);
+    const auto alignerParameters = AlignerParameters(settings.AlignConfig);
+
+    // The current alignment is identified by the hash of its BAM file.
+    // Alignments of skipped stages are loaded from disk on first use.
+    std::vector<BAM::BamRecord> alignments;
+    bool alignmentsLoaded = false;
+    std::string alignmentFile;
+    std::string alignmentHash;
+    const auto Alignments = [&]() -> std::vector<BAM::BamRecord>& {
+        if (!alignmentsLoaded) {
+            alignments = LoadAlignments(alignmentFile);
+            alignmentsLoaded = true;
+        }
+        return alignments;
+    };
+    const auto MapStage = [&](const int round, const std::vector<BAM::FastaSequence>& references,
+                              const std::string& referenceHash) {
+        const auto stage = "align_" + std::to_string(round);
+        Util::TraceScope trace(stage, "julietflow");
+        const auto fingerprint =
+            JulietflowManifest::Fingerprint({stage, inputHash, referenceHash, alignerParameters});
+        alignmentFile = Intermediate("_" + std::to_string(round) + ".align.bam");
+        if (IsDone(stage, fingerprint)) {
+            alignments.clear();
+            alignmentsLoaded = false;
+        } else {
+            alignments = MapReads(Reads(), references, settings, alignmentFile);
+            alignmentsLoaded = true;
+            manifest.Commit(stage, fingerprint, {alignmentFile});
+        }
+        if (manifest.Enabled()) alignmentHash = manifest.OutputHash(stage, alignmentFile);
+    };
+
+    // Align against given reference
+    MapStage(0, Align::ReadReferences(settings.ReferenceFile), Hash(settings.ReferenceFile));
+
+    // Iteratively align against previous consensus
+    std::string consensus;
+    for (int i = 1; i <= settings.MaxIterations; ++i) {
+        const auto round = std::to_string(i);
+        const auto stage = "fuse_" + round;
+        const auto fingerprint = JulietflowManifest::Fingerprint({stage, alignmentHash});
+        const auto fastaFile = Intermediate("_" + round + "_ref.fasta");
+        {
+            Util::TraceScope trace(stage, "julietflow");
+            if (IsDone(stage, fingerprint)) {
+                consensus = Align::ReadReferences(fastaFile).front().Bases();
+            } else {
+                consensus = Fuse::Fuse(IO::RecordsToArrayReads(Alignments())).ConsensusSequence();
+                if (!fastaFile.empty()) {
+                    std::ofstream fastaStream(fastaFile);
+                    fastaStream << ">" << consensusName << std::endl;
+                    fastaStream << consensus << std::endl;
+                }
+                manifest.Commit(stage, fingerprint, {fastaFile});
+            }
+        }
+
+        MapStage(i, {BAM::FastaSequence(consensusName, consensus)}, BAM::MD5Hash(consensus));
+    }
+
+    // Re-map last alignment against the target reference
+    if (settings.MaxIterations >= 1) {
+        const auto targets = Align::ReadReferences(settings.TargetFile);
+        if (targets.size() != 1)
+            throw std::runtime_error("Only one target reference allowed: " + settings.TargetFile);
+        std::string target = targets.front().Bases();
+        std::transform(target.begin(), target.end(), target.begin(), ::toupper);
+
+        const std::string stage = "cleric";
+        Util::TraceScope trace(stage, "julietflow");
+        const auto fingerprint =
+            JulietflowManifest::Fingerprint({stage, alignmentHash, BAM::MD5Hash(consensus),
+                                             BAM::MD5Hash(target), targets.front().Name()});
+        const auto clericFile = Intermediate("_cleric.bam");
+        if (IsDone(stage, fingerprint)) {
+            alignments.clear();
+            alignmentsLoaded = false;
+        } else {
+            auto& records = Alignments();
+            const Cleric::Cleric cleric(consensus, consensusName, target, targets.front().Name());
+            Util::ParallelFor(0, records.size(),
+                              [&cleric, &records](size_t i) { cleric.Convert(&records[i]); });
+            std::stable_sort(records.begin(), records.end(), CoordinateLess);
+
+            if (!clericFile.empty())
+                WriteAlignments(clericFile, cleric.ConvertHeader(Align::AlignedHeader(
+                                                settings.InputFile,
+                                                {BAM::FastaSequence(consensusName, consensus)})),
+                                records, settings.NumThreads);
+            manifest.Commit(stage, fingerprint, {clericFile});
+        }
+        alignmentFile = clericFile;
+        if (manifest.Enabled()) alignmentHash = manifest.OutputHash(stage, alignmentFile);
+    }
+
+    const auto& julietSettings = settings.JulietConfig;
+    const std::string stage = "juliet";
+    Util::TraceScope trace(stage, "julietflow");
+    const auto fingerprint = JulietflowManifest::Fingerprint(
+        {stage, alignmentHash, settings.InputFile, JulietParameters(julietSettings)});
+    const auto outputHtml = prefix + ".html";
+    const auto outputJson = prefix + ".json";
+    if (IsDone(stage, fingerprint)) return;
+
+    const auto sharedReads =
+        IO::BamToArrayReads(Alignments(), julietSettings.RegionStart, julietSettings.RegionEnd);
+    if (sharedReads.empty())
+        throw std::runtime_error("Could not align any read of " + settings.InputFile);
+
+    JulietWorkflow juliet;
+    juliet.CallVariants(sharedReads, julietSettings, settings.InputFile, outputHtml, outputJson);
+    manifest.Commit(stage, fingerprint, {outputHtml, outputJson});
+}
+
+std::vector<BAM::BamRecord> JulietflowWorkflow::MapReads(
+    const std::vector<BAM::BamRecord>& reads, const std::vector<BAM::FastaSequence>& references,
+    const JulietflowSettings& settings, const std::string& outputFile) const
+{
+    const Align::ReadAligner aligner(references, settings.AlignConfig);
+    auto alignments = aligner.Map(reads);
+
+    if (!outputFile.empty())
+        WriteAlignments(outputFile, Align::AlignedHeader(settings.InputFile, references),
+                        alignments, settings.NumThreads);
+    return alignments;
+}
+
+void JulietflowWorkflow::WriteAlignments(const std::string& outputFile,
+                                         const BAM::BamHeader& header,
+                                         const std::vector<BAM::BamRecord>& records,
+                                         size_t numThreads) const
+{
+    {
+        BAM::BamWriter writer(outputFile, header, BAM::BamWriter::DefaultCompression, numThreads);
+        for (const auto& record : records)
+            writer.Write(record);
+    }
+
+    const BAM::BamFile alignedFile(outputFile);
+    alignedFile.CreateStandardIndex();
+    BAM::PbiFile::CreateFrom(alignedFile);
+}
+}
+}  // ::PacBio::Juliet
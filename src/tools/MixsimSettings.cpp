@@ -0,0 +1,193 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <stdexcept>
+
+#include <pacbio/Version.h>
+#include <pacbio/data/PlainOption.h>
+#include <pacbio/util/ThreadPool.h>
+#include <boost/algorithm/string.hpp>
+
+#include <pacbio/mixsim/MixsimSettings.h>
+
+namespace PacBio {
+namespace Mixsim {
+namespace OptionNames {
+using PlainOption = Data::PlainOption;
+// clang-format off
+const PlainOption TargetConfig{
+    "target_config_universal",
+    { "config", "c" },
+    "Target Config",
+    "Path to the target config JSON file, predefined target config tag, or the JSON string. "
+    "Variants are placed in its genes.",
+    CLI::Option::StringType("")
+};
+const PlainOption Coverage{
+    "coverage",
+    { "coverage" },
+    "Coverage",
+    "Number of reads.",
+    CLI::Option::IntType(3000)
+};
+const PlainOption MinorPercentages{
+    "minor_percentages",
+    { "minor-perc", "m" },
+    "Minor Percentages",
+    "Comma-separated percentage of each minor haplotype, the major takes the remainder.",
+    CLI::Option::StringType("1")
+};
+const PlainOption VariantsPerHaplotype{
+    "variants_per_haplotype",
+    { "variants" },
+    "Variants per Haplotype",
+    "Number of linked amino acid substitutions of each minor haplotype.",
+    CLI::Option::IntType(3)
+};
+const PlainOption SubstitutionRate{
+    "substitution_rate",
+    { "sub", "s" },
+    "Substitution Rate",
+    "Substitution rate, 0 together with a deletion rate of 0 uses the S/P2-C2 estimates.",
+    CLI::Option::FloatType(0)
+};
+const PlainOption DeletionRate{
+    "deletion_rate",
+    { "del", "d" },
+    "Deletion Rate",
+    "Deletion rate.",
+    CLI::Option::FloatType(0)
+};
+const PlainOption InsertionRate{
+    "insertion_rate",
+    { "ins" },
+    "Insertion Rate",
+    "Insertion rate, juliet's error model assumes none.",
+    CLI::Option::FloatType(0)
+};
+const PlainOption PartialPercentage{
+    "partial_percentage",
+    { "partial-perc" },
+    "Partial Read Percentage",
+    "Percentage of reads that cover only part of the reference.",
+    CLI::Option::FloatType(10)
+};
+const PlainOption Seed{
+    "seed",
+    { "seed" },
+    "Seed",
+    "Seed of the random number generator, equal seeds produce equal output.",
+    CLI::Option::IntType(42)
+};
+const PlainOption NumThreads{
+    "num_threads",
+    { "j", "num-threads" },
+    "Number of Threads",
+    "Number of threads to use, 0 means autodetection.",
+    CLI::Option::IntType(0)
+};
+// clang-format on
+}
+
+MixsimSettings::MixsimSettings(const PacBio::CLI::Results& options)
+    : VariantsPerHaplotype(options[OptionNames::VariantsPerHaplotype])
+    , SubstitutionRate(options[OptionNames::SubstitutionRate])
+    , DeletionRate(options[OptionNames::DeletionRate])
+    , InsertionRate(options[OptionNames::InsertionRate])
+    , PartialPercentage(options[OptionNames::PartialPercentage])
+    , NumThreads(Util::ThreadPool::ThreadCount(options[OptionNames::NumThreads]))
+{
+    const size_t numArgs = options.PositionalArguments().size();
+    if (numArgs != 2)
+        throw std::runtime_error("Mixsim needs one reference and one output argument!");
+    ReferenceFile = options.PositionalArguments().front();
+    OutputFile = options.PositionalArguments().back();
+
+    const std::string targetConfig = options[OptionNames::TargetConfig];
+    if (!targetConfig.empty()) TargetConfigUser = targetConfig;
+
+    const int coverage = options[OptionNames::Coverage];
+    if (coverage < 1) throw std::runtime_error("Coverage must be positive");
+    Coverage = coverage;
+
+    const int seed = options[OptionNames::Seed];
+    Seed = static_cast<uint32_t>(seed);
+
+    const std::string percentages = options[OptionNames::MinorPercentages];
+    MinorPercentages.clear();
+    if (!percentages.empty()) {
+        std::vector<std::string> splitVec;
+        boost::split(splitVec, percentages, boost::is_any_of(","));
+        for (const auto& p : splitVec)
+            MinorPercentages.push_back(std::stod(p));
+    }
+}
+
+PacBio::CLI::Interface MixsimSettings::CreateCLI()
+{
+    PacBio::CLI::Interface i{
+        "mixsim", "Mixsim, simulate deep CCS amplicon sequencing of minor variants",
+        PacBio::MinorseqVersion() + " (commit " + PacBio::MinorseqGitSha1() + ")"};
+
+    i.AddHelpOption();     // use built-in help output
+    i.AddVersionOption();  // use built-in version output
+
+    // clang-format off
+    i.AddPositionalArguments({
+        {"reference", "Reference fasta, the first sequence is used.", "FILE"},
+        {"output", "Output BAM, aligned to the reference.", "FILE"}
+    });
+
+    i.AddOptions(
+    {
+        OptionNames::TargetConfig,
+        OptionNames::Coverage,
+        OptionNames::MinorPercentages,
+        OptionNames::VariantsPerHaplotype,
+        OptionNames::SubstitutionRate,
+        OptionNames::DeletionRate,
+        OptionNames::InsertionRate,
+        OptionNames::PartialPercentage,
+        OptionNames::Seed,
+        OptionNames::NumThreads
+    });
+    // clang-format on
+
+    return i;
+}
+}
+}  // ::PacBio::Mixsim
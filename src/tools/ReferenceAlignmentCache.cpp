@@ -0,0 +1,174 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <pbbam/MD5.h>
+
+#include <pacbio/cleric/ReferenceAlignmentCache.h>
+
+namespace PacBio {
+namespace Cleric {
+namespace {
+// Bump version if the alignment or the liftover changes semantics
+const std::string magic = "CLERIC_REFERENCE_ALIGNMENT";
+const int version = 2;
+
+void WriteMap(std::ostream& out, const std::map<int, int>& m)
+{
+    out << m.size() << '\n';
+    for (const auto& kv : m)
+        out << kv.first << ' ' << kv.second << '\n';
+}
+
+bool ReadMap(std::istream& in, std::map<int, int>* m)
+{
+    size_t size;
+    if (!(in >> size)) return false;
+    for (size_t i = 0; i < size; ++i) {
+        int key;
+        int value;
+        if (!(in >> key >> value)) return false;
+        m->emplace_hint(m->cend(), key, value);
+    }
+    return true;
+}
+}
+
+ReferenceAlignmentCache::ReferenceAlignmentCache(const std::string& cacheDir) : cacheDir_(cacheDir)
+{
+    if (mkdir(cacheDir_.c_str(), 0777) != 0 && errno != EEXIST)
+        throw std::runtime_error("Could not create cache directory: " + cacheDir_);
+}
+
+std::string ReferenceAlignmentCache::EntryPath(const std::string& fromMD5,
+                                               const std::string& toMD5) const
+{
+    return cacheDir_ + "/" + fromMD5 + "_" + toMD5 + ".cleric";
+}
+
+bool ReferenceAlignmentCache::Load(const std::string& fromMD5, const std::string& toMD5,
+                                   ReferenceAlignment* alignment) const
+{
+    std::ifstream file(EntryPath(fromMD5, toMD5));
+    if (!file) return false;
+    std::ostringstream content;
+    content << file.rdbuf();
+    const std::string entryString = content.str();
+
+    // Entries end with the magic string and the MD5 of the body, guards
+    // against truncated and corrupted files
+    if (entryString.size() < 2 || entryString.back() != '\n') return false;
+    const size_t footerStart = entryString.rfind('\n', entryString.size() - 2) + 1;
+    size_t bodyStart = 0;
+    for (int i = 0; i < 3; ++i) {
+        bodyStart = entryString.find('\n', bodyStart);
+        if (bodyStart == std::string::npos || bodyStart >= footerStart) return false;
+        ++bodyStart;
+    }
+    const std::string body = entryString.substr(bodyStart, footerStart - bodyStart);
+    if (entryString.compare(footerStart, std::string::npos,
+                            magic + ' ' + BAM::MD5Hash(body) + '\n') != 0)
+        return false;
+
+    std::istringstream header(entryString.substr(0, bodyStart));
+    std::string fileMagic;
+    int fileVersion;
+    std::string fileFromMD5;
+    std::string fileToMD5;
+    if (!(header >> fileMagic >> fileVersion >> fileFromMD5 >> fileToMD5)) return false;
+    if (fileMagic != magic || fileVersion != version || fileFromMD5 != fromMD5 ||
+        fileToMD5 != toMD5)
+        return false;
+
+    std::istringstream in(body);
+    ReferenceAlignment entry;
+    if (!(in >> entry.FromReferenceAligned >> entry.ToReferenceAligned)) return false;
+    if (entry.FromReferenceAligned.size() != entry.ToReferenceAligned.size()) return false;
+    if (!ReadMap(in, &entry.SamPosToFastaPos)) return false;
+    if (!ReadMap(in, &entry.FastaPosToSamPos)) return false;
+    if (!(in >> std::ws).eof()) return false;
+
+    *alignment = std::move(entry);
+    return true;
+}
+
+void ReferenceAlignmentCache::Store(const std::string& fromMD5, const std::string& toMD5,
+                                    const ReferenceAlignment& alignment) const
+{
+    const auto entryPath = EntryPath(fromMD5, toMD5);
+    std::ostringstream tmpPath;
+    tmpPath << entryPath << ".tmp." << getpid() << "."
+            << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    std::ostringstream body;
+    body << alignment.FromReferenceAligned << '\n' << alignment.ToReferenceAligned << '\n';
+    WriteMap(body, alignment.SamPosToFastaPos);
+    WriteMap(body, alignment.FastaPosToSamPos);
+
+    {
+        std::ofstream out(tmpPath.str());
+        out << magic << ' ' << version << '\n' << fromMD5 << '\n' << toMD5 << '\n';
+        out << body.str();
+        out << magic << ' ' << BAM::MD5Hash(body.str()) << '\n';
+        out.close();
+        if (!out) {
+            std::remove(tmpPath.str().c_str());
+            std::cerr << "WARNING: Could not write cache entry " << entryPath << std::endl;
+            return;
+        }
+    }
+
+    // rename is atomic, concurrent writers of the same pair produce identical entries
+    if (std::rename(tmpPath.str().c_str(), entryPath.c_str()) != 0) {
+        std::remove(tmpPath.str().c_str());
+        std::cerr << "WARNING: Could not write cache entry " << entryPath << std::endl;
+    }
+}
+}
+}  // ::PacBio::Cleric
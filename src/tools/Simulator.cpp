@@ -0,0 +1,353 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+#include <pbbam/BamFile.h>
+#include <pbbam/BamWriter.h>
+#include <pbbam/MD5.h>
+#include <pbbam/PbiFile.h>
+
+#include <pacbio/io/JsonWriter.h>
+#include <pacbio/juliet/AminoAcidTable.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include <pacbio/mixsim/Simulator.h>
+
+namespace PacBio {
+namespace Mixsim {
+namespace {
+const char bases[] = "ACGT";
+
+// The distributions of <random> differ between standard libraries. These
+// only transform the output of mt19937, which is fully specified, so a seed
+// gives the same reads with every compiler.
+
+/// Uniform in [lo, hi]
+int UniformInt(std::mt19937* rng, const int lo, const int hi)
+{
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+    return lo + static_cast<int>((static_cast<uint64_t>((*rng)()) * range) >> 32);
+}
+
+/// Uniform in [0, 1)
+double Uniform(std::mt19937* rng) { return (*rng)() * (1.0 / 4294967296.0); }
+
+/// Number of failures before the first success with probability p
+int Geometric(std::mt19937* rng, const double p)
+{
+    const double failures = std::floor(std::log(1.0 - Uniform(rng)) / std::log1p(-p));
+    return static_cast<int>(std::min(failures, 1e9));
+}
+
+int Phred(const double errorRate)
+{
+    if (errorRate <= 0) return 93;
+    return std::max(1, std::min(93, static_cast<int>(std::round(-10 * std::log10(errorRate)))));
+}
+
+void AppendOperation(const BAM::CigarOperationType type, BAM::Cigar* cigar)
+{
+    if (!cigar->empty() && cigar->back().Type() == type)
+        cigar->back().Length(cigar->back().Length() + 1);
+    else
+        cigar->emplace_back(type, 1);
+}
+
+char AminoAcid(const std::string& codon)
+{
+    const auto it = Juliet::AminoAcidTable::FromCodon.find(codon);
+    return it == Juliet::AminoAcidTable::FromCodon.cend() ? '?' : it->second;
+}
+}
+
+Simulator::Simulator(const std::string& referenceName, const std::string& reference,
+                     const MixsimSettings& settings)
+    : settings_(settings)
+    , referenceName_(referenceName)
+    , reference_(reference)
+    , readGroup_("mixsim", "CCS")
+{
+    if (reference_.size() < 3) throw std::runtime_error("Reference is shorter than a codon");
+    if (settings_.Coverage == 0) throw std::runtime_error("Coverage must be positive");
+
+    double substitution = settings_.SubstitutionRate;
+    double deletion = settings_.DeletionRate;
+    if (substitution == 0 && deletion == 0) {
+        const Juliet::ErrorEstimates chemistry("S/P2-C2");
+        substitution = 3 * chemistry.Substitution();
+        deletion = chemistry.Deletion();
+    }
+    const double insertion = settings_.InsertionRate;
+    error_ = Juliet::ErrorEstimates(1 - substitution - deletion - insertion, substitution, deletion,
+                                    insertion);
+
+    // Kits of S/P2-C2, juliet derives its error model from the chemistry
+    readGroup_.BindingKit("100-862-200")
+        .SequencingKit("100-861-800")
+        .BasecallerVersion("4.0")
+        .FrameRateHz("80");
+
+    CreateHaplotypes(settings_.TargetConfigUser.targetGenes);
+    AssignReads();
+}
+
+void Simulator::CreateHaplotypes(std::vector<Juliet::TargetGene> genes)
+{
+    const int length = reference_.size();
+    // Same as juliet without a target config
+    if (genes.empty()) genes.emplace_back(1, length + 1, "Unnamed ORF", std::vector<Juliet::DRM>());
+
+    double minorPercentage = 0;
+    for (const double p : settings_.MinorPercentages) {
+        if (p <= 0) throw std::runtime_error("Minor percentages must be positive");
+        minorPercentage += p;
+    }
+    if (minorPercentage >= 100) throw std::runtime_error("Minor percentages sum to 100 or more");
+
+    haplotypes_.push_back({"major", 100 - minorPercentage, 0, reference_, {}});
+
+    std::mt19937 rng(settings_.Seed);
+    const int numGenes = genes.size();
+    std::set<int> usedCodons;
+    for (size_t h = 0; h < settings_.MinorPercentages.size(); ++h) {
+        SimulatedHaplotype haplotype{
+            "minor_" + std::to_string(h + 1), settings_.MinorPercentages[h], 0, reference_, {}};
+        // Non-synonymous substitutions at distinct codons, stop codons excluded
+        int tries = 0;
+        while (static_cast<int>(haplotype.Variants.size()) < settings_.VariantsPerHaplotype) {
+            if (++tries > 1000 * std::max(1, settings_.VariantsPerHaplotype))
+                throw std::runtime_error("Could not place " +
+                                         std::to_string(settings_.VariantsPerHaplotype) +
+                                         " variants in the target genes");
+            const auto& g = genes[UniformInt(&rng, 0, numGenes - 1)];
+            const int numCodons = (std::max(0, g.end - 2 - g.begin) + 2) / 3;
+            if (numCodons == 0) continue;
+            const int codon = UniformInt(&rng, 0, numCodons - 1);
+            const int pos = g.begin + 3 * codon;
+            if (pos < 1 || pos + 2 > length || usedCodons.count(pos)) continue;
+
+            const std::string refCodon = reference_.substr(pos - 1, 3);
+            std::string altCodon = refCodon;
+            const int b = UniformInt(&rng, 0, 2);
+            const char* refBase = std::strchr(bases, refCodon[b]);
+            if (refBase == nullptr || *refBase == '\0') continue;
+            altCodon[b] = bases[(refBase - bases + UniformInt(&rng, 1, 3)) % 4];
+
+            const char refAA = AminoAcid(refCodon);
+            const char altAA = AminoAcid(altCodon);
+            if (refAA == '?' || altAA == '?' || altAA == 'X' || refAA == altAA) continue;
+
+            usedCodons.insert(pos);
+            haplotype.Sequence.replace(pos - 1, 3, altCodon);
+            haplotype.Variants.push_back({g.name, pos, codon + 1, refCodon, altCodon});
+        }
+        std::sort(haplotype.Variants.begin(), haplotype.Variants.end(),
+                  [](const SimulatedVariant& a, const SimulatedVariant& b) {
+                      return a.Position < b.Position;
+                  });
+        haplotypes_.emplace_back(std::move(haplotype));
+    }
+}
+
+void Simulator::AssignReads()
+{
+    size_t minorReads = 0;
+    for (size_t h = 1; h < haplotypes_.size(); ++h) {
+        haplotypes_[h].NumReads =
+            std::llround(settings_.Coverage * haplotypes_[h].Percentage / 100.0);
+        minorReads += haplotypes_[h].NumReads;
+    }
+    if (minorReads > settings_.Coverage)
+        throw std::runtime_error("Minor haplotypes exceed the coverage");
+    haplotypes_.front().NumReads = settings_.Coverage - minorReads;
+
+    readHaplotype_.reserve(settings_.Coverage);
+    for (size_t h = 0; h < haplotypes_.size(); ++h)
+        readHaplotype_.insert(readHaplotype_.end(), haplotypes_[h].NumReads, h);
+    // Fisher-Yates, std::shuffle is implementation-defined as well
+    std::mt19937 rng(settings_.Seed);
+    for (int i = static_cast<int>(readHaplotype_.size()) - 1; i > 0; --i)
+        std::swap(readHaplotype_[i], readHaplotype_[UniformInt(&rng, 0, i)]);
+}
+
+BAM::BamRecord Simulator::Read(const size_t idx) const
+{
+    using BAM::CigarOperationType;
+
+    std::seed_seq seed{settings_.Seed, static_cast<uint32_t>(idx),
+                       static_cast<uint32_t>(idx >> 32)};
+    std::mt19937 rng(seed);
+
+    const std::string& haplotype = haplotypes_[readHaplotype_.at(idx)].Sequence;
+    const int length = haplotype.size();
+
+    int begin = 0;
+    int end = length;
+    if (Uniform(&rng) * 100 < settings_.PartialPercentage) {
+        begin = UniformInt(&rng, 0, length / 2);
+        end = UniformInt(&rng, std::min(length, begin + length / 4 + 1), length);
+    }
+
+    // Errors are rare, skip to the next one instead of drawing per base
+    const double subRate = 3 * error_.Substitution();
+    const double errorRate = subRate + error_.Deletion() + error_.Insertion();
+    // CCS accuracy varies by read, erroneous bases have lower QVs
+    const int readQv = std::max(2, Phred(errorRate) + UniformInt(&rng, -3, 3));
+    const char goodQv = static_cast<char>(readQv + 33);
+    const char badQv = static_cast<char>(std::max(1, readQv / 3) + 33);
+
+    std::string sequence;
+    std::string qualities;
+    sequence.reserve(end - begin + 16);
+    qualities.reserve(end - begin + 16);
+    BAM::Cigar cigar;
+    int nextError = errorRate > 0 ? begin + Geometric(&rng, errorRate) : end;
+    for (int pos = begin; pos < end; ++pos) {
+        char b = haplotype[pos];
+        char qv = goodQv;
+        // Alignments begin and end in a match
+        if (pos == nextError) {
+            nextError = pos + 1 + Geometric(&rng, errorRate);
+            if (pos != begin && pos != end - 1) {
+                const double e = Uniform(&rng) * errorRate;
+                if (e < error_.Deletion()) {
+                    AppendOperation(CigarOperationType::DELETION, &cigar);
+                    continue;
+                } else if (e < error_.Deletion() + error_.Insertion()) {
+                    sequence += bases[UniformInt(&rng, 0, 3)];
+                    qualities += badQv;
+                    AppendOperation(CigarOperationType::INSERTION, &cigar);
+                } else {
+                    const char* p = std::strchr(bases, b);
+                    if (p != nullptr && *p != '\0')
+                        b = bases[(p - bases + UniformInt(&rng, 1, 3)) % 4];
+                    qv = badQv;
+                }
+            }
+        }
+        sequence += b;
+        qualities += qv;
+        AppendOperation(b == reference_[pos] ? CigarOperationType::SEQUENCE_MATCH
+                                             : CigarOperationType::SEQUENCE_MISMATCH,
+                        &cigar);
+    }
+
+    BAM::BamRecord record;
+    record.Impl().Name("mixsim/" + std::to_string(idx) + "/ccs");
+    record.Impl().SetSequenceAndQualities(sequence, qualities);
+    record.ReadGroup(readGroup_);
+    record.HoleNumber(static_cast<int32_t>(idx));
+    record.Map(0, begin, BAM::Strand::FORWARD, cigar, 60);
+    return record;
+}
+
+BAM::BamHeader Simulator::Header() const
+{
+    BAM::BamHeader header;
+    header.Version("1.5").SortOrder("unknown").PacBioBamVersion("3.0.1");
+    header.AddSequence(BAM::SequenceInfo(referenceName_, std::to_string(reference_.size()))
+                           .Checksum(BAM::MD5Hash(reference_)));
+    header.AddReadGroup(readGroup_);
+    return header;
+}
+
+void Simulator::WriteBam(const std::string& outputFile) const
+{
+    // Bounds memory for deep coverage; batches are written in read order
+    static const size_t batchSize = 16384;
+    {
+        BAM::BamWriter writer(outputFile, Header(), BAM::BamWriter::DefaultCompression,
+                              settings_.NumThreads);
+        std::vector<BAM::BamRecord> batch;
+        for (size_t first = 0; first < NumReads(); first += batchSize) {
+            batch.resize(std::min(batchSize, NumReads() - first));
+            Util::ParallelFor(0, batch.size(),
+                              [this, first, &batch](size_t i) { batch[i] = Read(first + i); });
+            for (const auto& record : batch)
+                writer.Write(record);
+        }
+    }
+    BAM::PbiFile::CreateFrom(BAM::BamFile(outputFile));
+}
+
+void Simulator::WriteTruth(std::ostream& out) const
+{
+    IO::JsonWriter json(out);
+    json.BeginObject();
+    json.Member("reference", referenceName_);
+    json.Member("coverage", NumReads());
+    json.Member("seed", settings_.Seed);
+    json.Key("error_model").BeginObject();
+    json.Member("substitution", 3 * error_.Substitution());
+    json.Member("deletion", error_.Deletion());
+    json.Member("insertion", error_.Insertion());
+    json.EndObject();
+    json.Key("haplotypes").BeginArray();
+    for (const auto& h : haplotypes_) {
+        json.BeginObject();
+        json.Member("name", h.Name);
+        json.Member("percentage", h.Percentage);
+        json.Member("num_reads", h.NumReads);
+        json.Key("variants").BeginArray();
+        for (const auto& v : h.Variants) {
+            json.BeginObject();
+            json.Member("gene", v.Gene);
+            json.Member("position", v.Position);
+            json.Member("amino_acid_position", v.AminoAcidPosition);
+            json.Member("ref_codon", v.RefCodon);
+            json.Member("alt_codon", v.AltCodon);
+            json.Member("ref_amino_acid", std::string(1, AminoAcid(v.RefCodon)));
+            json.Member("alt_amino_acid", std::string(1, AminoAcid(v.AltCodon)));
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+}
+}  // ::PacBio::Mixsim
@@ -51,6 +51,7 @@
 
 #include <pacbio/cleric/Cleric.h>
 #include <pacbio/cleric/ClericSettings.h>
+#include <pacbio/util/ThreadPool.h>
 
 namespace PacBio {
 namespace Cleric {
@@ -146,6 +147,7 @@ static int Runner(const PacBio::CLI::Results& options)
 
     // Parse options
     ClericSettings settings(options);
+    Util::ThreadPool::Configure(settings.NumThreads);
 
     std::string bamPath;
     std::string fromReference;
@@ -160,7 +162,7 @@ static int Runner(const PacBio::CLI::Results& options)
     if (outputFile.empty()) outputFile = PacBio::Utility::FilePrefix(bamPath) + "_cleric";
 
     Cleric cleric(bamPath, outputFile, fromReference, fromReferenceName, toReference,
-                  toReferenceName);
+                  toReferenceName, settings.CacheDir);
 
     return EXIT_SUCCESS;
 }
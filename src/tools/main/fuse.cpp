@@ -47,6 +47,7 @@
 
 #include <pacbio/fuse/Fuse.h>
 #include <pacbio/fuse/FuseSettings.h>
+#include <pacbio/util/ThreadPool.h>
 
 namespace PacBio {
 namespace Fuse {
@@ -61,6 +62,7 @@ static int Runner(const PacBio::CLI::Results& options)
 
     // Parse options
     FuseSettings settings(options);
+    Util::ThreadPool::Configure(settings.NumThreads);
 
     Fuse fuse(settings.InputFile, settings.MinCoverage);
 
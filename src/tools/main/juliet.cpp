@@ -44,22 +44,36 @@
 
 #include <pacbio/juliet/JulietSettings.h>
 #include <pacbio/juliet/JulietWorkflow.h>
+#include <pacbio/util/Profiler.h>
+#include <pacbio/util/Stats.h>
+#include <pacbio/util/ThreadPool.h>
+#include <pacbio/util/Tracer.h>
 
 namespace PacBio {
 namespace Juliet {
 
 static int Runner(const PacBio::CLI::Results& options)
 {
+    // Parse options
+    JulietSettings settings(options);
+
     // Check args size, as pbcopper does not enforce the correct number
-    if (options.PositionalArguments().empty()) {
+    if (settings.InputFiles.empty() && settings.SampleSheet.empty()) {
         std::cerr << "ERROR: Please provide BAM input, see --help" << std::endl;
         return EXIT_FAILURE;
     }
-
-    // Parse options
-    JulietSettings settings(options);
+    Util::ThreadPool::Configure(settings.NumThreads);
+    if (!settings.ProfileFile.empty()) Util::Profiler::Enable();
+    if (!settings.StatsFile.empty()) Util::Stats::Enable();
+    if (!settings.TraceFile.empty()) Util::Tracer::Enable();
     JulietWorkflow workflow;
     workflow.Run(settings);
+    if (!settings.ProfileFile.empty()) Util::Profiler::WriteJson(settings.ProfileFile);
+    if (!settings.TraceFile.empty()) Util::Tracer::WriteJson(settings.TraceFile);
+    if (settings.StatsFile == "-")
+        Util::Stats::Write(std::cerr);
+    else if (!settings.StatsFile.empty())
+        Util::Stats::WriteJson(settings.StatsFile);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,128 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pbcopper/cli/CLI.h>
+
+#include <pbbam/BamFile.h>
+#include <pbbam/BamWriter.h>
+#include <pbbam/PbiFile.h>
+
+#include <pacbio/align/AlignSettings.h>
+#include <pacbio/align/ReadAligner.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/util/ThreadPool.h>
+
+namespace PacBio {
+namespace Align {
+static int AlignRunner(const PacBio::CLI::Results& options)
+{
+    // Check args size, as pbcopper does not enforce the correct number
+    if (options.PositionalArguments().size() != 3) {
+        std::cerr << "ERROR: Please provide BAM input, reference, and output BAM, see --help"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Parse options
+    AlignSettings settings(options);
+    Util::ThreadPool::Configure(settings.NumThreads);
+
+    const auto references = ReadReferences(settings.ReferenceFile);
+    const auto header = AlignedHeader(settings.InputFile, references);
+
+    std::vector<BAM::BamRecord> reads;
+    auto query = IO::BamQuery(settings.InputFile);
+    for (const auto& record : *query)
+        reads.emplace_back(record);
+
+    const ReadAligner aligner(references, settings.Config);
+    const auto mapped = aligner.Map(reads);
+
+    {
+        BAM::BamWriter writer(settings.OutputFile, header, BAM::BamWriter::DefaultCompression,
+                              settings.NumThreads);
+        for (const auto& record : mapped)
+            writer.Write(record);
+    }
+
+    const BAM::BamFile alignedFile(settings.OutputFile);
+    alignedFile.CreateStandardIndex();
+    BAM::PbiFile::CreateFrom(alignedFile);
+
+    return EXIT_SUCCESS;
+}
+}
+};
+
+static void PrintUsage(std::ostream& out)
+{
+    out << "Usage: minorseq <command> [options]\n"
+           "\n"
+           "Commands:\n"
+           "  align    Align CCS reads to a reference, writes sorted and indexed BAM\n"
+           "\n"
+           "Use minorseq <command> --help for the options of a command."
+        << std::endl;
+}
+
+// Entry point
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        PrintUsage(std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    const std::string command = argv[1];
+    if (command == "align")
+        return PacBio::CLI::Run(argc - 1, argv + 1, PacBio::Align::AlignSettings::CreateCLI(),
+                                &PacBio::Align::AlignRunner);
+    if (command == "-h" || command == "--help") {
+        PrintUsage(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::cerr << "ERROR: Unknown command " << command << std::endl;
+    PrintUsage(std::cerr);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,182 @@
+// Python bindings of juliet's per-sample results. Count matrices and
+// variant columns are returned as read-only NumPy arrays that share memory
+// with the C++ buffers and keep their SampleArrays alive.
+
+%module minorseq
+
+%{
+#define SWIG_FILE_WITH_INIT
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include <pacbio/juliet/AnalysisMode.h>
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/SampleArrays.h>
+#include <pacbio/juliet/SampleReader.h>
+#include <pacbio/juliet/TargetConfig.h>
+
+using namespace PacBio::Juliet;
+
+namespace {
+template <typename T>
+struct NumpyType;
+template <>
+struct NumpyType<int32_t>
+{
+    static constexpr int value = NPY_INT32;
+};
+template <>
+struct NumpyType<double>
+{
+    static constexpr int value = NPY_FLOAT64;
+};
+
+/// Read-only view of data, with cols == 0 as a vector. The view holds a
+/// reference to owner, the Python object that owns data.
+template <typename T>
+PyObject* View(const std::vector<T>& data, npy_intp rows, npy_intp cols, PyObject* owner)
+{
+    npy_intp dims[2] = {rows, cols};
+    PyObject* array = PyArray_SimpleNewFromData(cols == 0 ? 1 : 2, dims, NumpyType<T>::value,
+                                                const_cast<T*>(data.data()));
+    if (array == nullptr) return nullptr;
+    auto* numpyArray = reinterpret_cast<PyArrayObject*>(array);
+    PyArray_CLEARFLAGS(numpyArray, NPY_ARRAY_WRITEABLE);
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject(numpyArray, owner) < 0) {
+        Py_DECREF(array);
+        return nullptr;
+    }
+    return array;
+}
+}
+%}
+
+%init %{
+import_array();
+%}
+
+%include <exception.i>
+%include <std_shared_ptr.i>
+%include <std_string.i>
+%include <std_vector.i>
+%include <stdint.i>
+
+%exception {
+    try {
+        $action
+    } catch (const std::exception& e) {
+        SWIG_exception(SWIG_RuntimeError, e.what());
+    }
+}
+
+%template(StringVector) std::vector<std::string>;
+%shared_ptr(PacBio::Juliet::SampleArrays)
+
+// Settings: plain fields only, the target config is set by name or JSON
+%ignore PacBio::Juliet::JulietSettings::JulietSettings(const PacBio::CLI::Results&);
+%ignore PacBio::Juliet::JulietSettings::ThreadCount;
+%ignore PacBio::Juliet::JulietSettings::CreateCLI;
+%ignore PacBio::Juliet::JulietSettings::SplitRegion;
+%ignore PacBio::Juliet::JulietSettings::AnalysisModeFromOptions;
+%ignore PacBio::Juliet::JulietSettings::TargetConfigUser;
+%include <pacbio/juliet/AnalysisMode.h>
+%include <pacbio/juliet/JulietSettings.h>
+%extend PacBio::Juliet::JulietSettings {
+    /// Predefined name, JSON file, or JSON string, as --config
+    void SetTargetConfig(const std::string& config)
+    {
+        $self->TargetConfigUser = PacBio::Juliet::TargetConfig(config);
+    }
+}
+
+// Buffers are only exposed as views
+%ignore PacBio::Juliet::SampleArrays::MsaCounts;
+%ignore PacBio::Juliet::SampleArrays::CodonGene;
+%ignore PacBio::Juliet::SampleArrays::CodonPos;
+%ignore PacBio::Juliet::SampleArrays::CodonCoverage;
+%ignore PacBio::Juliet::SampleArrays::CodonCounts;
+%ignore PacBio::Juliet::SampleArrays::VariantGene;
+%ignore PacBio::Juliet::SampleArrays::VariantCodonPos;
+%ignore PacBio::Juliet::SampleArrays::VariantRefCodon;
+%ignore PacBio::Juliet::SampleArrays::VariantAltCodon;
+%ignore PacBio::Juliet::SampleArrays::VariantCoverage;
+%ignore PacBio::Juliet::SampleArrays::VariantFrequency;
+%ignore PacBio::Juliet::SampleArrays::VariantPValue;
+%immutable PacBio::Juliet::SampleArrays::MsaBeginPos;
+%immutable PacBio::Juliet::SampleArrays::VariantDRM;
+%immutable PacBio::Juliet::SampleArrays::GeneNames;
+%include <pacbio/juliet/SampleArrays.h>
+%extend PacBio::Juliet::SampleArrays {
+    // clang-format off
+    PyObject* _MsaCounts(PyObject* owner) const        { return View($self->MsaCounts, $self->NumMsaPositions(), PacBio::Juliet::SampleArrays::NumNucleotides, owner); }
+    PyObject* _CodonGene(PyObject* owner) const        { return View($self->CodonGene, $self->NumCodonPositions(), 0, owner); }
+    PyObject* _CodonPos(PyObject* owner) const         { return View($self->CodonPos, $self->NumCodonPositions(), 0, owner); }
+    PyObject* _CodonCoverage(PyObject* owner) const    { return View($self->CodonCoverage, $self->NumCodonPositions(), 0, owner); }
+    PyObject* _CodonCounts(PyObject* owner) const      { return View($self->CodonCounts, $self->NumCodonPositions(), PacBio::Juliet::SampleArrays::NumCodons, owner); }
+    PyObject* _VariantGene(PyObject* owner) const      { return View($self->VariantGene, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantCodonPos(PyObject* owner) const  { return View($self->VariantCodonPos, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantRefCodon(PyObject* owner) const  { return View($self->VariantRefCodon, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantAltCodon(PyObject* owner) const  { return View($self->VariantAltCodon, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantCoverage(PyObject* owner) const  { return View($self->VariantCoverage, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantFrequency(PyObject* owner) const { return View($self->VariantFrequency, $self->NumVariants(), 0, owner); }
+    PyObject* _VariantPValue(PyObject* owner) const    { return View($self->VariantPValue, $self->NumVariants(), 0, owner); }
+    // clang-format on
+
+    %pythoncode %{
+    @property
+    def msa_counts(self):
+        """(positions, 6) counts of A, C, G, T, -, N, from MsaBeginPos"""
+        return self._MsaCounts(self)
+
+    @property
+    def codon_gene(self):
+        """Index into GeneNames of each codon row"""
+        return self._CodonGene(self)
+
+    @property
+    def codon_pos(self):
+        """1-based reference position of each codon row"""
+        return self._CodonPos(self)
+
+    @property
+    def codon_coverage(self):
+        """Reads fully covering each codon row"""
+        return self._CodonCoverage(self)
+
+    @property
+    def codon_counts(self):
+        """(codons, 64) codon histogram, columns indexed by CodonIndex"""
+        return self._CodonCounts(self)
+
+    @property
+    def variants(self):
+        """Dict of variant columns, one entry per variant codon"""
+        return {
+            "gene": self._VariantGene(self),
+            "codon_pos": self._VariantCodonPos(self),
+            "ref_codon": self._VariantRefCodon(self),
+            "alt_codon": self._VariantAltCodon(self),
+            "coverage": self._VariantCoverage(self),
+            "frequency": self._VariantFrequency(self),
+            "p_value": self._VariantPValue(self),
+        }
+    %}
+}
+
+%ignore PacBio::Juliet::SampleReader::Call;
+%include <pacbio/juliet/SampleReader.h>
+%extend PacBio::Juliet::SampleReader {
+    %pythoncode %{
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        sample = self.Next()
+        if sample is None:
+            raise StopIteration
+        return sample
+
+    next = __next__
+    %}
+}
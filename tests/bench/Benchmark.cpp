@@ -0,0 +1,223 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <stdexcept>
+#include <thread>
+
+#include <pacbio/Version.h>
+#include <pacbio/io/JsonWriter.h>
+
+#include "Benchmark.h"
+
+namespace PacBio {
+namespace Bench {
+namespace {
+struct Run
+{
+    std::string Name;
+    int64_t Iterations;
+    double RealSeconds;
+    double CpuSeconds;
+    double ItemsPerSecond;
+};
+
+// Grows the iteration count until the timed duration reaches minTime,
+// as Google Benchmark does
+Run Measure(const Benchmark& benchmark, const double minTime)
+{
+    static const int64_t maxIterations = 1000000000;
+    int64_t iterations = 1;
+    while (true) {
+        State state(iterations);
+        benchmark.Function(state);
+        const double seconds = state.RealSeconds();
+        if (seconds >= minTime || iterations >= maxIterations) {
+            const double n = static_cast<double>(state.Iterations());
+            return {benchmark.Name, state.Iterations(), seconds / n, state.CpuSeconds() / n,
+                    seconds > 0 ? state.ItemsProcessed() * n / seconds : 0};
+        }
+        double multiplier = 10;
+        if (seconds / minTime > 0.1) multiplier = std::min(multiplier, minTime * 1.4 / seconds);
+        iterations = std::min(
+            maxIterations, std::max(iterations + 1, static_cast<int64_t>(iterations * multiplier)));
+    }
+}
+
+// Coarsest unit that keeps the per-iteration time above one
+std::pair<const char*, double> TimeUnit(const double seconds)
+{
+    if (seconds >= 1e-2) return {"ms", 1e3};
+    if (seconds >= 1e-5) return {"us", 1e6};
+    return {"ns", 1e9};
+}
+
+void WriteJson(const std::vector<Run>& runs, const std::string& executable, std::ostream& out)
+{
+    char date[64];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    IO::JsonWriter json(out);
+    json.BeginObject();
+    json.Key("context").BeginObject();
+    json.Member("date", date);
+    json.Member("executable", executable);
+    json.Member("num_cpus", std::thread::hardware_concurrency());
+#ifdef NDEBUG
+    json.Member("library_build_type", "release");
+#else
+    json.Member("library_build_type", "debug");
+#endif
+    json.Member("minorseq_version", MinorseqVersion());
+    json.EndObject();
+    json.Key("benchmarks").BeginArray();
+    for (const auto& run : runs) {
+        const auto unit = TimeUnit(run.RealSeconds);
+        json.BeginObject();
+        json.Member("name", run.Name);
+        json.Member("run_name", run.Name);
+        json.Member("run_type", "iteration");
+        json.Member("iterations", run.Iterations);
+        json.Member("real_time", run.RealSeconds * unit.second);
+        json.Member("cpu_time", run.CpuSeconds * unit.second);
+        json.Member("time_unit", unit.first);
+        if (run.ItemsPerSecond > 0) json.Member("items_per_second", run.ItemsPerSecond);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    json.Flush();
+    out << std::endl;
+}
+
+void PrintRun(const Run& run, std::ostream& out)
+{
+    const auto unit = TimeUnit(run.RealSeconds);
+    out << std::left << std::setw(56) << run.Name << std::right << std::fixed
+        << std::setprecision(3) << std::setw(12) << run.RealSeconds * unit.second << " "
+        << std::setw(2) << unit.first << std::setw(12) << run.CpuSeconds * unit.second << " "
+        << std::setw(2) << unit.first << std::setw(12) << run.Iterations;
+    if (run.ItemsPerSecond > 0)
+        out << std::setw(12) << std::setprecision(1) << run.ItemsPerSecond << " items/s";
+    out << std::endl;
+}
+
+bool StartsWith(const std::string& s, const std::string& prefix)
+{
+    return s.compare(0, prefix.size(), prefix) == 0;
+}
+}
+
+std::vector<Benchmark>& Benchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+void Register(const std::string& name, std::function<void(State&)> function)
+{
+    Benchmarks().push_back({name, std::move(function)});
+}
+
+int RunBenchmarks(int argc, char* argv[])
+{
+    std::string filter = ".";
+    double minTime = 0.5;
+    std::string format = "console";
+    std::string outFile;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = arg.substr(arg.find('=') + 1);
+        if (StartsWith(arg, "--benchmark_filter="))
+            filter = value;
+        else if (StartsWith(arg, "--benchmark_min_time="))
+            minTime = std::atof(value.c_str());
+        else if (StartsWith(arg, "--benchmark_format="))
+            format = value;
+        else if (StartsWith(arg, "--benchmark_out="))
+            outFile = value;
+        else if (arg == "--benchmark_list_tests")
+            list = true;
+        else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (format != "console" && format != "json") {
+        std::cerr << "Unknown format " << format << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::regex pattern(filter);
+    std::vector<const Benchmark*> selected;
+    for (const auto& b : Benchmarks())
+        if (std::regex_search(b.Name, pattern)) selected.push_back(&b);
+
+    if (list) {
+        for (const auto b : selected)
+            std::cout << b->Name << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const bool console = format == "console";
+    if (console)
+        std::cout << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(15)
+                  << "Time" << std::setw(15) << "CPU" << std::setw(12) << "Iterations" << std::endl;
+    std::vector<Run> runs;
+    for (const auto b : selected) {
+        runs.emplace_back(Measure(*b, minTime));
+        if (console) PrintRun(runs.back(), std::cout);
+    }
+
+    if (!console) WriteJson(runs, argv[0], std::cout);
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        if (!out) throw std::runtime_error("Could not open " + outFile);
+        WriteJson(runs, argv[0], out);
+    }
+    return EXIT_SUCCESS;
+}
+}
+}  // ::PacBio::Bench
@@ -0,0 +1,123 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Bench {
+
+/// Minimal stand-in for Google Benchmark's State. Work outside of the
+/// KeepRunning loop, or between PauseTiming and ResumeTiming, is not timed.
+class State
+{
+public:
+    explicit State(int64_t maxIterations) : maxIterations_(maxIterations) {}
+
+public:
+    bool KeepRunning()
+    {
+        if (iterations_ == 0) ResumeTiming();
+        if (iterations_ < maxIterations_) {
+            ++iterations_;
+            return true;
+        }
+        PauseTiming();
+        return false;
+    }
+    void PauseTiming()
+    {
+        if (!running_) return;
+        realSeconds_ +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - realBegin_).count();
+        cpuSeconds_ += static_cast<double>(std::clock() - cpuBegin_) / CLOCKS_PER_SEC;
+        running_ = false;
+    }
+    void ResumeTiming()
+    {
+        if (running_) return;
+        realBegin_ = std::chrono::steady_clock::now();
+        cpuBegin_ = std::clock();
+        running_ = true;
+    }
+    /// Items per iteration, reported as items_per_second
+    void SetItemsProcessed(int64_t items) { itemsProcessed_ = items; }
+
+    int64_t Iterations() const { return iterations_; }
+    int64_t ItemsProcessed() const { return itemsProcessed_; }
+    double RealSeconds() const { return realSeconds_; }
+    /// Process CPU time, including the thread pool
+    double CpuSeconds() const { return cpuSeconds_; }
+
+private:
+    const int64_t maxIterations_;
+    int64_t iterations_ = 0;
+    int64_t itemsProcessed_ = 0;
+    bool running_ = false;
+    double realSeconds_ = 0;
+    double cpuSeconds_ = 0;
+    std::chrono::steady_clock::time_point realBegin_;
+    std::clock_t cpuBegin_ = 0;
+};
+
+struct Benchmark
+{
+    std::string Name;
+    std::function<void(State&)> Function;
+};
+
+/// Every registered benchmark, in registration order
+std::vector<Benchmark>& Benchmarks();
+
+void Register(const std::string& name, std::function<void(State&)> function);
+
+/// Runs the registered benchmarks with the command line of Google Benchmark:
+///   --benchmark_filter=<regex>     only run matching names
+///   --benchmark_min_time=<seconds> minimal timed duration per benchmark
+///   --benchmark_format=<console|json>
+///   --benchmark_out=<file>         additionally write JSON to file
+///   --benchmark_list_tests         print names and exit
+/// JSON output is compatible with Google Benchmark's compare.py.
+int RunBenchmarks(int argc, char* argv[]);
+}
+}  // ::PacBio::Bench
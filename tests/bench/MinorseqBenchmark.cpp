@@ -0,0 +1,302 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <pbbam/BamRecord.h>
+
+#include <pacbio/cleric/Cleric.h>
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/data/MSAByColumn.h>
+#include <pacbio/data/MSAByRow.h>
+#include <pacbio/fuse/Fuse.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/AminoAcidCaller.h>
+#include <pacbio/juliet/ErrorEstimates.h>
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/TransitionTable.h>
+#include <pacbio/mixsim/MixsimSettings.h>
+#include <pacbio/mixsim/Simulator.h>
+#include <pacbio/statistics/Fisher.h>
+#include <pacbio/util/ThreadPool.h>
+
+#include "Benchmark.h"
+
+// Micro and macro benchmarks of the juliet, fuse, and cleric hot paths on
+// simulated amplicons. Usage: bench_minorseq [--num-threads=<n>]
+// [--benchmark_filter=<regex>] [--benchmark_format=json] ...
+namespace {
+using namespace PacBio;  // NOLINT
+using Bench::State;
+
+/// Simulated amplicon sequencing of a minor variant population. All reads
+/// span the full window, starting at reference position 0.
+struct Workload
+{
+    int NumReads;
+    int Window;
+    /// Minor variants per kb
+    int Density;
+    std::string Reference;
+    std::vector<BAM::BamRecord> Records;
+    std::vector<std::shared_ptr<Data::ArrayRead>> Reads;
+};
+
+std::string RandomSequence(const int length, std::mt19937* rng)
+{
+    static const char bases[] = "ACGT";
+    std::string sequence;
+    sequence.reserve(length);
+    // Top two bits of mt19937, portable unlike std::uniform_int_distribution
+    for (int i = 0; i < length; ++i)
+        sequence += bases[(*rng)() >> 30];
+    return sequence;
+}
+
+std::vector<BAM::BamRecord> SimulateRecords(const std::string& reference,
+                                            const Mixsim::MixsimSettings& settings)
+{
+    const Mixsim::Simulator simulator("bench", reference, settings);
+    std::vector<BAM::BamRecord> records(simulator.NumReads());
+    Util::ParallelFor(0, records.size(), [&](const size_t i) { records[i] = simulator.Read(i); });
+    return records;
+}
+
+// Minor haplotypes at 1% to 20% frequency, each with its own codon
+// substitutions, and CCS-like errors of 0.3% each for substitutions,
+// deletions, and insertions
+std::unique_ptr<Workload> Simulate(const int numReads, const int window, const int density)
+{
+    std::unique_ptr<Workload> w(new Workload{numReads, window, density, "", {}, {}});
+    std::mt19937 rng(42);
+    w->Reference = RandomSequence(window, &rng);
+
+    const int numVariants = std::max(1, window * density / 1000);
+    Mixsim::MixsimSettings settings;
+    settings.Coverage = numReads;
+    settings.MinorPercentages = {1, 3, 8, 20};
+    settings.VariantsPerHaplotype = (numVariants + 3) / 4;
+    // Per alternative base
+    settings.SubstitutionRate = 0.001;
+    settings.DeletionRate = 0.003;
+    settings.InsertionRate = 0.003;
+    settings.PartialPercentage = 0;
+    w->Records = SimulateRecords(w->Reference, settings);
+
+    w->Reads.reserve(numReads);
+    for (int i = 0; i < numReads; ++i)
+        w->Reads.emplace_back(std::make_shared<Data::BAMArrayRead>(w->Records[i], i));
+    return w;
+}
+
+// Benchmarks are registered grouped by workload, such that only a single
+// workload is held in memory at a time
+const Workload& GetWorkload(const int numReads, const int window, const int density)
+{
+    static std::unique_ptr<Workload> cached;
+    if (!cached || cached->NumReads != numReads || cached->Window != window ||
+        cached->Density != density) {
+        cached.reset();
+        cached = Simulate(numReads, window, density);
+    }
+    return *cached;
+}
+
+std::string Name(const std::string& benchmark, const int numReads, const int window)
+{
+    return benchmark + "/reads:" + std::to_string(numReads) + "/window:" + std::to_string(window);
+}
+
+// Results are written here, so that the compiler cannot drop the work
+volatile double sink;
+
+void RegisterMicroBenchmarks()
+{
+    Bench::Register("TransitionTable/Transition", [](State& state) {
+        std::mt19937 rng(42);
+        std::vector<std::pair<std::string, std::string>> codons;
+        for (int i = 0; i < 64; ++i) {
+            const std::string ref = RandomSequence(3, &rng);
+            std::string read = ref;
+            // Substitutions, a deletion, and matches
+            if (i % 4 == 1) read[i % 3] = RandomSequence(1, &rng)[0];
+            if (i % 4 == 2) read[i % 3] = '-';
+            codons.emplace_back(ref, read);
+        }
+        Juliet::TransitionTable transitions;
+        while (state.KeepRunning())
+            for (const auto& ref_read : codons)
+                sink = transitions.Transition(ref_read.first, ref_read.second);
+        state.SetItemsProcessed(codons.size());
+    });
+
+    for (const int coverage : {100, 1000, 10000}) {
+        Bench::Register("Fisher/fisher_exact_tiss/coverage:" + std::to_string(coverage),
+                        [coverage](State& state) {
+                            // Minor counts of 0% to 5%, against a 0.5% error rate
+                            const int expected = coverage / 200;
+                            while (state.KeepRunning())
+                                for (int i = 0; i < 64; ++i)
+                                    sink = Statistics::Fisher::fisher_exact_tiss(
+                                        i * coverage / 1280, coverage, expected, coverage);
+                            state.SetItemsProcessed(64);
+                        });
+    }
+}
+
+void RegisterMacroBenchmarks(const int numReads, const int window, const int density)
+{
+    const std::string name = Name("", numReads, window);
+    const std::string densityName = name + "/density:" + std::to_string(density);
+    const auto workload = [numReads, window, density]() -> const Workload& {
+        return GetWorkload(numReads, window, density);
+    };
+
+    // Variant density does not change decoding, MSA, fuse, or cleric;
+    // these run once per read count and window length
+    if (density == 1) {
+        Bench::Register("BAMArrayRead" + name, [workload](State& state) {
+            const auto& w = workload();
+            while (state.KeepRunning()) {
+                std::vector<std::shared_ptr<Data::ArrayRead>> reads;
+                reads.reserve(w.Records.size());
+                for (size_t i = 0; i < w.Records.size(); ++i)
+                    reads.emplace_back(std::make_shared<Data::BAMArrayRead>(w.Records[i], i));
+            }
+            state.SetItemsProcessed(w.NumReads);
+        });
+
+        Bench::Register("MSAByRow" + name, [workload](State& state) {
+            const auto& w = workload();
+            while (state.KeepRunning())
+                Data::MSAByRow msa(w.Reads);
+            state.SetItemsProcessed(w.NumReads);
+        });
+
+        Bench::Register("MSAByColumn" + name, [workload](State& state) {
+            const auto& w = workload();
+            const Data::MSAByRow rows(w.Reads);
+            while (state.KeepRunning())
+                Data::MSAByColumn columns(rows);
+            state.SetItemsProcessed(w.NumReads);
+        });
+
+        Bench::Register("Fuse" + name, [workload](State& state) {
+            const auto& w = workload();
+            const auto reads = IO::RecordsToArrayReads(w.Records);
+            while (state.KeepRunning())
+                sink = Fuse::Fuse(reads).ConsensusSequence().size();
+            state.SetItemsProcessed(w.NumReads);
+        });
+
+        Bench::Register("Cleric/Convert" + name, [workload](State& state) {
+            const auto& w = workload();
+            // A single simulated read diverges by roughly 1%, mostly indels
+            Mixsim::MixsimSettings settings;
+            settings.Coverage = 1;
+            settings.MinorPercentages.clear();
+            settings.SubstitutionRate = 0.0003;
+            settings.DeletionRate = 0.004;
+            settings.InsertionRate = 0.004;
+            settings.PartialPercentage = 0;
+            const auto mutated = SimulateRecords(w.Reference, settings);
+            const Cleric::Cleric cleric(w.Reference, "from", mutated.front().Sequence(), "to");
+            while (state.KeepRunning()) {
+                state.PauseTiming();
+                auto records = w.Records;
+                state.ResumeTiming();
+                for (auto& r : records)
+                    cleric.Convert(&r);
+            }
+            state.SetItemsProcessed(w.NumReads);
+        });
+    }
+
+    // The caller builds both MSAs, then counts codons and tests with
+    // CountNumberOfTests and CallVariants
+    Bench::Register("CallVariants" + densityName, [workload](State& state) {
+        const auto& w = workload();
+        const Juliet::ErrorEstimates error(0.005, 0.005);
+        const Juliet::JulietSettings settings;
+        while (state.KeepRunning())
+            Juliet::AminoAcidCaller caller(w.Reads, error, settings);
+        state.SetItemsProcessed(w.NumReads);
+    });
+
+    Bench::Register("PhaseVariants" + densityName, [workload](State& state) {
+        const auto& w = workload();
+        const Juliet::ErrorEstimates error(0.005, 0.005);
+        const Juliet::JulietSettings settings;
+        std::unique_ptr<Juliet::AminoAcidCaller> caller;
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            caller.reset();
+            caller.reset(new Juliet::AminoAcidCaller(w.Reads, error, settings));
+            state.ResumeTiming();
+            caller->PhaseVariants();
+        }
+        state.SetItemsProcessed(w.NumReads);
+    });
+}
+}
+
+int main(int argc, char* argv[])
+{
+    // Forward everything but the thread count to the benchmark runner
+    std::vector<char*> args{argv[0]};
+    for (int i = 1; i < argc; ++i) {
+        static const std::string threads = "--num-threads=";
+        if (threads.compare(0, threads.size(), argv[i], threads.size()) == 0)
+            Util::ThreadPool::Configure(std::atoi(argv[i] + threads.size()));
+        else
+            args.push_back(argv[i]);
+    }
+
+    RegisterMicroBenchmarks();
+    for (const int numReads : {100, 500, 2000})
+        for (const int window : {1000, 3000})
+            for (const int density : {1, 10})
+                RegisterMacroBenchmarks(numReads, window, density);
+
+    return Bench::RunBenchmarks(args.size(), args.data());
+}
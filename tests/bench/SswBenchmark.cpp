@@ -0,0 +1,131 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ssw.h>
+
+#include <pacbio/align/SimdAlignment.h>
+
+#include "Benchmark.h"
+
+// Throughput of the striped kernels for the alignments minorseq performs,
+// items are DP cells. Usage: bench_ssw [--benchmark_filter=<regex>]
+// [--benchmark_format=json] ...
+namespace {
+using namespace PacBio;  // NOLINT
+using Bench::State;
+
+struct BenchmarkCase
+{
+    std::string Name;
+    int QueryLength;
+    int TargetLength;
+};
+
+// Query is a slice of target with roughly 1% substitutions and indels
+void Simulate(const int queryLength, const int targetLength, std::mt19937* rng, std::string* query,
+              std::string* target)
+{
+    static const char bases[] = "ACGT";
+    std::uniform_int_distribution<int> base(0, 3);
+    std::uniform_int_distribution<int> error(0, 299);
+
+    target->clear();
+    for (int i = 0; i < targetLength; ++i)
+        *target += bases[base(*rng)];
+
+    query->clear();
+    for (int i = (targetLength - queryLength) / 2; static_cast<int>(query->size()) < queryLength;
+         i = (i + 1) % targetLength) {
+        switch (error(*rng)) {
+            case 0:
+                *query += bases[base(*rng)];
+                break;
+            case 1:
+                *query += bases[base(*rng)];
+                *query += target->at(i);
+                break;
+            case 2:
+                break;
+            default:
+                *query += target->at(i);
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<BenchmarkCase> cases{{"ccs_read_vs_seed_window", 1500, 1700},
+                                           {"amplicon_read_vs_seed_window", 3000, 3200},
+                                           {"reference_vs_reference", 9700, 9700}};
+    const std::vector<std::pair<ssw_simd, std::string>> kernels{
+        {SSW_SIMD_SSE2, "sse2"}, {SSW_SIMD_AVX2, "avx2"}, {SSW_SIMD_AVX512BW, "avx512bw"}};
+
+    std::mt19937 rng(42);
+    for (const auto& c : cases) {
+        auto query = std::make_shared<std::string>();
+        auto target = std::make_shared<std::string>();
+        Simulate(c.QueryLength, c.TargetLength, &rng, query.get(), target.get());
+
+        for (const auto& kernel : kernels) {
+            // Unsupported instruction sets fall back to a narrower kernel
+            if (ssw_set_simd(kernel.first) != kernel.second) continue;
+            const ssw_simd simd = kernel.first;
+            const int64_t cells = static_cast<int64_t>(c.QueryLength) * c.TargetLength;
+            Bench::Register("Aligner/" + c.Name + "/kernel:" + kernel.second,
+                            [simd, cells, query, target](State& state) {
+                                ssw_set_simd(simd);
+                                Align::Aligner aligner;
+                                Align::PariwiseAlignmentFasta result;
+                                aligner.Query(*query);
+                                while (state.KeepRunning())
+                                    aligner.Align(*target, &result);
+                                state.SetItemsProcessed(cells);
+                            });
+        }
+    }
+
+    const int ret = Bench::RunBenchmarks(argc, argv);
+    ssw_set_simd(SSW_SIMD_AUTO);
+    return ret;
+}
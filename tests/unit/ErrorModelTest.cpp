@@ -0,0 +1,189 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/data/ArrayRead.h>
+#include <pacbio/juliet/ErrorModel.h>
+
+#include "TempDir.h"
+#include "TestRead.h"
+
+using namespace PacBio::Juliet;  // NOLINT
+using PacBio::Data::ArrayRead;
+using tests::TempDir;
+using tests::TestRead;
+
+namespace {
+
+using Reads = std::vector<std::shared_ptr<ArrayRead>>;
+
+void AddReads(const int n, const std::string& cigar, const std::string& bases, Reads* reads,
+              const std::string& chemistry = "S/P2-C2")
+{
+    for (int i = 0; i < n; ++i)
+        reads->emplace_back(std::make_shared<TestRead>(reads->size(), 0, cigar, bases, chemistry));
+}
+
+// Reference AAACGT at 200x: insertions before the third A, substitutions of
+// the C, deletions of the G, 5% each
+Reads SmallMsa()
+{
+    Reads reads;
+    AddReads(160, "======", "AAACGT", &reads);
+    AddReads(10, "==I====", "AAGACGT", &reads);
+    AddReads(10, "==I====", "AATACGT", &reads);
+    AddReads(10, "===X==", "AAATGT", &reads);
+    AddReads(10, "====D=", "AAAC-T", &reads);
+    return reads;
+}
+
+TEST(ErrorModelTest, EstimatesHandBuiltMsa)
+{
+    const auto model = ErrorModel::Estimate(SmallMsa());
+    EXPECT_EQ("S/P2-C2", model.Chemistry);
+    EXPECT_EQ(200, model.NumReads);
+
+    ASSERT_EQ(6u, model.Positions.size());
+    const std::string consensus = "AAACGT";
+    for (size_t i = 0; i < model.Positions.size(); ++i) {
+        const auto& p = model.Positions[i];
+        EXPECT_EQ(static_cast<int>(i) + 1, p.RefPos);
+        EXPECT_EQ(consensus[i], p.Consensus);
+        EXPECT_EQ(200, p.Coverage);
+        EXPECT_DOUBLE_EQ(i == 3 ? 0.05 : 0, p.Substitution);
+        EXPECT_DOUBLE_EQ(i == 4 ? 0.05 : 0, p.Deletion);
+        EXPECT_DOUBLE_EQ(i == 2 ? 0.1 : 0, p.Insertion);
+    }
+
+    EXPECT_EQ(6, model.Global.Columns);
+    EXPECT_DOUBLE_EQ(0.05 / 6, model.Global.Substitution);
+    EXPECT_DOUBLE_EQ(0.05 / 6, model.Global.Deletion);
+    EXPECT_DOUBLE_EQ(0.1 / 6, model.Global.Insertion);
+
+    ASSERT_EQ(2u, model.Homopolymers.size());
+    EXPECT_EQ(3, model.Homopolymers.at(3).Columns);
+    EXPECT_DOUBLE_EQ(0.1 / 3, model.Homopolymers.at(3).Insertion);
+    EXPECT_DOUBLE_EQ(0, model.Homopolymers.at(3).Substitution);
+    EXPECT_EQ(3, model.Homopolymers.at(1).Columns);
+    EXPECT_DOUBLE_EQ(0.05 / 3, model.Homopolymers.at(1).Substitution);
+    EXPECT_DOUBLE_EQ(0.05 / 3, model.Homopolymers.at(1).Deletion);
+
+    // The first and the last base have no trinucleotide context
+    ASSERT_EQ(4u, model.Trinucleotides.size());
+    EXPECT_DOUBLE_EQ(0, model.Trinucleotides.at("AAA").Insertion);
+    EXPECT_DOUBLE_EQ(0.1, model.Trinucleotides.at("AAC").Insertion);
+    EXPECT_DOUBLE_EQ(0.05, model.Trinucleotides.at("ACG").Substitution);
+    EXPECT_DOUBLE_EQ(0.05, model.Trinucleotides.at("CGT").Deletion);
+}
+
+TEST(ErrorModelTest, GlobalSubstitutionKeepsPrintedFormula)
+{
+    // The G is deleted in 60% of the reads, the consensus is a gap
+    Reads reads;
+    AddReads(80, "===", "AGT", &reads);
+    AddReads(120, "=D=", "A-T", &reads);
+    const auto model = ErrorModel::Estimate(reads);
+
+    ASSERT_EQ(3u, model.Positions.size());
+    EXPECT_EQ('-', model.Positions[1].Consensus);
+    EXPECT_DOUBLE_EQ(0.4, model.Positions[1].Substitution);
+    EXPECT_DOUBLE_EQ(0.6, model.Positions[1].Deletion);
+
+    // 1 - f('-') - f(max) per column, averaged
+    EXPECT_DOUBLE_EQ(-0.2 / 3, model.Global.Substitution);
+    EXPECT_DOUBLE_EQ(0.6 / 3, model.Global.Deletion);
+}
+
+TEST(ErrorModelTest, AllowsMixedChemistries)
+{
+    Reads reads;
+    AddReads(150, "===", "ACG", &reads, "S/P2-C2");
+    AddReads(50, "===", "ACG", &reads, "S/P1-C1");
+    const auto model = ErrorModel::Estimate(reads);
+    EXPECT_EQ("S/P1-C1,S/P2-C2", model.Chemistry);
+    EXPECT_EQ(200, model.NumReads);
+}
+
+TEST(ErrorModelTest, LoadRoundTripsWriteJson)
+{
+    auto model = ErrorModel::Estimate(SmallMsa());
+    model.Input = "small.bam";
+
+    const TempDir dir("errormodel");
+    const std::string file = dir.Path + "/small.errormodel.json";
+    model.WriteJson(file);
+    const auto loaded = ErrorModel::Load(file);
+
+    const auto ExpectRates = [](const ErrorRates& expected, const ErrorRates& actual) {
+        EXPECT_EQ(expected.Columns, actual.Columns);
+        EXPECT_NEAR(expected.Substitution, actual.Substitution, 1e-12);
+        EXPECT_NEAR(expected.Deletion, actual.Deletion, 1e-12);
+        EXPECT_NEAR(expected.Insertion, actual.Insertion, 1e-12);
+    };
+
+    EXPECT_EQ(model.Chemistry, loaded.Chemistry);
+    EXPECT_EQ(model.Input, loaded.Input);
+    EXPECT_EQ(model.NumReads, loaded.NumReads);
+    ExpectRates(model.Global, loaded.Global);
+
+    ASSERT_EQ(model.Homopolymers.size(), loaded.Homopolymers.size());
+    for (const auto& h : model.Homopolymers)
+        ExpectRates(h.second, loaded.Homopolymers.at(h.first));
+    ASSERT_EQ(model.Trinucleotides.size(), loaded.Trinucleotides.size());
+    for (const auto& t : model.Trinucleotides)
+        ExpectRates(t.second, loaded.Trinucleotides.at(t.first));
+
+    ASSERT_EQ(model.Positions.size(), loaded.Positions.size());
+    for (size_t i = 0; i < model.Positions.size(); ++i) {
+        const auto& expected = model.Positions[i];
+        const auto& actual = loaded.Positions[i];
+        EXPECT_EQ(expected.RefPos, actual.RefPos);
+        EXPECT_EQ(expected.Consensus, actual.Consensus);
+        EXPECT_EQ(expected.Coverage, actual.Coverage);
+        EXPECT_NEAR(expected.Substitution, actual.Substitution, 1e-12);
+        EXPECT_NEAR(expected.Deletion, actual.Deletion, 1e-12);
+        EXPECT_NEAR(expected.Insertion, actual.Insertion, 1e-12);
+    }
+}
+
+}  // namespace
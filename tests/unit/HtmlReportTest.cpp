@@ -0,0 +1,303 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/juliet/HtmlReport.h>
+
+using namespace PacBio::Juliet;  // NOLINT
+
+namespace {
+
+/// One protease position with a DRM name that needs escaping
+struct SmallReport
+{
+    SmallReport()
+    {
+        VariantGene gene;
+        gene.geneName = "PR";
+        gene.geneOffset = 2253;
+        auto position = std::make_shared<VariantGene::VariantPosition>();
+        position->refCodon = "CCT";
+        position->altRefCodon = "CCT";
+        position->refAminoAcid = 'P';
+        position->altRefAminoAcid = 'P';
+        position->coverage = 1000;
+        VariantGene::VariantPosition::MsaColumn column;
+        column.relPos = 0;
+        column.absPos = 2277;
+        column.counts = {{5, 990, 0, 5, 0, 0}};
+        column.wt = 'C';
+        position->msa.push_back(column);
+        position->aminoAcidToCodons['L'].push_back(
+            {"CTT", 0.012, 1e-5, "ATV</script>&<b>", {true, false}});
+        gene.relPositionToVariant[9] = position;
+        genes.push_back(gene);
+
+        Haplotype a;
+        a.Name = "A";
+        a.GlobalFrequency = 0.9;
+        a.Names = {"r1", "r2"};
+        Haplotype b;
+        b.Name = "B";
+        b.GlobalFrequency = 0.1;
+        b.Names = {"r3"};
+        haplotypes = {a, b};
+
+        config.referenceName = "HIV";
+        config.targetGenes.emplace_back(2253, 2550, "PR", std::vector<DRM>{});
+    }
+
+    std::string Render(const int pageSize) const
+    {
+        return HtmlReport(genes, haplotypes, counts, config)
+            .Render("in.bam", "juliet in.bam", pageSize);
+    }
+
+    std::vector<VariantGene> genes;
+    std::vector<Haplotype> haplotypes;
+    HtmlReport::ReadCounts counts;
+    TargetConfig config;
+};
+
+/// Text from the first occurrence of begin up to and including end
+std::string Fragment(const std::string& html, const std::string& begin, const std::string& end)
+{
+    const size_t first = html.find(begin);
+    if (first == std::string::npos) return "";
+    const size_t last = html.find(end, first);
+    if (last == std::string::npos) return "";
+    return html.substr(first, last + end.size() - first);
+}
+
+TEST(HtmlReportTest, StaticTablesMatchGolden)
+{
+    const std::string html = SmallReport().Render(0);
+
+    const std::string row =
+        "<tr class=\"var\">\n"
+        "<td>C C T</td>\n"
+        "<td>P</td>\n"
+        "<td>9</td><td>L</td><td>C <b style=\"color:#E90032; font-weight:normal\">T </b>T "
+        "<td>1.2</td><td>1000</td><td>ATV&lt;/script&gt;&amp;&lt;b&gt;</td>"
+        "<td style=\"background-color:#ea3c1c\"></td><td></td></tr>\n";
+    EXPECT_EQ(row, Fragment(html, "<tr class=\"var\">", "</tr>\n"));
+
+    const std::string msa =
+        "<tr><td>0</td>\n"
+        "<td style=\"\">5</td>\n"
+        "<td style=\"color:#B50A36;font-weight:bold;\">990</td>\n"
+        "<td style=\"\">0</td>\n"
+        "<td style=\"\">5</td>\n"
+        "<td style=\"\">0</td>\n"
+        "<td style=\"\">0</td>\n"
+        "</tr>\n"
+        "</table></tr>\n";
+    EXPECT_EQ(msa, Fragment(html, "<tr><td>0</td>", "</table></tr>\n"));
+
+    const std::string drms =
+        "<table class=\"drmview\">\n"
+        "<tr><th colspan=2></th><th colspan=2 style=\"border-right: 1px dashed "
+        "black\">Reference</th><th colspan=2>Sample</th></tr>"
+        "<tr><th>Drug</th><th>Gene</th><th>AA</th><th style=\"border-right: 1px dashed "
+        "black\">Pos</th><th>AA</th><th>%</th></tr>"
+        "<tr><td rowspan=\"1\" class=\"gene\" "
+        "style=\"width:160px\">ATV&lt;/script&gt;&amp;&lt;b&gt;</td>\n"
+        "<td rowspan=\"1\" class=\"drugFirst\" style=\"width:16px\">PR</td>\n"
+        "<td class=\"refaaFirstDrug\">P</td><td class=\"refposFirstDrug\">9</td>"
+        "<td class=\"curaaFirstDrug\">L</td><td class=\"freqFirstDrug\">1.2</td></tr></table>\n";
+    EXPECT_EQ(drms, Fragment(html, "<table class=\"drmview\">", "</table>\n"));
+}
+
+TEST(HtmlReportTest, PagedBlobMatchesGolden)
+{
+    const std::string html = SmallReport().Render(2);
+
+    // "</" of the DRM name is written as "<\/" and cannot close the element
+    const std::string blob =
+        "<script type=\"application/json\" id=\"juliet-data\">"
+        "{\"page_size\":2,\"num_haplotypes\":2,\"genes\":[[[9,\"CCT\",\"P\",1000,"
+        "[0,5,990,0,5,0,0,1],[[\"L\",\"CTT\",1.2,\"ATV<\\/script>&<b>\",[0]]]]]]}</script>\n";
+    EXPECT_EQ(blob, Fragment(html, "<script type=\"application/json\"", "</script>\n"));
+}
+
+TEST(HtmlReportTest, PagedScriptEscapesKnownDrms)
+{
+    const std::string html = SmallReport().Render(2);
+
+    // The DRM name reaches the page only through esc()
+    EXPECT_THAT(
+        html, ::testing::HasSubstr("replace(/&/g, \"&amp;\").replace(/</g, \"&lt;\").replace(/>/g, "
+                                   "\"&gt;\").replace(/\"/g, \"&quot;\")"));
+    EXPECT_THAT(html, ::testing::HasSubstr("\"</td><td>\" + esc(v[3]) + \"</td>\""));
+    // Unescaped, it only appears in the data blob
+    const size_t blob = html.find("ATV<");
+    EXPECT_EQ("ATV<\\/script>&<b>\"", html.substr(blob, 18));
+    EXPECT_EQ(std::string::npos, html.find("ATV<", blob + 1));
+}
+
+/// Genes with every third position variant, each with a few codons that
+/// hit every other haplotype
+struct LargeReport
+{
+    LargeReport(const int numGenes, const int numPositions, const int numHaplotypes)
+    {
+        for (int g = 0; g < numGenes; ++g) {
+            VariantGene gene;
+            gene.geneName = "G" + std::to_string(g);
+            gene.geneOffset = 1000 * g;
+            for (int p = 0; p < numPositions; ++p) {
+                auto position = std::make_shared<VariantGene::VariantPosition>();
+                position->refCodon = "ACG";
+                position->altRefCodon = "ACG";
+                position->refAminoAcid = 'T';
+                position->altRefAminoAcid = 'T';
+                position->coverage = 5000;
+                for (int r = -3; r < 6; ++r) {
+                    VariantGene::VariantPosition::MsaColumn column;
+                    column.relPos = r;
+                    column.absPos = gene.geneOffset + 3 * p + r;
+                    column.counts = {{4000, 500, 400, 90, 9, 1}};
+                    column.wt = 'A';
+                    position->msa.push_back(column);
+                }
+                if (p % 3 == 0) {
+                    std::vector<bool> hits(numHaplotypes);
+                    for (int h = 0; h < numHaplotypes; h += 2)
+                        hits[h] = true;
+                    for (const char* codon : {"ACA", "ACC", "ACT"})
+                        position->aminoAcidToCodons['T'].push_back(
+                            {codon, 0.05, 1e-10, "NRTI", hits});
+                    position->aminoAcidToCodons['A'].push_back({"GCG", 0.01, 1e-5, "", hits});
+                }
+                gene.relPositionToVariant[p] = position;
+            }
+            genes.push_back(gene);
+        }
+        for (int h = 0; h < numHaplotypes; ++h) {
+            Haplotype haplotype;
+            haplotype.Name = std::to_string(h);
+            haplotype.GlobalFrequency = 1.0 / numHaplotypes;
+            haplotypes.push_back(haplotype);
+        }
+    }
+
+    std::string Render(const int pageSize) const
+    {
+        return HtmlReport(genes, haplotypes, counts, config).Render("in.bam", "", pageSize);
+    }
+
+    std::vector<VariantGene> genes;
+    std::vector<Haplotype> haplotypes;
+    HtmlReport::ReadCounts counts;
+    TargetConfig config;
+};
+
+/// Number of non-overlapping occurrences of s
+size_t Count(const std::string& html, const std::string& s)
+{
+    size_t n = 0;
+    for (size_t pos = html.find(s); pos != std::string::npos; pos = html.find(s, pos + s.size()))
+        ++n;
+    return n;
+}
+
+TEST(HtmlReportTest, PagedReportHoldsEveryVariantPositionOnce)
+{
+    const std::string html = LargeReport(3, 100, 4).Render(25);
+
+    EXPECT_EQ(3u, Count(html, "<table class=\"discovery\""));
+    EXPECT_EQ(3u, Count(html, "<div class=\"pager\""));
+    // Rows are rendered by the page, none are written statically
+    EXPECT_EQ(0u, Count(html, "<tr class=\"var\">"));
+    EXPECT_EQ(0u, Count(html, "<tr class=\"msa\">"));
+
+    const std::string begin = "<script type=\"application/json\" id=\"juliet-data\">";
+    const size_t first = html.find(begin) + begin.size();
+    const auto data =
+        PacBio::JSON::Json::parse(html.substr(first, html.find("</script>", first) - first));
+    EXPECT_EQ(25, data["page_size"].get<int>());
+    EXPECT_EQ(4, data["num_haplotypes"].get<int>());
+    ASSERT_EQ(3u, data["genes"].size());
+    for (const auto& gene : data["genes"]) {
+        // Positions 0, 3, ..., 99 are variant, each with four codons
+        ASSERT_EQ(34u, gene.size());
+        for (size_t i = 0; i < gene.size(); ++i) {
+            EXPECT_EQ(3 * static_cast<int>(i), gene[i][0].get<int>());
+            EXPECT_EQ(9u * 8, gene[i][4].size());
+            EXPECT_EQ(4u, gene[i][5].size());
+        }
+    }
+}
+
+TEST(HtmlReportTest, PageSizeZeroWritesStaticTables)
+{
+    const std::string html = LargeReport(2, 30, 4).Render(0);
+
+    EXPECT_EQ(std::string::npos, html.find("juliet-data"));
+    EXPECT_EQ(0u, Count(html, "<div class=\"pager\""));
+    // Four codons at ten variant positions per gene
+    EXPECT_EQ(2u * 10 * 4, Count(html, "<tr class=\"var\""));
+    EXPECT_EQ(2u * 10 * 4, Count(html, "<tr class=\"msa\">"));
+}
+
+TEST(HtmlReportTest, NegativePageSizeThrows)
+{
+    EXPECT_THROW(LargeReport(1, 3, 1).Render(-1), std::runtime_error);
+}
+
+TEST(HtmlReportTest, PagedReportSizeIsLinearAndCompact)
+{
+    const size_t small = LargeReport(4, 750, 100).Render(100).size();
+    const size_t large = LargeReport(8, 750, 100).Render(100).size();
+    const size_t full = LargeReport(8, 750, 100).Render(0).size();
+
+    // 8000 codons, the static report carries 9 MSA rows and 100
+    // haplotype cells for each
+    EXPECT_LT(large, 2.05 * small);
+    EXPECT_LT(10 * large, full);
+    EXPECT_LT(large, 8000u * 512);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pbcopper/json/JSON.h>
+
+#include <pacbio/io/JsonWriter.h>
+
+using namespace PacBio;  // NOLINT
+
+namespace {
+
+const std::vector<double> doubles{0.0,
+                                  -0.0,
+                                  1.0,
+                                  0.1,
+                                  1.0 / 3.0,
+                                  -2.5e-5,
+                                  0.0001,
+                                  0.00001,
+                                  123456789012345.0,
+                                  1e15,
+                                  12345678901234568.0,
+                                  1e16,
+                                  1.7976931348623157e308,
+                                  4.9e-324,
+                                  std::numeric_limits<double>::quiet_NaN(),
+                                  std::numeric_limits<double>::infinity()};
+
+const std::vector<std::string> strings{
+    "",         "plain", "quote \" backslash \\ slash /", "\b\f\n\r\t", std::string("\x01\x1f", 2),
+    "</script>"};
+
+std::string Stream(const int indent)
+{
+    std::ostringstream out;
+    {
+        IO::JsonWriter json(out, indent);
+        json.BeginObject();
+        json.Member("bool", true);
+        json.Key("doubles").BeginArray();
+        for (const auto d : doubles)
+            json.Value(d);
+        json.EndArray();
+        json.Key("empty_array").BeginArray().EndArray();
+        json.Key("empty_object").BeginObject().EndObject();
+        json.Member("int", -42);
+        json.Member("strings", strings);
+        json.Member("unsigned", static_cast<size_t>(1) << 40);
+        json.EndObject();
+    }
+    return out.str();
+}
+
+JSON::Json Dom()
+{
+    JSON::Json root;
+    root["bool"] = true;
+    root["doubles"] = doubles;
+    root["empty_array"] = JSON::Json::array();
+    root["empty_object"] = JSON::Json::object();
+    root["int"] = -42;
+    root["strings"] = strings;
+    root["unsigned"] = static_cast<size_t>(1) << 40;
+    return root;
+}
+
+TEST(JsonWriterTest, EqualsDomDump)
+{
+    EXPECT_EQ(Dom().dump(2), Stream(2));
+    EXPECT_EQ(Dom().dump(4), Stream(4));
+}
+
+TEST(JsonWriterTest, NegativeIndentEqualsCompactDump) { EXPECT_EQ(Dom().dump(), Stream(-1)); }
+
+TEST(JsonWriterTest, UnbalancedScopesThrow)
+{
+    std::ostringstream out;
+    IO::JsonWriter json(out);
+    json.BeginObject();
+    EXPECT_THROW(json.Value(1), std::logic_error);
+    EXPECT_THROW(json.EndArray(), std::logic_error);
+    json.Key("a");
+    EXPECT_THROW(json.Key("b"), std::logic_error);
+}
+
+}  // namespace
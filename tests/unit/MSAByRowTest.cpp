@@ -0,0 +1,148 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cctype>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/data/MSAByColumn.h>
+#include <pacbio/data/MSAByRow.h>
+
+#include "TestRead.h"
+
+using namespace PacBio::Data;  // NOLINT
+using tests::TestRead;
+
+namespace {
+
+struct ReadSpec
+{
+    int Start;
+    std::string Cigar;
+    std::string Bases;
+};
+
+// Reference ACGTAC. Lowercase bases are QV-masked, the reads of 3 and 4
+// only differ at their masked base. Mismatches that match the reference
+// still collapse with matches.
+const std::vector<ReadSpec> specs{
+    {0, "======", "ACGTAC"},   {0, "======", "ACGTAC"}, {0, "==I====", "ACTGTAC"},
+    {0, "==X===", "ACaTAC"},   {0, "==X===", "ACcTAC"}, {1, "=D==", "C-TA"},
+    {0, "==I====", "ACTGTAC"}, {0, "======", "ACGTAC"}, {0, "==X===", "ACGTAC"}};
+
+std::vector<std::shared_ptr<ArrayRead>> Reads()
+{
+    std::vector<std::shared_ptr<ArrayRead>> reads;
+    for (const auto& s : specs)
+        reads.emplace_back(std::make_shared<TestRead>(reads.size(), s.Start, s.Cigar, s.Bases));
+    return reads;
+}
+
+TEST(MSAByRowTest, CollapsesDuplicatedReads)
+{
+    const auto reads = Reads();
+    const MSAByRow msa(reads);
+
+    EXPECT_EQ(1, msa.BeginPos);
+    EXPECT_EQ(7, msa.EndPos);
+    EXPECT_EQ(specs.size(), msa.NumReads());
+
+    // Rows in order of their first read
+    ASSERT_EQ(4u, msa.Rows.size());
+    const std::vector<size_t> firstReads{0, 2, 3, 5};
+    const std::vector<int> weights{4, 2, 2, 1};
+    const std::vector<std::string> bases{"ACGTAC", "ACGTAC", "ACNTAC", " C-TA "};
+    for (size_t u = 0; u < msa.Rows.size(); ++u) {
+        EXPECT_EQ(reads[firstReads[u]], msa.Rows[u]->Read);
+        EXPECT_EQ(weights[u], msa.Rows[u]->Weight);
+        EXPECT_EQ(bases[u], std::string(msa.Rows[u]->Bases.cbegin(), msa.Rows[u]->Bases.cend()));
+    }
+    EXPECT_EQ((std::map<int, std::string>{{2, "T"}}), msa.Rows[1]->Insertions);
+    EXPECT_TRUE(msa.Rows[0]->Insertions.empty());
+
+    const std::vector<size_t> rowOfRead{0, 0, 1, 2, 2, 3, 1, 0, 0};
+    EXPECT_EQ(rowOfRead, msa.RowOfRead);
+    ASSERT_EQ(specs.size(), msa.ReadNames.size());
+    EXPECT_EQ(specs.size(), msa.NameToRow.size());
+    for (size_t i = 0; i < specs.size(); ++i) {
+        EXPECT_EQ(reads[i]->Name, msa.ReadNames[i]);
+        ASSERT_EQ(1u, msa.NameToRow.count(reads[i]->Name));
+        EXPECT_EQ(msa.Rows[rowOfRead[i]], msa.NameToRow.at(reads[i]->Name));
+    }
+}
+
+TEST(MSAByRowTest, ColumnsCountEveryRead)
+{
+    const MSAByRow rows(Reads());
+    const MSAByColumn columns(rows);
+
+    // Counted read by read, without collapsing
+    std::vector<std::map<char, int>> bases(6);
+    std::vector<std::map<std::string, int>> insertions(6);
+    for (const auto& s : specs) {
+        int pos = s.Start;
+        std::string insertion;
+        for (size_t i = 0; i < s.Cigar.size(); ++i) {
+            if (s.Cigar[i] == 'I') {
+                insertion += s.Bases[i];
+                continue;
+            }
+            if (!insertion.empty()) ++insertions[pos][insertion];
+            insertion.clear();
+            const char b = s.Cigar[i] == 'D' ? '-' : std::islower(s.Bases[i]) ? 'N' : s.Bases[i];
+            ++bases[pos++][b];
+        }
+    }
+
+    ASSERT_EQ(6u, columns.counts.size());
+    for (size_t pos = 0; pos < columns.counts.size(); ++pos) {
+        const auto& column = columns.counts[pos];
+        EXPECT_EQ(static_cast<int>(pos) + 1, column.refPos);
+        for (const char b : std::string("ACGT-N")) {
+            const int expected = bases[pos].count(b) ? bases[pos].at(b) : 0;
+            EXPECT_EQ(expected, column[b]) << "position " << pos << " base " << b;
+        }
+        EXPECT_EQ(insertions[pos], column.insertions) << "position " << pos;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,166 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pbbam/FastaSequence.h>
+
+#include <pacbio/align/ReadAligner.h>
+#include <pacbio/align/SimdAlignment.h>
+
+using namespace PacBio;         // NOLINT
+using namespace PacBio::Align;  // NOLINT
+
+namespace {
+
+const char bases[] = "ACGT";
+
+std::string RandomSequence(std::mt19937* rng, size_t length)
+{
+    std::string seq;
+    for (size_t i = 0; i < length; ++i)
+        seq += bases[(*rng)() % 4];
+    return seq;
+}
+
+char OtherBase(std::mt19937* rng, const char a, const char b)
+{
+    char c;
+    do {
+        c = bases[(*rng)() % 4];
+    } while (c == a || c == b);
+    return c;
+}
+
+std::string ReverseComplement(std::string seq)
+{
+    std::reverse(seq.begin(), seq.end());
+    for (auto& c : seq)
+        c = c == 'A' ? 'T' : c == 'C' ? 'G' : c == 'G' ? 'C' : 'A';
+    return seq;
+}
+
+/// 500 bp read of reference at start, with a substitution at +100, a
+/// deletion at +200, and an insertion before +300. Positions are chosen
+/// such that the left-aligned gaps cannot move.
+struct SimulatedRead
+{
+    SimulatedRead(std::mt19937* rng, const std::string& reference, const int start)
+    {
+        int del = start + 200;
+        while (reference[del - 1] == reference[del])
+            ++del;
+        const int ins = start + 300;
+        for (int i = start; i < start + 500; ++i) {
+            if (i == start + 100)
+                Bases += OtherBase(rng, reference[i], reference[i]);
+            else if (i == ins)
+                Bases +=
+                    std::string(1, OtherBase(rng, reference[i - 1], reference[i])) + reference[i];
+            else if (i != del)
+                Bases += reference[i];
+        }
+        const int d = del - start;
+        Cigar = "100=1X" + std::to_string(d - 101) + "=1D" + std::to_string(299 - d) + "=1I200=";
+    }
+
+    std::string Bases;
+    std::string Cigar;
+};
+
+TEST(ReadAlignerTest, MapsSimulatedReads)
+{
+    std::mt19937 rng(11);
+    const std::vector<BAM::FastaSequence> references{
+        BAM::FastaSequence("first", RandomSequence(&rng, 3000)),
+        BAM::FastaSequence("second", RandomSequence(&rng, 2000))};
+    const ReadAligner readAligner(references);
+    Aligner aligner;
+
+    for (int i = 0; i < 20; ++i) {
+        const int32_t referenceId = i % 2;
+        const auto& reference = references[referenceId].Bases();
+        const int32_t start = rng() % (reference.size() - 600);
+        const bool reverse = i % 4 >= 2;
+        const SimulatedRead read(&rng, reference, start);
+
+        ReadAlignment result;
+        ASSERT_TRUE(readAligner.Map(reverse ? ReverseComplement(read.Bases) : read.Bases, &aligner,
+                                    &result));
+        EXPECT_EQ(referenceId, result.ReferenceId);
+        EXPECT_EQ(start, result.ReferenceStart);
+        EXPECT_EQ(reverse, result.Reverse);
+        EXPECT_EQ(read.Cigar, result.Cigar.ToStdString());
+    }
+}
+
+TEST(ReadAlignerTest, LeftAlignsGapsInRepeats)
+{
+    std::mt19937 rng(5);
+    const auto left = RandomSequence(&rng, 399) + "T";
+    const auto right = RandomSequence(&rng, 400);
+    const std::vector<BAM::FastaSequence> references{
+        BAM::FastaSequence("repeat", left + "ACACACAC" + right)};
+    const ReadAligner readAligner(references);
+    Aligner aligner;
+
+    // One AC unit deleted, must be placed at the start of the repeat
+    ReadAlignment result;
+    ASSERT_TRUE(readAligner.Map(left + "ACACAC" + right, &aligner, &result));
+    EXPECT_EQ(0, result.ReferenceStart);
+    EXPECT_EQ("400=2D406=", result.Cigar.ToStdString());
+}
+
+TEST(ReadAlignerTest, UnrelatedReadIsNotMapped)
+{
+    std::mt19937 rng(3);
+    const std::vector<BAM::FastaSequence> references{
+        BAM::FastaSequence("reference", RandomSequence(&rng, 2000))};
+    const ReadAligner readAligner(references);
+    Aligner aligner;
+
+    ReadAlignment result;
+    EXPECT_FALSE(readAligner.Map(RandomSequence(&rng, 500), &aligner, &result));
+}
+
+}  // namespace
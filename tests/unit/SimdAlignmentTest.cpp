@@ -0,0 +1,136 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/align/SimdAlignment.h>
+#include <pacbio/util/ThreadPool.h>
+
+using namespace PacBio::Align;  // NOLINT
+
+namespace {
+
+std::string RandomSequence(std::mt19937* rng, size_t length)
+{
+    static const char bases[] = "ACGT";
+    std::string seq;
+    for (size_t i = 0; i < length; ++i)
+        seq += bases[(*rng)() % 4];
+    return seq;
+}
+
+/// Copy of target with random substitutions, insertions, and deletions
+std::string Mutate(std::mt19937* rng, const std::string& target)
+{
+    static const char bases[] = "ACGT";
+    std::string query;
+    for (const char c : target) {
+        switch ((*rng)() % 40) {
+            case 0:
+                query += bases[(*rng)() % 4];
+                break;
+            case 1:
+                break;
+            case 2:
+                query += bases[(*rng)() % 4];
+                query += c;
+                break;
+            default:
+                query += c;
+        }
+    }
+    return query;
+}
+
+void ExpectEqual(const PariwiseAlignmentFasta& expected, const PariwiseAlignmentFasta& actual)
+{
+    EXPECT_EQ(expected.Target, actual.Target);
+    EXPECT_EQ(expected.Query, actual.Query);
+    EXPECT_EQ(expected.Transcript, actual.Transcript);
+}
+
+TEST(SimdAlignmentTest, BatchEqualsSingleAlignments)
+{
+    std::mt19937 rng(42);
+    const auto target = RandomSequence(&rng, 300);
+    std::vector<std::string> queries;
+    for (int i = 0; i < 50; ++i)
+        queries.emplace_back(Mutate(&rng, target));
+    // Repeated queries must not reuse a stale profile
+    queries.emplace_back(queries.front());
+    queries.emplace_back(RandomSequence(&rng, 120));
+
+    PacBio::Util::ThreadPool::Configure(4);
+    std::vector<PariwiseAlignmentFasta> batch;
+    SimdNeedleWunschAlignment(target, queries, &batch);
+
+    ASSERT_EQ(queries.size(), batch.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+        ExpectEqual(SimdNeedleWunschAlignment(target, queries[i]), batch[i]);
+}
+
+TEST(SimdAlignmentTest, ReusedAlignerEqualsSingleAlignments)
+{
+    std::mt19937 rng(7);
+    Aligner aligner;
+    PariwiseAlignmentFasta result;
+    for (int i = 0; i < 20; ++i) {
+        const auto target = RandomSequence(&rng, 100 + rng() % 200);
+        const auto query = Mutate(&rng, target);
+        aligner.Align(target, query, &result);
+        ExpectEqual(SimdNeedleWunschAlignment(target, query), result);
+
+        // Same query, other target, profile is kept
+        const auto otherTarget = Mutate(&rng, target);
+        aligner.Align(otherTarget, &result);
+        ExpectEqual(SimdNeedleWunschAlignment(otherTarget, query), result);
+    }
+}
+
+TEST(SimdAlignmentTest, EmptyBatch)
+{
+    std::vector<PariwiseAlignmentFasta> batch(3);
+    SimdNeedleWunschAlignment("ACGT", {}, &batch);
+    EXPECT_TRUE(batch.empty());
+}
+
+}  // namespace
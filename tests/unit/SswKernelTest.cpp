@@ -0,0 +1,146 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <ssw.h>
+
+namespace {
+
+/// Fields of one ssw_align result that every kernel must reproduce
+struct KernelResult
+{
+    uint16_t Score;
+    int32_t RefBegin;
+    int32_t RefEnd;
+    int32_t ReadBegin;
+    int32_t ReadEnd;
+    std::vector<uint32_t> Cigar;
+};
+
+std::vector<int8_t> RandomSequence(std::mt19937* rng, size_t length)
+{
+    std::vector<int8_t> seq(length);
+    for (auto& b : seq)
+        b = (*rng)() % 4;
+    return seq;
+}
+
+/// Copy of target with substitutions, insertions, and deletions at rate 1/errorRate each
+std::vector<int8_t> Mutate(std::mt19937* rng, const std::vector<int8_t>& target, int errorRate)
+{
+    std::vector<int8_t> query;
+    for (const auto b : target) {
+        const int r = (*rng)() % errorRate;
+        if (r == 0)
+            query.push_back((*rng)() % 4);
+        else if (r == 1)
+            continue;
+        else if (r == 2) {
+            query.push_back((*rng)() % 4);
+            query.push_back(b);
+        } else
+            query.push_back(b);
+    }
+    return query;
+}
+
+KernelResult Align(const std::vector<int8_t>& query, const std::vector<int8_t>& target)
+{
+    static const int8_t matrix[] = {2, -2, -2, -2, -2, 2, -2, -2, -2, -2, 2, -2, -2, -2, -2, 2};
+    s_profile* profile = ssw_init(query.data(), query.size(), matrix, 4, 2);
+    s_align* alignment = ssw_align(profile, target.data(), target.size(), 3, 1, 0x0f, 0, 32767,
+                                   std::max<int32_t>(15, query.size()));
+    KernelResult result{
+        alignment->score1,
+        alignment->ref_begin1,
+        alignment->ref_end1,
+        alignment->read_begin1,
+        alignment->read_end1,
+        std::vector<uint32_t>(alignment->cigar, alignment->cigar + alignment->cigarLen)};
+    align_destroy(alignment);
+    init_destroy(profile);
+    return result;
+}
+
+TEST(SswKernelTest, WideKernelsEqualSse2)
+{
+    // Short pairs stay in the 8-bit kernels, long ones overflow into 16 bit
+    std::mt19937 rng(42);
+    std::vector<std::pair<std::vector<int8_t>, std::vector<int8_t>>> pairs;
+    for (int i = 0; i < 200; ++i) {
+        const auto target = RandomSequence(&rng, 1 + rng() % (i < 150 ? 200 : 3000));
+        if (i % 10 == 0)
+            pairs.emplace_back(RandomSequence(&rng, 1 + rng() % 100), target);
+        else
+            pairs.emplace_back(Mutate(&rng, target, 5 + i % 50), target);
+        if (pairs.back().first.empty()) pairs.back().first.push_back(0);
+    }
+
+    ASSERT_EQ(std::string("sse2"), ssw_set_simd(SSW_SIMD_SSE2));
+    std::vector<KernelResult> expected;
+    for (const auto& pair : pairs)
+        expected.emplace_back(Align(pair.first, pair.second));
+
+    const std::vector<std::pair<ssw_simd, std::string>> kernels{{SSW_SIMD_AVX2, "avx2"},
+                                                                {SSW_SIMD_AVX512BW, "avx512bw"}};
+    for (const auto& kernel : kernels) {
+        // Instruction sets the cpu lacks fall back to a narrower kernel
+        if (ssw_set_simd(kernel.first) != kernel.second) continue;
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            SCOPED_TRACE(kernel.second + " pair " + std::to_string(i));
+            const auto actual = Align(pairs[i].first, pairs[i].second);
+            EXPECT_EQ(expected[i].Score, actual.Score);
+            EXPECT_EQ(expected[i].RefBegin, actual.RefBegin);
+            EXPECT_EQ(expected[i].RefEnd, actual.RefEnd);
+            EXPECT_EQ(expected[i].ReadBegin, actual.ReadBegin);
+            EXPECT_EQ(expected[i].ReadEnd, actual.ReadEnd);
+            EXPECT_EQ(expected[i].Cigar, actual.Cigar);
+        }
+    }
+    ssw_set_simd(SSW_SIMD_AUTO);
+}
+
+}  // namespace
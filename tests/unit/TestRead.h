@@ -0,0 +1,71 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#pragma once
+
+#include <cctype>
+#include <string>
+
+#include <pacbio/data/ArrayRead.h>
+
+namespace tests {
+
+/// Read aligned from the 0-based reference position start, cigar and bases
+/// in alignment order. Lowercase bases fail the default SubQV threshold.
+class TestRead : public PacBio::Data::ArrayRead
+{
+public:
+    TestRead(const int idx, const int start, const std::string& cigar, const std::string& bases,
+             const std::string& chemistry = "S/P2-C2")
+        : ArrayRead(idx, "read/" + std::to_string(idx)), chemistry_(chemistry)
+    {
+        referenceStart_ = start;
+        referenceEnd_ = start;
+        for (size_t i = 0; i < cigar.size(); ++i) {
+            const bool low = std::islower(bases[i]);
+            Bases.emplace_back(cigar[i], std::toupper(bases[i]), 60, low ? 10 : 60, 60, 60);
+            if (cigar[i] != 'I') ++referenceEnd_;
+        }
+    }
+
+    std::string SequencingChemistry() const override { return chemistry_; }
+
+private:
+    const std::string chemistry_;
+};
+
+}  // namespace tests
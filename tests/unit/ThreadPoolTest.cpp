@@ -0,0 +1,119 @@
+// Copyright (c) 2011-2014, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/util/ThreadPool.h>
+
+using namespace PacBio::Util;  // NOLINT
+
+namespace {
+
+TEST(ThreadPoolTest, ParallelForVisitsEachIndexOnce)
+{
+    ThreadPool pool(4);
+    std::vector<int> visits(10007, 0);
+    ParallelFor(0, visits.size(), [&visits](size_t i) { ++visits[i]; }, pool);
+    for (const auto v : visits)
+        EXPECT_EQ(1, v);
+}
+
+TEST(ThreadPoolTest, ParallelForRangeIsDisjoint)
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> sum(0);
+    ParallelForRange(5, 1005,
+                     [&sum](size_t begin, size_t end) {
+                         EXPECT_LT(begin, end);
+                         for (size_t i = begin; i < end; ++i)
+                             sum += i;
+                     },
+                     pool);
+    EXPECT_EQ(504500u, sum);
+}
+
+TEST(ThreadPoolTest, NestedLoopsDoNotDeadlock)
+{
+    ThreadPool pool(2);
+    std::atomic<int> count(0);
+    ParallelFor(0, 64, [&](size_t) { ParallelFor(0, 64, [&](size_t) { ++count; }, pool); }, pool);
+    EXPECT_EQ(64 * 64, count);
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrows)
+{
+    ThreadPool pool(4);
+    TaskGroup group(pool);
+    std::atomic<int> count(0);
+    for (int i = 0; i < 100; ++i)
+        group.Run([&count, i]() {
+            ++count;
+            if (i == 42) throw std::runtime_error("42");
+        });
+    EXPECT_THROW(group.Wait(), std::runtime_error);
+    EXPECT_EQ(100, count);
+}
+
+TEST(ThreadPoolTest, WaitUntilHelpsWithoutWorkers)
+{
+    ThreadPool pool(1);
+    TaskGroup group(pool);
+    std::atomic<int> done(0);
+    for (int i = 0; i < 10; ++i) {
+        // Only one task in flight, the waiting thread has to run it
+        group.WaitUntil([&done, i]() { return done == i; });
+        EXPECT_EQ(i, done);
+        group.Run([&done]() { ++done; });
+    }
+    group.Wait();
+    EXPECT_EQ(10, done);
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInline)
+{
+    ThreadPool pool(1);
+    EXPECT_EQ(1u, pool.NumThreads());
+    int sum = 0;
+    ParallelFor(0, 10, [&sum](size_t i) { sum += i; }, pool);
+    EXPECT_EQ(45, sum);
+}
+}
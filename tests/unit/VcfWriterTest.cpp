@@ -0,0 +1,227 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <htslib/hts.h>
+#include <htslib/tbx.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/Version.h>
+#include <pacbio/juliet/AminoAcidCaller.h>
+
+#include "TempDir.h"
+
+using namespace PacBio::Juliet;  // NOLINT
+using tests::TempDir;
+
+namespace {
+
+using VariantPosition = VariantGene::VariantPosition;
+
+void AddCodon(VariantGene* gene, const int codonPos, const std::string& refCodon,
+              const char refAminoAcid, const int coverage, const char aminoAcid,
+              const VariantPosition::VariantCodon& codon)
+{
+    auto& position = gene->relPositionToVariant[codonPos];
+    if (!position) {
+        position = std::make_shared<VariantPosition>();
+        position->refCodon = refCodon;
+        position->refAminoAcid = refAminoAcid;
+        position->coverage = coverage;
+    }
+    position->aminoAcidToCodons[aminoAcid].push_back(codon);
+}
+
+/// PR and RT in reading order, then a gene overlapping PR in another frame
+struct Variants
+{
+    Variants()
+    {
+        config.referenceName = "HIV";
+        config.referenceSequence = std::string(3000, 'A');
+        config.referenceSequence.replace(2255, 3, "CAG");
+        config.referenceSequence.replace(2278, 4, "ACCT");
+        config.referenceSequence.replace(2549, 3, "ACG");
+
+        VariantGene pr;
+        pr.geneName = "PR";
+        pr.geneOffset = 2253;
+        AddCodon(&pr, 2, "CAG", 'Q', 800, '*', {"TAA", 0.02, 0.001, "", {}});
+        // Called, but without variant codons
+        pr.relPositionToVariant[5] = std::make_shared<VariantPosition>();
+        AddCodon(&pr, 10, "CCT", 'P', 1000, 'L', {"CTT", 0.012, 1e-5, "ATV/r, LPV", {}});
+        AddCodon(&pr, 10, "CCT", 'P', 1000, 'S', {"TCT", 0.05, 1e-4, "", {}});
+
+        VariantGene rt;
+        rt.geneName = "RT";
+        rt.geneOffset = 2550;
+        AddCodon(&rt, 1, "ACG", 'T', 700, 'T', {"ACA", 0.5, 0, "", {}});
+
+        VariantGene p6;
+        p6.geneName = "P6";
+        p6.geneOffset = 2279;
+        AddCodon(&p6, 1, "ACC", 'T', 900, 'A', {"GCC", 0.3, 1e-20, "", {}});
+
+        genes = {pr, rt, p6};
+    }
+
+    std::vector<VariantGene> genes;
+    TargetConfig config;
+};
+
+const std::vector<std::string> expectedRecords = {
+    "HIV\t2256\t.\tCAG\tTAA\t.\tPASS\tAF=0.02;DP=800;PV=0.001;GENE=PR;AA=Q2*;CODON=CAG>TAA",
+    "HIV\t2279\t.\tA\tG\t.\tPASS\tAF=0.3;DP=900;PV=1e-20;GENE=P6;AA=T1A;CODON=ACC>GCC",
+    "HIV\t2280\t.\tC\tT\t.\tPASS\tAF=0.05;DP=1000;PV=0.0001;GENE=PR;AA=P10S;CODON=CCT>TCT",
+    "HIV\t2281\t.\tC\tT\t.\tPASS\tAF=0.012;DP=1000;PV=1e-05;GENE=PR;AA=P10L;CODON=CCT>CTT;"
+    "DRM=ATV/r|_LPV",
+    "HIV\t2552\t.\tG\tA\t.\tPASS\tAF=0.5;DP=700;PV=0;GENE=RT;AA=T1T;CODON=ACG>ACA"};
+
+std::vector<std::string> ReadLines(const std::string& path)
+{
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+/// All lines of a BGZF file, decompressed by htslib
+std::vector<std::string> ReadBgzfLines(const std::string& path)
+{
+    std::vector<std::string> lines;
+    htsFile* file = hts_open(path.c_str(), "r");
+    if (!file) return lines;
+    kstring_t line = {0, 0, nullptr};
+    while (hts_getline(file, '\n', &line) >= 0)
+        lines.emplace_back(line.s, line.l);
+    std::free(line.s);
+    hts_close(file);
+    return lines;
+}
+
+/// Records overlapping region, found through the tabix index
+std::vector<std::string> TabixQuery(const std::string& path, const std::string& region)
+{
+    std::vector<std::string> lines;
+    htsFile* file = hts_open(path.c_str(), "r");
+    tbx_t* index = tbx_index_load(path.c_str());
+    if (file && index) {
+        if (hts_itr_t* it = tbx_itr_querys(index, region.c_str())) {
+            kstring_t line = {0, 0, nullptr};
+            while (tbx_itr_next(file, index, it, &line) >= 0)
+                lines.emplace_back(line.s, line.l);
+            std::free(line.s);
+            tbx_itr_destroy(it);
+        }
+    }
+    if (index) tbx_destroy(index);
+    if (file) hts_close(file);
+    return lines;
+}
+
+TEST(VcfWriterTest, WritesHeaderAndRecordsInReferenceOrder)
+{
+    const TempDir tmp("juliet_vcf");
+    const std::string path = tmp.Path + "/variants.vcf";
+    const Variants variants;
+    AminoAcidCaller::WriteVcf(variants.genes, variants.config, path, "HIV");
+
+    const std::vector<std::string> header = {
+        "##fileformat=VCFv4.2", "##source=juliet " + PacBio::MinorseqVersion(),
+        "##contig=<ID=HIV,length=3000>",
+        "##INFO=<ID=AF,Number=1,Type=Float,Description=\"Codon frequency\">",
+        "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Codon coverage\">",
+        "##INFO=<ID=PV,Number=1,Type=Float,Description=\"Bonferroni-corrected p-value\">",
+        "##INFO=<ID=GENE,Number=1,Type=String,Description=\"Gene\">",
+        "##INFO=<ID=AA,Number=1,Type=String,Description=\"Amino acid change, relative to the "
+        "gene\">",
+        "##INFO=<ID=CODON,Number=1,Type=String,Description=\"Reference and variant codon\">",
+        "##INFO=<ID=DRM,Number=1,Type=String,Description=\"Known drug-resistance mutations\">",
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO"};
+    std::vector<std::string> expected = header;
+    expected.insert(expected.end(), expectedRecords.cbegin(), expectedRecords.cend());
+    EXPECT_EQ(expected, ReadLines(path));
+}
+
+TEST(VcfWriterTest, PositionsAreOneBasedInReference)
+{
+    const TempDir tmp("juliet_vcf");
+    const std::string path = tmp.Path + "/variants.vcf";
+    const Variants variants;
+    AminoAcidCaller::WriteVcf(variants.genes, variants.config, path, "HIV");
+
+    int numRecords = 0;
+    for (const auto& line : ReadLines(path)) {
+        if (line[0] == '#') continue;
+        ++numRecords;
+        const size_t posBegin = line.find('\t') + 1;
+        const size_t refBegin = line.find("\t.\t", posBegin) + 3;
+        const int pos = std::stoi(line.substr(posBegin));
+        const std::string ref = line.substr(refBegin, line.find('\t', refBegin) - refBegin);
+        EXPECT_EQ(ref, variants.config.referenceSequence.substr(pos - 1, ref.size())) << line;
+    }
+    EXPECT_EQ(5, numRecords);
+}
+
+TEST(VcfWriterTest, CompressedOutputReadsBackWithTabix)
+{
+    const TempDir tmp("juliet_vcf");
+    const std::string plain = tmp.Path + "/variants.vcf";
+    const std::string compressed = tmp.Path + "/variants.vcf.gz";
+    const Variants variants;
+    AminoAcidCaller::WriteVcf(variants.genes, variants.config, plain, "HIV");
+    AminoAcidCaller::WriteVcf(variants.genes, variants.config, compressed, "HIV");
+
+    EXPECT_TRUE(std::ifstream(compressed + ".tbi").good());
+    EXPECT_EQ(ReadLines(plain), ReadBgzfLines(compressed));
+
+    EXPECT_EQ(std::vector<std::string>({expectedRecords[2], expectedRecords[3]}),
+              TabixQuery(compressed, "HIV:2280-2281"));
+    EXPECT_EQ(std::vector<std::string>({expectedRecords[4]}),
+              TabixQuery(compressed, "HIV:2552-2552"));
+    EXPECT_TRUE(TabixQuery(compressed, "HIV:1-2255").empty());
+}
+
+}  // namespace
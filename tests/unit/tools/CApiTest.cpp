@@ -0,0 +1,208 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/capi/Minorseq.h>
+#include <pacbio/io/BamParser.h>
+#include <pacbio/juliet/JulietSettings.h>
+#include <pacbio/juliet/JulietWorkflow.h>
+#include <pacbio/mixsim/Simulator.h>
+
+#include "TempDir.h"
+
+using namespace PacBio;  // NOLINT
+using tests::TempDir;
+
+namespace {
+
+std::string RandomReference(const size_t length)
+{
+    std::mt19937 rng(7);
+    std::string reference;
+    for (size_t i = 0; i < length; ++i)
+        reference += "ACGT"[rng() % 4];
+    return reference;
+}
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream in(path);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+/// One gene over a simulated 10% minor haplotype with three codon
+/// substitutions, written to a BAM in a temporary directory
+struct SimulatedSample
+{
+    SimulatedSample() : Tmp("minorseq_capi"), Bam(Tmp.Path + "/sample.bam")
+    {
+        const std::string reference = RandomReference(300);
+        Config = "{\"referenceName\":\"mini\",\"referenceSequence\":\"" + reference +
+                 "\",\"genes\":[{\"name\":\"G\",\"begin\":1,\"end\":301}]}";
+        Mixsim::MixsimSettings settings;
+        settings.TargetConfigUser = Juliet::TargetConfig(Config);
+        settings.Coverage = 1000;
+        settings.MinorPercentages = {10};
+        settings.PartialPercentage = 0;
+        Mixsim::Simulator simulator("mini", reference, settings);
+        simulator.WriteBam(Bam);
+        Truth = simulator.Haplotypes().at(1).Variants;
+    }
+
+    TempDir Tmp;
+    std::string Bam;
+    std::string Config;
+    std::vector<Mixsim::SimulatedVariant> Truth;
+};
+
+TEST(CApiTest, CallsSimulatedVariants)
+{
+    const SimulatedSample sample;
+
+    ms_config* config = nullptr;
+    ms_reads* reads = nullptr;
+    ms_result* result = nullptr;
+    ASSERT_EQ(MS_OK, ms_config_create(&config));
+    ASSERT_EQ(MS_OK, ms_reads_create(&reads));
+    ASSERT_EQ(MS_OK, ms_result_create(&result));
+
+    ASSERT_EQ(MS_OK, ms_config_set_target(config, sample.Config.c_str())) << ms_last_error();
+    ASSERT_EQ(MS_OK, ms_reads_open(reads, sample.Bam.c_str(), config)) << ms_last_error();
+    EXPECT_EQ(1000u, ms_reads_count(reads));
+    ASSERT_EQ(MS_OK, ms_call(config, reads, result)) << ms_last_error();
+
+    ASSERT_EQ(3u, sample.Truth.size());
+    for (const auto& truth : sample.Truth) {
+        bool found = false;
+        for (size_t i = 0; i < ms_result_num_variants(result); ++i) {
+            ms_variant v;
+            ASSERT_EQ(MS_OK, ms_result_variant(result, i, &v));
+            if (v.codon_pos != truth.AminoAcidPosition || truth.AltCodon != v.alt_codon) continue;
+            found = true;
+            EXPECT_STREQ("G", v.gene);
+            EXPECT_EQ(truth.RefCodon, v.ref_codon);
+            EXPECT_GT(v.coverage, 900);
+            EXPECT_NEAR(0.1, v.frequency, 0.03);
+            EXPECT_LT(v.p_value, 0.01);
+            EXPECT_STREQ("", v.known_drm);
+        }
+        EXPECT_TRUE(found) << truth.Gene << " " << truth.AminoAcidPosition << " " << truth.RefCodon
+                           << ">" << truth.AltCodon;
+    }
+
+    ms_variant v;
+    EXPECT_EQ(MS_ERROR, ms_result_variant(result, ms_result_num_variants(result), &v));
+    EXPECT_THAT(ms_last_error(), ::testing::HasSubstr("out of range"));
+
+    const std::string json = sample.Tmp.Path + "/capi.json";
+    ASSERT_EQ(MS_OK, ms_result_write_json(result, json.c_str())) << ms_last_error();
+    EXPECT_FALSE(ReadFile(json).empty());
+
+    ms_result_free(result);
+    ms_reads_free(reads);
+    ms_config_free(config);
+}
+
+TEST(CApiTest, SharesCallingWithJuliet)
+{
+    const SimulatedSample sample;
+
+    ms_config* config = nullptr;
+    ms_reads* reads = nullptr;
+    ms_result* result = nullptr;
+    ASSERT_EQ(MS_OK, ms_config_create(&config));
+    ASSERT_EQ(MS_OK, ms_reads_create(&reads));
+    ASSERT_EQ(MS_OK, ms_result_create(&result));
+    ASSERT_EQ(MS_OK, ms_config_set_target(config, sample.Config.c_str()));
+    ASSERT_EQ(MS_OK, ms_config_set_mode(config, MS_MODE_PHASING));
+    ASSERT_EQ(MS_OK, ms_reads_open(reads, sample.Bam.c_str(), config));
+    ASSERT_EQ(MS_OK, ms_call(config, reads, result)) << ms_last_error();
+    const std::string capiJson = sample.Tmp.Path + "/capi.json";
+    ASSERT_EQ(MS_OK, ms_result_write_json(result, capiJson.c_str()));
+
+    Juliet::JulietSettings settings;
+    settings.TargetConfigUser = Juliet::TargetConfig(sample.Config);
+    settings.Mode = Juliet::AnalysisMode::PHASING;
+    const std::string julietJson = sample.Tmp.Path + "/juliet.json";
+    const auto summary = Juliet::JulietWorkflow().CallVariants(
+        IO::BamToArrayReads(sample.Bam), settings, sample.Bam, "", julietJson);
+
+    EXPECT_EQ(ReadFile(julietJson), ReadFile(capiJson));
+    EXPECT_EQ(summary.NumHaplotypes, ms_result_num_haplotypes(result));
+    EXPECT_LT(0u, ms_result_num_haplotypes(result));
+
+    ms_result_free(result);
+    ms_reads_free(reads);
+    ms_config_free(config);
+}
+
+TEST(CApiTest, ReportsErrorsOfReusedHandles)
+{
+    ms_config* config = nullptr;
+    ms_reads* reads = nullptr;
+    ms_result* result = nullptr;
+    ASSERT_EQ(MS_OK, ms_config_create(&config));
+    ASSERT_EQ(MS_OK, ms_reads_create(&reads));
+    ASSERT_EQ(MS_OK, ms_result_create(&result));
+
+    EXPECT_EQ(MS_ERROR, ms_call(config, reads, result));
+    EXPECT_STREQ("No reads to call variants on", ms_last_error());
+    EXPECT_EQ(0u, ms_result_num_variants(result));
+    EXPECT_EQ(MS_ERROR, ms_result_write_json(result, "unused.json"));
+    EXPECT_EQ(MS_ERROR, ms_call(config, nullptr, result));
+    EXPECT_STREQ("reads must not be null", ms_last_error());
+    EXPECT_EQ(MS_ERROR, ms_reads_open(reads, "/nonexistent.bam", config));
+    EXPECT_EQ(0u, ms_reads_count(reads));
+    EXPECT_EQ(MS_ERROR, ms_config_set_percentages(config, 5, 1));
+
+    ms_result_free(result);
+    ms_reads_free(reads);
+    ms_config_free(config);
+}
+
+}  // namespace
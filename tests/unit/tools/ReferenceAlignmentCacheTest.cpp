@@ -0,0 +1,170 @@
+// Copyright (c) 2016-2017, Pacific Biosciences of California, Inc.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the
+// disclaimer below) provided that the following conditions are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//  * Neither the name of Pacific Biosciences nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+// GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY PACIFIC
+// BIOSCIENCES AND ITS CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL PACIFIC BIOSCIENCES OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+// USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+// OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+
+// Author: Armin Töpfer
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pacbio/cleric/ReferenceAlignmentCache.h>
+
+#include "TempDir.h"
+
+using namespace PacBio::Cleric;  // NOLINT
+using tests::TempDir;
+
+namespace {
+
+const std::string fromMD5 = "0123456789abcdef0123456789abcdef";
+const std::string toMD5 = "fedcba9876543210fedcba9876543210";
+
+std::string EntryPath(const std::string& dir)
+{
+    return dir + "/" + fromMD5 + "_" + toMD5 + ".cleric";
+}
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream in(path);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+void WriteFile(const std::string& path, const std::string& content)
+{
+    std::ofstream out(path);
+    out << content;
+}
+
+ReferenceAlignment TestAlignment()
+{
+    ReferenceAlignment alignment;
+    alignment.FromReferenceAligned = "ACG-TTA";
+    alignment.ToReferenceAligned = "ACGGTT-";
+    alignment.SamPosToFastaPos = {{0, 0}, {1, 1}, {2, 2}, {3, 4}, {4, 5}};
+    alignment.FastaPosToSamPos = {{0, 0}, {1, 1}, {2, 2}, {4, 3}, {5, 4}};
+    return alignment;
+}
+
+TEST(ReferenceAlignmentCacheTest, StoreLoadRoundTrip)
+{
+    const TempDir tmp("cleric_cache");
+    const auto& dir = tmp.Path;
+    ReferenceAlignmentCache cache(dir);
+    const auto expected = TestAlignment();
+    cache.Store(fromMD5, toMD5, expected);
+
+    ReferenceAlignment loaded;
+    ASSERT_TRUE(cache.Load(fromMD5, toMD5, &loaded));
+    EXPECT_EQ(expected.FromReferenceAligned, loaded.FromReferenceAligned);
+    EXPECT_EQ(expected.ToReferenceAligned, loaded.ToReferenceAligned);
+    EXPECT_EQ(expected.SamPosToFastaPos, loaded.SamPosToFastaPos);
+    EXPECT_EQ(expected.FastaPosToSamPos, loaded.FastaPosToSamPos);
+}
+
+TEST(ReferenceAlignmentCacheTest, ChangedReferenceMisses)
+{
+    const TempDir tmp("cleric_cache");
+    const auto& dir = tmp.Path;
+    ReferenceAlignmentCache cache(dir);
+    cache.Store(fromMD5, toMD5, TestAlignment());
+
+    ReferenceAlignment loaded;
+    EXPECT_FALSE(cache.Load(toMD5, toMD5, &loaded));
+    EXPECT_FALSE(cache.Load(fromMD5, fromMD5, &loaded));
+
+    // An entry renamed to another pair must not be trusted either
+    std::rename(EntryPath(dir).c_str(), (dir + "/" + toMD5 + "_" + fromMD5 + ".cleric").c_str());
+    EXPECT_FALSE(cache.Load(toMD5, fromMD5, &loaded));
+}
+
+TEST(ReferenceAlignmentCacheTest, ChangedVersionMisses)
+{
+    const TempDir tmp("cleric_cache");
+    const auto& dir = tmp.Path;
+    ReferenceAlignmentCache cache(dir);
+    cache.Store(fromMD5, toMD5, TestAlignment());
+
+    auto entry = ReadFile(EntryPath(dir));
+    const auto versionStart = entry.find(' ') + 1;
+    const auto versionEnd = entry.find('\n');
+    const int version = std::stoi(entry.substr(versionStart, versionEnd - versionStart));
+    entry.replace(versionStart, versionEnd - versionStart, std::to_string(version + 1));
+    WriteFile(EntryPath(dir), entry);
+
+    ReferenceAlignment loaded;
+    EXPECT_FALSE(cache.Load(fromMD5, toMD5, &loaded));
+}
+
+TEST(ReferenceAlignmentCacheTest, TruncatedEntryMisses)
+{
+    const TempDir tmp("cleric_cache");
+    const auto& dir = tmp.Path;
+    ReferenceAlignmentCache cache(dir);
+    cache.Store(fromMD5, toMD5, TestAlignment());
+
+    const auto entry = ReadFile(EntryPath(dir));
+    ReferenceAlignment loaded;
+    for (size_t size = 0; size < entry.size(); ++size) {
+        WriteFile(EntryPath(dir), entry.substr(0, size));
+        EXPECT_FALSE(cache.Load(fromMD5, toMD5, &loaded)) << "truncated to " << size;
+    }
+    EXPECT_TRUE(loaded.FromReferenceAligned.empty());
+}
+
+TEST(ReferenceAlignmentCacheTest, CorruptEntryMisses)
+{
+    const TempDir tmp("cleric_cache");
+    const auto& dir = tmp.Path;
+    ReferenceAlignmentCache cache(dir);
+    cache.Store(fromMD5, toMD5, TestAlignment());
+
+    const auto entry = ReadFile(EntryPath(dir));
+    ReferenceAlignment loaded;
+    for (size_t i = 0; i < entry.size(); ++i) {
+        auto corrupt = entry;
+        corrupt[i] = corrupt[i] == 'A' ? 'C' : 'A';
+        WriteFile(EntryPath(dir), corrupt);
+        EXPECT_FALSE(cache.Load(fromMD5, toMD5, &loaded)) << "corrupted at " << i;
+    }
+    EXPECT_TRUE(loaded.FromReferenceAligned.empty());
+}
+
+}  // namespace
@@ -42,14 +42,7 @@
 #include <string.h>
 #include <math.h>
 #include "ssw.h"
-
-#ifdef __GNUC__
-#define LIKELY(x) __builtin_expect((x),1)
-#define UNLIKELY(x) __builtin_expect((x),0)
-#else
-#define LIKELY(x) (x)
-#define UNLIKELY(x) (x)
-#endif
+#include "ssw_internal.h"
 
 /* Convert the coordinate in the scoring matrix into the coordinate in one line of the band. */
 #define set_u(u, w, i, j) { int x=(i)-(w); x=x>0?x:0; (u)=(j)-x+1; }
@@ -64,20 +57,15 @@
  */
 #define kroundup32(x) (--(x), (x)|=(x)>>1, (x)|=(x)>>2, (x)|=(x)>>4, (x)|=(x)>>8, (x)|=(x)>>16, ++(x))
 
-typedef struct {
-	uint16_t score;
-	int32_t ref;	 //0-based position
-	int32_t read;    //alignment ending position on read, 0-based
-} alignment_end;
-
 typedef struct {
 	uint32_t* seq;
 	int32_t length;
 } cigar;
 
 struct _profile{
-	__m128i* profile_byte;	// 0: none
-	__m128i* profile_word;	// 0: none
+	void* profile_byte;	// 0: none
+	void* profile_word;	// 0: none
+	const ssw_kernel* kernel;	// kernels matching the layout of the profiles
 	const int8_t* read;
 	const int8_t* mat;
 	int32_t readLen;
@@ -86,7 +74,7 @@ struct _profile{
 };
 
 /* Generate query profile rearrange query sequence & calculate the weight of match/mismatch. */
-static __m128i* qP_byte (const int8_t* read_num,
+static void* qP_byte (const int8_t* read_num,
 				  const int8_t* mat,
 				  const int32_t readLen,
 				  const int32_t n,	/* the edge length of the squre matrix mat */
@@ -126,7 +114,7 @@ static alignment_end* sw_sse2_byte (const int8_t* ref,
 							 int32_t readLen,
 							 const uint8_t weight_gapO, /* will be used as - */
 							 const uint8_t weight_gapE, /* will be used as - */
-							 const __m128i* vProfile,
+							 const void* vProfileData,
 							 uint8_t terminate,	/* the best alignment score: used to terminate
 												   the matrix calculation when locating the
 												   alignment beginning point. If this score
@@ -140,6 +128,7 @@ static alignment_end* sw_sse2_byte (const int8_t* ref,
 					  (vm) = _mm_max_epu8((vm), _mm_srli_si128((vm), 1)); \
 					  (m) = _mm_extract_epi16((vm), 0)
 
+	const __m128i* vProfile = (const __m128i*)vProfileData;
 	uint8_t max = 0;		                     /* the max alignment score */
 	int32_t end_read = readLen - 1;
 	int32_t end_ref = -1; /* 0_based best alignment ending point; Initialized as isn't aligned -1. */
@@ -327,7 +316,7 @@ static alignment_end* sw_sse2_byte (const int8_t* ref,
 	return bests;
 }
 
-static __m128i* qP_word (const int8_t* read_num,
+static void* qP_word (const int8_t* read_num,
 				  const int8_t* mat,
 				  const int32_t readLen,
 				  const int32_t n) {
@@ -357,7 +346,7 @@ static alignment_end* sw_sse2_word (const int8_t* ref,
 							 int32_t readLen,
 							 const uint8_t weight_gapO, /* will be used as - */
 							 const uint8_t weight_gapE, /* will be used as - */
-							 const __m128i* vProfile,
+							 const void* vProfileData,
 							 uint16_t terminate,
 							 int32_t maskLen) {
 
@@ -366,6 +355,7 @@ static alignment_end* sw_sse2_word (const int8_t* ref,
 					(vm) = _mm_max_epi16((vm), _mm_srli_si128((vm), 2)); \
 					(m) = _mm_extract_epi16((vm), 0)
 
+	const __m128i* vProfile = (const __m128i*)vProfileData;
 	uint16_t max = 0;		                     /* the max alignment score */
 	int32_t end_read = readLen - 1;
 	int32_t end_ref = 0; /* 1_based best alignment ending point; Initialized as isn't aligned - 0. */
@@ -761,10 +751,43 @@ static int8_t* seq_reverse(const int8_t* seq, int32_t end)	/* end is 0-based ali
 	return reverse;
 }
 
+static const ssw_kernel ssw_kernel_sse2 = {
+	qP_byte,
+	sw_sse2_byte,
+	qP_word,
+	sw_sse2_word,
+	"sse2"
+};
+
+static ssw_simd simd_limit = SSW_SIMD_AUTO;
+
+/* Widest kernel supported by the compiler, the cpu, and simd_limit. */
+static const ssw_kernel* select_kernel (void) {
+#if defined(__GNUC__) && defined(SSW_HAVE_AVX512BW)
+	if ((simd_limit == SSW_SIMD_AUTO || simd_limit >= SSW_SIMD_AVX512BW) && __builtin_cpu_supports("avx512bw"))
+		return &ssw_kernel_avx512bw;
+#endif
+#if defined(__GNUC__) && defined(SSW_HAVE_AVX2)
+	if ((simd_limit == SSW_SIMD_AUTO || simd_limit >= SSW_SIMD_AVX2) && __builtin_cpu_supports("avx2"))
+		return &ssw_kernel_avx2;
+#endif
+	return &ssw_kernel_sse2;
+}
+
+const char* ssw_set_simd (const ssw_simd limit) {
+	simd_limit = limit;
+	return select_kernel()->name;
+}
+
+const char* ssw_simd_name (void) {
+	return select_kernel()->name;
+}
+
 s_profile* ssw_init (const int8_t* read, const int32_t readLen, const int8_t* mat, const int32_t n, const int8_t score_size) {
 	s_profile* p = (s_profile*)calloc(1, sizeof(struct _profile));
 	p->profile_byte = 0;
 	p->profile_word = 0;
+	p->kernel = select_kernel();
 	p->bias = 0;
 
 	if (score_size == 0 || score_size == 2) {
@@ -774,9 +797,9 @@ s_profile* ssw_init (const int8_t* read, const int32_t readLen, const int8_t* ma
 		bias = abs(bias);
 
 		p->bias = bias;
-		p->profile_byte = qP_byte (read, mat, readLen, n, bias);
+		p->profile_byte = p->kernel->qP_byte (read, mat, readLen, n, bias);
 	}
-	if (score_size == 1 || score_size == 2) p->profile_word = qP_word (read, mat, readLen, n);
+	if (score_size == 1 || score_size == 2) p->profile_word = p->kernel->qP_word (read, mat, readLen, n);
 	p->read = read;
 	p->mat = mat;
 	p->readLen = readLen;
@@ -801,7 +824,8 @@ s_align* ssw_align (const s_profile* prof,
 					const int32_t maskLen) {
 
 	alignment_end* bests = 0, *bests_reverse = 0;
-	__m128i* vP = 0;
+	const ssw_kernel* kernel = prof->kernel;
+	void* vP = 0;
 	int32_t word = 0, band_width = 0, readLen = prof->readLen;
 	int8_t* read_reverse = 0;
 	cigar* path;
@@ -816,10 +840,10 @@ s_align* ssw_align (const s_profile* prof,
 
 	// Find the alignment scores and ending positions
 	if (prof->profile_byte) {
-		bests = sw_sse2_byte(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_byte, -1, prof->bias, maskLen);
+		bests = kernel->sw_byte(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_byte, -1, prof->bias, maskLen);
 		if (prof->profile_word && bests[0].score == 255) {
 			free(bests);
-			bests = sw_sse2_word(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_word, -1, maskLen);
+			bests = kernel->sw_word(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_word, -1, maskLen);
 			word = 1;
 		} else if (bests[0].score == 255) {
 			fprintf(stderr, "Please set 2 to the score_size parameter of the function ssw_init, otherwise the alignment results will be incorrect.\n");
@@ -827,7 +851,7 @@ s_align* ssw_align (const s_profile* prof,
 			return NULL;
 		}
 	}else if (prof->profile_word) {
-		bests = sw_sse2_word(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_word, -1, maskLen);
+		bests = kernel->sw_word(ref, 0, refLen, readLen, weight_gapO, weight_gapE, prof->profile_word, -1, maskLen);
 		word = 1;
 	}else {
 		fprintf(stderr, "Please call the function ssw_init before ssw_align.\n");
@@ -850,11 +874,11 @@ s_align* ssw_align (const s_profile* prof,
 	// Find the beginning position of the best alignment.
 	read_reverse = seq_reverse(prof->read, r->read_end1);
 	if (word == 0) {
-		vP = qP_byte(read_reverse, prof->mat, r->read_end1 + 1, prof->n, prof->bias);
-		bests_reverse = sw_sse2_byte(ref, 1, r->ref_end1 + 1, r->read_end1 + 1, weight_gapO, weight_gapE, vP, r->score1, prof->bias, maskLen);
+		vP = kernel->qP_byte(read_reverse, prof->mat, r->read_end1 + 1, prof->n, prof->bias);
+		bests_reverse = kernel->sw_byte(ref, 1, r->ref_end1 + 1, r->read_end1 + 1, weight_gapO, weight_gapE, vP, r->score1, prof->bias, maskLen);
 	} else {
-		vP = qP_word(read_reverse, prof->mat, r->read_end1 + 1, prof->n);
-		bests_reverse = sw_sse2_word(ref, 1, r->ref_end1 + 1, r->read_end1 + 1, weight_gapO, weight_gapE, vP, r->score1, maskLen);
+		vP = kernel->qP_word(read_reverse, prof->mat, r->read_end1 + 1, prof->n);
+		bests_reverse = kernel->sw_word(ref, 1, r->ref_end1 + 1, r->read_end1 + 1, weight_gapO, weight_gapE, vP, r->score1, maskLen);
 	}
 	free(vP);
 	free(read_reverse);
@@ -56,6 +56,25 @@ typedef struct {
 	int32_t cigarLen;
 } s_align;
 
+/*!	@typedef	instruction sets of the striped kernels, ordered by vector width	*/
+typedef enum {
+	SSW_SIMD_AUTO = 0,
+	SSW_SIMD_SSE2,
+	SSW_SIMD_AVX2,
+	SSW_SIMD_AVX512BW
+} ssw_simd;
+
+/*!	@function	Limit the instruction set of the striped kernels.
+	@param	limit	widest instruction set to use; SSW_SIMD_AUTO uses the widest one supported by the cpu
+	@return	name of the instruction set used by profiles created afterwards
+	@discussion	Kernels are selected at runtime from cpuid, SSE2 is the fallback. Profiles keep the kernel
+	they were created with, changing the limit is not thread-safe with respect to concurrent ssw_init calls.
+*/
+const char* ssw_set_simd (const ssw_simd limit);
+
+/*!	@function	Name of the instruction set ssw_init currently selects, e.g. "avx2".	*/
+const char* ssw_simd_name (void);
+
 /*!	@function	Create the query profile using the query sequence.
 	@param	read	pointer to the query sequence; the query sequence needs to be numbers
 	@param	readLen	length of the query sequence
@@ -0,0 +1,99 @@
+/*
+ *  ssw_avx2.c
+ *
+ *  AVX2 striped kernels, 32 lanes of 8 bit or 16 lanes of 16 bit.
+ *  Has to be compiled with -mavx2, selected at runtime by ssw_init.
+ *
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+typedef __m256i simd_t;
+
+#define SSW_SUFFIX avx2
+#define SSW_KERNEL_NAME "avx2"
+#define SIMD_LANES8 32
+#define SIMD_LANES16 16
+
+#define simd_zero() _mm256_setzero_si256()
+#define simd_set1_8(x) _mm256_set1_epi8(x)
+#define simd_set1_16(x) _mm256_set1_epi16(x)
+#define simd_load(p) _mm256_load_si256(p)
+#define simd_store(p, v) _mm256_store_si256((p), (v))
+#define simd_adds_epu8(a, b) _mm256_adds_epu8((a), (b))
+#define simd_subs_epu8(a, b) _mm256_subs_epu8((a), (b))
+#define simd_max_epu8(a, b) _mm256_max_epu8((a), (b))
+#define simd_adds_epi16(a, b) _mm256_adds_epi16((a), (b))
+#define simd_subs_epu16(a, b) _mm256_subs_epu16((a), (b))
+#define simd_max_epi16(a, b) _mm256_max_epi16((a), (b))
+
+/* The low 128 bit lane of v moved to the high lane, low lane zeroed,
+   provides the bytes crossing the lane boundary for alignr. */
+static inline simd_t simd_lanes_up(simd_t v) {
+	return _mm256_permute2x128_si256(v, v, 0x08);
+}
+
+static inline simd_t simd_shift8(simd_t v) {
+	return _mm256_alignr_epi8(v, simd_lanes_up(v), 15);
+}
+
+static inline simd_t simd_shift16(simd_t v) {
+	return _mm256_alignr_epi8(v, simd_lanes_up(v), 14);
+}
+
+static inline simd_t simd_decay8(simd_t v, int c) {
+	return _mm256_subs_epu8(v, _mm256_set1_epi8((char)(c > 0xFF ? 0xFF : c)));
+}
+
+static inline simd_t simd_decay16(simd_t v, int c) {
+	return _mm256_subs_epu16(v, _mm256_set1_epi16((short)(c > 0xFFFF ? 0xFFFF : c)));
+}
+
+static inline simd_t simd_scan8(simd_t v, int c) {
+	v = _mm256_max_epu8(v, simd_decay8(_mm256_alignr_epi8(v, simd_lanes_up(v), 15), c));
+	v = _mm256_max_epu8(v, simd_decay8(_mm256_alignr_epi8(v, simd_lanes_up(v), 14), 2 * c));
+	v = _mm256_max_epu8(v, simd_decay8(_mm256_alignr_epi8(v, simd_lanes_up(v), 12), 4 * c));
+	v = _mm256_max_epu8(v, simd_decay8(_mm256_alignr_epi8(v, simd_lanes_up(v), 8), 8 * c));
+	v = _mm256_max_epu8(v, simd_decay8(simd_lanes_up(v), 16 * c));
+	return v;
+}
+
+static inline simd_t simd_scan16(simd_t v, int c) {
+	v = _mm256_max_epi16(v, simd_decay16(_mm256_alignr_epi8(v, simd_lanes_up(v), 14), c));
+	v = _mm256_max_epi16(v, simd_decay16(_mm256_alignr_epi8(v, simd_lanes_up(v), 12), 2 * c));
+	v = _mm256_max_epi16(v, simd_decay16(_mm256_alignr_epi8(v, simd_lanes_up(v), 8), 4 * c));
+	v = _mm256_max_epi16(v, simd_decay16(simd_lanes_up(v), 8 * c));
+	return v;
+}
+
+static inline int simd_all_eq8(simd_t a, simd_t b) {
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) == -1;
+}
+
+static inline int simd_all_eq16(simd_t a, simd_t b) {
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)) == -1;
+}
+
+static inline int simd_any_gt16(simd_t a, simd_t b) {
+	return _mm256_movemask_epi8(_mm256_cmpgt_epi16(a, b)) != 0;
+}
+
+static inline uint8_t simd_hmax_u8(simd_t v) {
+	__m128i m = _mm_max_epu8(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 8));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 4));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 2));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 1));
+	return (uint8_t)_mm_extract_epi16(m, 0);
+}
+
+static inline uint16_t simd_hmax_i16(simd_t v) {
+	__m128i m = _mm_max_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+	return (uint16_t)_mm_extract_epi16(m, 0);
+}
+
+#include "ssw_kernel.h"
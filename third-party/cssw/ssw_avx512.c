@@ -0,0 +1,108 @@
+/*
+ *  ssw_avx512.c
+ *
+ *  AVX-512BW striped kernels, 64 lanes of 8 bit or 32 lanes of 16 bit.
+ *  Has to be compiled with -mavx512bw, selected at runtime by ssw_init.
+ *
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+typedef __m512i simd_t;
+
+#define SSW_SUFFIX avx512bw
+#define SSW_KERNEL_NAME "avx512bw"
+#define SIMD_LANES8 64
+#define SIMD_LANES16 32
+
+#define simd_zero() _mm512_setzero_si512()
+#define simd_set1_8(x) _mm512_set1_epi8(x)
+#define simd_set1_16(x) _mm512_set1_epi16(x)
+#define simd_load(p) _mm512_load_si512((const void*)(p))
+#define simd_store(p, v) _mm512_store_si512((void*)(p), (v))
+#define simd_adds_epu8(a, b) _mm512_adds_epu8((a), (b))
+#define simd_subs_epu8(a, b) _mm512_subs_epu8((a), (b))
+#define simd_max_epu8(a, b) _mm512_max_epu8((a), (b))
+#define simd_adds_epi16(a, b) _mm512_adds_epi16((a), (b))
+#define simd_subs_epu16(a, b) _mm512_subs_epu16((a), (b))
+#define simd_max_epi16(a, b) _mm512_max_epi16((a), (b))
+
+/* 128 bit lanes of v moved up by one, lowest lane zeroed,
+   provides the bytes crossing the lane boundaries for alignr. */
+static inline simd_t simd_lanes_up(simd_t v) {
+	return _mm512_maskz_shuffle_i64x2(0xFC, v, v, _MM_SHUFFLE(2, 1, 0, 0));
+}
+
+static inline simd_t simd_shift8(simd_t v) {
+	return _mm512_alignr_epi8(v, simd_lanes_up(v), 15);
+}
+
+static inline simd_t simd_shift16(simd_t v) {
+	return _mm512_alignr_epi8(v, simd_lanes_up(v), 14);
+}
+
+/* 128 bit lanes of v moved up by two, lowest two lanes zeroed. */
+static inline simd_t simd_lanes_up2(simd_t v) {
+	return _mm512_maskz_shuffle_i64x2(0xF0, v, v, _MM_SHUFFLE(1, 0, 0, 0));
+}
+
+static inline simd_t simd_decay8(simd_t v, int c) {
+	return _mm512_subs_epu8(v, _mm512_set1_epi8((char)(c > 0xFF ? 0xFF : c)));
+}
+
+static inline simd_t simd_decay16(simd_t v, int c) {
+	return _mm512_subs_epu16(v, _mm512_set1_epi16((short)(c > 0xFFFF ? 0xFFFF : c)));
+}
+
+static inline simd_t simd_scan8(simd_t v, int c) {
+	v = _mm512_max_epu8(v, simd_decay8(_mm512_alignr_epi8(v, simd_lanes_up(v), 15), c));
+	v = _mm512_max_epu8(v, simd_decay8(_mm512_alignr_epi8(v, simd_lanes_up(v), 14), 2 * c));
+	v = _mm512_max_epu8(v, simd_decay8(_mm512_alignr_epi8(v, simd_lanes_up(v), 12), 4 * c));
+	v = _mm512_max_epu8(v, simd_decay8(_mm512_alignr_epi8(v, simd_lanes_up(v), 8), 8 * c));
+	v = _mm512_max_epu8(v, simd_decay8(simd_lanes_up(v), 16 * c));
+	v = _mm512_max_epu8(v, simd_decay8(simd_lanes_up2(v), 32 * c));
+	return v;
+}
+
+static inline simd_t simd_scan16(simd_t v, int c) {
+	v = _mm512_max_epi16(v, simd_decay16(_mm512_alignr_epi8(v, simd_lanes_up(v), 14), c));
+	v = _mm512_max_epi16(v, simd_decay16(_mm512_alignr_epi8(v, simd_lanes_up(v), 12), 2 * c));
+	v = _mm512_max_epi16(v, simd_decay16(_mm512_alignr_epi8(v, simd_lanes_up(v), 8), 4 * c));
+	v = _mm512_max_epi16(v, simd_decay16(simd_lanes_up(v), 8 * c));
+	v = _mm512_max_epi16(v, simd_decay16(simd_lanes_up2(v), 16 * c));
+	return v;
+}
+
+static inline int simd_all_eq8(simd_t a, simd_t b) {
+	return _mm512_cmpeq_epi8_mask(a, b) == 0xFFFFFFFFFFFFFFFFULL;
+}
+
+static inline int simd_all_eq16(simd_t a, simd_t b) {
+	return _mm512_cmpeq_epi16_mask(a, b) == 0xFFFFFFFFU;
+}
+
+static inline int simd_any_gt16(simd_t a, simd_t b) {
+	return _mm512_cmpgt_epi16_mask(a, b) != 0;
+}
+
+static inline uint8_t simd_hmax_u8(simd_t v) {
+	__m256i h = _mm256_max_epu8(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+	__m128i m = _mm_max_epu8(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 8));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 4));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 2));
+	m = _mm_max_epu8(m, _mm_srli_si128(m, 1));
+	return (uint8_t)_mm_extract_epi16(m, 0);
+}
+
+static inline uint16_t simd_hmax_i16(simd_t v) {
+	__m256i h = _mm256_max_epi16(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+	__m128i m = _mm_max_epi16(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+	return (uint16_t)_mm_extract_epi16(m, 0);
+}
+
+#include "ssw_kernel.h"
@@ -0,0 +1,52 @@
+/*
+ *  ssw_internal.h
+ *
+ *  Types shared between ssw.c and the width specific striped kernels.
+ *  Not part of the public interface.
+ *
+ */
+
+#ifndef SSW_INTERNAL_H
+#define SSW_INTERNAL_H
+
+#include <stdint.h>
+
+#ifdef __GNUC__
+#define LIKELY(x) __builtin_expect((x),1)
+#define UNLIKELY(x) __builtin_expect((x),0)
+#else
+#define LIKELY(x) (x)
+#define UNLIKELY(x) (x)
+#endif
+
+typedef struct {
+	uint16_t score;
+	int32_t ref;	 //0-based position
+	int32_t read;    //alignment ending position on read, 0-based
+} alignment_end;
+
+/*!	@typedef	striped kernels of one SIMD width
+	@field	qP_byte	query profile for the 8 bit kernel, released with free
+	@field	sw_byte	8 bit striped Smith-Waterman
+	@field	qP_word	query profile for the 16 bit kernel, released with free
+	@field	sw_word	16 bit striped Smith-Waterman
+	@field	name	instruction set of the kernel
+*/
+typedef struct {
+	void* (*qP_byte) (const int8_t* read_num, const int8_t* mat, const int32_t readLen, const int32_t n, uint8_t bias);
+	alignment_end* (*sw_byte) (const int8_t* ref, int8_t ref_dir, int32_t refLen, int32_t readLen, const uint8_t weight_gapO,
+							   const uint8_t weight_gapE, const void* vProfile, uint8_t terminate, uint8_t bias, int32_t maskLen);
+	void* (*qP_word) (const int8_t* read_num, const int8_t* mat, const int32_t readLen, const int32_t n);
+	alignment_end* (*sw_word) (const int8_t* ref, int8_t ref_dir, int32_t refLen, int32_t readLen, const uint8_t weight_gapO,
+							   const uint8_t weight_gapE, const void* vProfile, uint16_t terminate, int32_t maskLen);
+	const char* name;
+} ssw_kernel;
+
+#ifdef SSW_HAVE_AVX2
+extern const ssw_kernel ssw_kernel_avx2;
+#endif
+#ifdef SSW_HAVE_AVX512BW
+extern const ssw_kernel ssw_kernel_avx512bw;
+#endif
+
+#endif	// SSW_INTERNAL_H
@@ -0,0 +1,390 @@
+/*
+ *  ssw_kernel.h
+ *
+ *  Striped Smith-Waterman kernels of sw_sse2_byte and sw_sse2_word for
+ *  vectors wider than 128 bit. Included once per instruction set by a
+ *  translation unit that is compiled for it and defines:
+ *
+ *	SSW_SUFFIX, SSW_KERNEL_NAME, simd_t, SIMD_LANES8, SIMD_LANES16,
+ *	simd_zero, simd_set1_8, simd_set1_16, simd_load, simd_store,
+ *	simd_adds_epu8, simd_subs_epu8, simd_max_epu8,
+ *	simd_adds_epi16, simd_subs_epu16, simd_max_epi16,
+ *	simd_shift8 / simd_shift16 (shift left by one lane across the whole vector),
+ *	simd_scan8 / simd_scan16 (lane l becomes max over k of lane l-k minus k*c),
+ *	simd_all_eq8, simd_all_eq16, simd_any_gt16, simd_hmax_u8, simd_hmax_i16
+ *
+ *  Apart from the lazy F loop the control flow is identical to the SSE2
+ *  kernels in ssw.c. The SSE2 lazy F loop needs up to one pass over all
+ *  segments per lane, which eats the gain of wider vectors for long
+ *  alignments. The prefix scan computes the exact F; results are identical
+ *  to SSE2 for gap open penalties larger than the gap extension penalty.
+ *  With equal penalties the SSE2 16 bit lazy F loop may stop early.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ssw_internal.h"
+
+#define SSW_CONCAT_(a, b) a ## _ ## b
+#define SSW_CONCAT(a, b) SSW_CONCAT_(a, b)
+#define SSW_NAME(x) SSW_CONCAT(x, SSW_SUFFIX)
+
+/* Zero initialized memory aligned to the vector width, released with free. */
+static void* SSW_NAME(aligned_calloc) (size_t size) {
+	void* p = 0;
+	if (posix_memalign(&p, sizeof(simd_t), size > 0 ? size : sizeof(simd_t)) != 0) return 0;
+	memset(p, 0, size);
+	return p;
+}
+
+static void* SSW_NAME(qP_byte) (const int8_t* read_num,
+				  const int8_t* mat,
+				  const int32_t readLen,
+				  const int32_t n,
+				  uint8_t bias) {
+
+	int32_t segLen = (readLen + SIMD_LANES8 - 1) / SIMD_LANES8;
+	simd_t* vProfile = (simd_t*)SSW_NAME(aligned_calloc)(n * segLen * sizeof(simd_t));
+	int8_t* t = (int8_t*)vProfile;
+	int32_t nt, i, j, segNum;
+
+	for (nt = 0; LIKELY(nt < n); nt ++) {
+		for (i = 0; i < segLen; i ++) {
+			j = i;
+			for (segNum = 0; LIKELY(segNum < SIMD_LANES8) ; segNum ++) {
+				*t++ = j>= readLen ? bias : mat[nt * n + read_num[j]] + bias;
+				j += segLen;
+			}
+		}
+	}
+	return vProfile;
+}
+
+static alignment_end* SSW_NAME(sw_byte) (const int8_t* ref,
+							 int8_t ref_dir,
+							 int32_t refLen,
+							 int32_t readLen,
+							 const uint8_t weight_gapO,
+							 const uint8_t weight_gapE,
+							 const void* vProfileData,
+							 uint8_t terminate,
+							 uint8_t bias,
+							 int32_t maskLen) {
+
+	const simd_t* vProfile = (const simd_t*)vProfileData;
+	uint8_t max = 0;
+	int32_t end_read = readLen - 1;
+	int32_t end_ref = -1;
+	int32_t segLen = (readLen + SIMD_LANES8 - 1) / SIMD_LANES8;
+
+	uint8_t* maxColumn = (uint8_t*) calloc(refLen, 1);
+
+	simd_t vZero = simd_zero();
+
+	simd_t* pvHStore = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvHLoad = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvE = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvHmax = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+
+	int32_t i, j;
+	simd_t vGapO = simd_set1_8(weight_gapO);
+	simd_t vGapE = simd_set1_8(weight_gapE);
+	simd_t vBias = simd_set1_8(bias);
+
+	simd_t vMaxScore = vZero;
+	simd_t vMaxMark = vZero;
+	simd_t vTemp;
+	int32_t edge, begin = 0, end = refLen, step = 1;
+
+	if (ref_dir == 1) {
+		begin = refLen - 1;
+		end = -1;
+		step = -1;
+	}
+	for (i = begin; LIKELY(i != end); i += step) {
+		simd_t e, vF = vZero, vMaxColumn = vZero;
+
+		simd_t vH = pvHStore[segLen - 1];
+		vH = simd_shift8(vH);
+		const simd_t* vP = vProfile + ref[i] * segLen;
+
+		simd_t* pv = pvHLoad;
+		pvHLoad = pvHStore;
+		pvHStore = pv;
+
+		for (j = 0; LIKELY(j < segLen); ++j) {
+			vH = simd_adds_epu8(vH, simd_load(vP + j));
+			vH = simd_subs_epu8(vH, vBias);
+
+			e = simd_load(pvE + j);
+			vH = simd_max_epu8(vH, e);
+			vH = simd_max_epu8(vH, vF);
+			vMaxColumn = simd_max_epu8(vMaxColumn, vH);
+
+			simd_store(pvHStore + j, vH);
+
+			vH = simd_subs_epu8(vH, vGapO);
+			e = simd_subs_epu8(e, vGapE);
+			e = simd_max_epu8(e, vH);
+			simd_store(pvE + j, e);
+
+			vF = simd_subs_epu8(vF, vGapE);
+			vF = simd_max_epu8(vF, vH);
+
+			vH = simd_load(pvHLoad + j);
+		}
+
+		/* Lazy_F: the F leaving a lane enters the next one, decayed by one gap
+		   extension per segment. A prefix scan over the lanes replaces the lane
+		   by lane passes of the SSE2 kernel, a single pass applies it. Done as
+		   soon as F can not exceed what H - gapO already propagated. */
+		vF = simd_scan8(simd_shift8(vF), segLen * weight_gapE);
+		for (j = 0; LIKELY(j < segLen); ++j) {
+			vH = simd_load(pvHStore + j);
+			vTemp = simd_subs_epu8(vH, vGapO);
+			vH = simd_max_epu8(vH, vF);
+			vMaxColumn = simd_max_epu8(vMaxColumn, vH);
+			simd_store(pvHStore + j, vH);
+			vF = simd_subs_epu8(vF, vGapE);
+			if (simd_all_eq8(simd_subs_epu8(vF, vTemp), vZero)) break;
+		}
+
+		vMaxScore = simd_max_epu8(vMaxScore, vMaxColumn);
+		if (!simd_all_eq8(vMaxMark, vMaxScore)) {
+			uint8_t temp;
+			vMaxMark = vMaxScore;
+			temp = simd_hmax_u8(vMaxScore);
+
+			if (LIKELY(temp > max)) {
+				max = temp;
+				if (max + bias >= 255) break;	//overflow
+				end_ref = i;
+				for (j = 0; LIKELY(j < segLen); ++j) pvHmax[j] = pvHStore[j];
+			}
+		}
+
+		maxColumn[i] = simd_hmax_u8(vMaxColumn);
+		if (maxColumn[i] == terminate) break;
+	}
+
+	/* Trace the alignment ending position on read. */
+	uint8_t *t = (uint8_t*)pvHmax;
+	int32_t column_len = segLen * SIMD_LANES8;
+	for (i = 0; LIKELY(i < column_len); ++i, ++t) {
+		int32_t temp;
+		if (*t == max) {
+			temp = i / SIMD_LANES8 + i % SIMD_LANES8 * segLen;
+			if (temp < end_read) end_read = temp;
+		}
+	}
+
+	free(pvHmax);
+	free(pvE);
+	free(pvHLoad);
+	free(pvHStore);
+
+	alignment_end* bests = (alignment_end*) calloc(2, sizeof(alignment_end));
+	bests[0].score = max + bias >= 255 ? 255 : max;
+	bests[0].ref = end_ref;
+	bests[0].read = end_read;
+
+	bests[1].score = 0;
+	bests[1].ref = 0;
+	bests[1].read = 0;
+
+	edge = (end_ref - maskLen) > 0 ? (end_ref - maskLen) : 0;
+	for (i = 0; i < edge; i ++) {
+		if (maxColumn[i] > bests[1].score) {
+			bests[1].score = maxColumn[i];
+			bests[1].ref = i;
+		}
+	}
+	edge = (end_ref + maskLen) > refLen ? refLen : (end_ref + maskLen);
+	for (i = edge + 1; i < refLen; i ++) {
+		if (maxColumn[i] > bests[1].score) {
+			bests[1].score = maxColumn[i];
+			bests[1].ref = i;
+		}
+	}
+
+	free(maxColumn);
+	return bests;
+}
+
+static void* SSW_NAME(qP_word) (const int8_t* read_num,
+				  const int8_t* mat,
+				  const int32_t readLen,
+				  const int32_t n) {
+
+	int32_t segLen = (readLen + SIMD_LANES16 - 1) / SIMD_LANES16;
+	simd_t* vProfile = (simd_t*)SSW_NAME(aligned_calloc)(n * segLen * sizeof(simd_t));
+	int16_t* t = (int16_t*)vProfile;
+	int32_t nt, i, j;
+	int32_t segNum;
+
+	for (nt = 0; LIKELY(nt < n); nt ++) {
+		for (i = 0; i < segLen; i ++) {
+			j = i;
+			for (segNum = 0; LIKELY(segNum < SIMD_LANES16) ; segNum ++) {
+				*t++ = j>= readLen ? 0 : mat[nt * n + read_num[j]];
+				j += segLen;
+			}
+		}
+	}
+	return vProfile;
+}
+
+static alignment_end* SSW_NAME(sw_word) (const int8_t* ref,
+							 int8_t ref_dir,
+							 int32_t refLen,
+							 int32_t readLen,
+							 const uint8_t weight_gapO,
+							 const uint8_t weight_gapE,
+							 const void* vProfileData,
+							 uint16_t terminate,
+							 int32_t maskLen) {
+
+	const simd_t* vProfile = (const simd_t*)vProfileData;
+	uint16_t max = 0;
+	int32_t end_read = readLen - 1;
+	int32_t end_ref = 0;
+	int32_t segLen = (readLen + SIMD_LANES16 - 1) / SIMD_LANES16;
+
+	uint16_t* maxColumn = (uint16_t*) calloc(refLen, 2);
+
+	simd_t vZero = simd_zero();
+
+	simd_t* pvHStore = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvHLoad = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvE = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+	simd_t* pvHmax = (simd_t*) SSW_NAME(aligned_calloc)(segLen * sizeof(simd_t));
+
+	int32_t i, j;
+	simd_t vGapO = simd_set1_16(weight_gapO);
+	simd_t vGapE = simd_set1_16(weight_gapE);
+
+	simd_t vMaxScore = vZero;
+	simd_t vMaxMark = vZero;
+	simd_t vTemp;
+	int32_t edge, begin = 0, end = refLen, step = 1;
+
+	if (ref_dir == 1) {
+		begin = refLen - 1;
+		end = -1;
+		step = -1;
+	}
+	for (i = begin; LIKELY(i != end); i += step) {
+		simd_t e, vF = vZero;
+		simd_t vH = pvHStore[segLen - 1];
+		vH = simd_shift16(vH);
+
+		simd_t* pv = pvHLoad;
+
+		simd_t vMaxColumn = vZero;
+
+		const simd_t* vP = vProfile + ref[i] * segLen;
+		pvHLoad = pvHStore;
+		pvHStore = pv;
+
+		for (j = 0; LIKELY(j < segLen); j ++) {
+			vH = simd_adds_epi16(vH, simd_load(vP + j));
+
+			e = simd_load(pvE + j);
+			vH = simd_max_epi16(vH, e);
+			vH = simd_max_epi16(vH, vF);
+			vMaxColumn = simd_max_epi16(vMaxColumn, vH);
+
+			simd_store(pvHStore + j, vH);
+
+			vH = simd_subs_epu16(vH, vGapO);
+			e = simd_subs_epu16(e, vGapE);
+			e = simd_max_epi16(e, vH);
+			simd_store(pvE + j, e);
+
+			vF = simd_subs_epu16(vF, vGapE);
+			vF = simd_max_epi16(vF, vH);
+
+			vH = simd_load(pvHLoad + j);
+		}
+
+		/* Lazy_F, see the 8 bit kernel */
+		vF = simd_scan16(simd_shift16(vF), segLen * weight_gapE);
+		for (j = 0; LIKELY(j < segLen); ++j) {
+			vH = simd_load(pvHStore + j);
+			vTemp = simd_subs_epu16(vH, vGapO);
+			vH = simd_max_epi16(vH, vF);
+			vMaxColumn = simd_max_epi16(vMaxColumn, vH);
+			simd_store(pvHStore + j, vH);
+			vF = simd_subs_epu16(vF, vGapE);
+			if (UNLIKELY(! simd_any_gt16(vF, vTemp))) break;
+		}
+
+		vMaxScore = simd_max_epi16(vMaxScore, vMaxColumn);
+		if (!simd_all_eq16(vMaxMark, vMaxScore)) {
+			uint16_t temp;
+			vMaxMark = vMaxScore;
+			temp = simd_hmax_i16(vMaxScore);
+
+			if (LIKELY(temp > max)) {
+				max = temp;
+				end_ref = i;
+				for (j = 0; LIKELY(j < segLen); ++j) pvHmax[j] = pvHStore[j];
+			}
+		}
+
+		maxColumn[i] = simd_hmax_i16(vMaxColumn);
+		if (maxColumn[i] == terminate) break;
+	}
+
+	/* Trace the alignment ending position on read. */
+	uint16_t *t = (uint16_t*)pvHmax;
+	int32_t column_len = segLen * SIMD_LANES16;
+	for (i = 0; LIKELY(i < column_len); ++i, ++t) {
+		int32_t temp;
+		if (*t == max) {
+			temp = i / SIMD_LANES16 + i % SIMD_LANES16 * segLen;
+			if (temp < end_read) end_read = temp;
+		}
+	}
+
+	free(pvHmax);
+	free(pvE);
+	free(pvHLoad);
+	free(pvHStore);
+
+	alignment_end* bests = (alignment_end*) calloc(2, sizeof(alignment_end));
+	bests[0].score = max;
+	bests[0].ref = end_ref;
+	bests[0].read = end_read;
+
+	bests[1].score = 0;
+	bests[1].ref = 0;
+	bests[1].read = 0;
+
+	edge = (end_ref - maskLen) > 0 ? (end_ref - maskLen) : 0;
+	for (i = 0; i < edge; i ++) {
+		if (maxColumn[i] > bests[1].score) {
+			bests[1].score = maxColumn[i];
+			bests[1].ref = i;
+		}
+	}
+	edge = (end_ref + maskLen) > refLen ? refLen : (end_ref + maskLen);
+	for (i = edge; i < refLen; i ++) {
+		if (maxColumn[i] > bests[1].score) {
+			bests[1].score = maxColumn[i];
+			bests[1].ref = i;
+		}
+	}
+
+	free(maxColumn);
+	return bests;
+}
+
+const ssw_kernel SSW_NAME(ssw_kernel) = {
+	SSW_NAME(qP_byte),
+	SSW_NAME(sw_byte),
+	SSW_NAME(qP_word),
+	SSW_NAME(sw_word),
+	SSW_KERNEL_NAME
+};